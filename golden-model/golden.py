@@ -8,6 +8,7 @@
 import numpy as np
 import torch
 import argparse
+import os
 
 parser = argparse.ArgumentParser()
 
@@ -17,12 +18,23 @@ parser.add_argument("--range"       ,   type = int,     default = 128
 parser.add_argument("--monotonic"   ,   type = int,     default = 0             )
 parser.add_argument("--step"        ,   type = int,     default = 1             )
 parser.add_argument("--vectors"     ,   type = int,     default = 1             )
+parser.add_argument("--scale"       ,   type = float,   default = 1             )
+parser.add_argument("--valid_len"   ,   type = int,     default = -1            )
+parser.add_argument("--causal"      ,   type = int,     default = 0             )
+parser.add_argument("--in_fmt"      ,   type = str,     default = "NATIVE"      )
+parser.add_argument("--out_fmt"     ,   type = str,     default = "NATIVE"      )
 parser.add_argument("--fixed_point" ,   type = int,     default = 0             )
 parser.add_argument("--fx_len"      ,   type = int,     default = 8             )
 parser.add_argument("--i_int_bits"  ,   type = int,     default = 4             )
 parser.add_argument("--i_is_signed" ,   type = int,     default = 0             )
 parser.add_argument("--o_int_bits"  ,   type = int,     default = -4            )
 parser.add_argument("--o_is_signed" ,   type = int,     default = 0             )
+parser.add_argument("--exp_correction", type = int,   default = 1             )
+parser.add_argument("--exp_rounding",   type = int,     default = 1             )
+parser.add_argument("--newton_iters",   type = int,     default = 2             )
+parser.add_argument("--out_mode"    ,   type = str,     default = "SOFTMAX"     )
+parser.add_argument("--binary"      ,   type = int,     default = 0             )
+parser.add_argument("--outdir"      ,   type = str,     default = "."           )
 
 args = parser.parse_args()
 
@@ -32,12 +44,27 @@ range       = args.range
 monotonic   = args.monotonic
 step        = args.step
 vectors     = args.vectors
+scale       = args.scale
+valid_len   = args.valid_len
+causal      = args.causal
+in_fmt      = args.in_fmt
+out_fmt     = args.out_fmt
 fixed_point = args.fixed_point
 fx_len      = args.fx_len
 i_int_bits  = args.i_int_bits
 i_is_signed = args.i_is_signed
 o_int_bits  = args.o_int_bits
 o_is_signed = args.o_is_signed
+exp_correction  = args.exp_correction
+exp_rounding    = args.exp_rounding
+newton_iters    = args.newton_iters
+out_mode        = args.out_mode
+binary      = args.binary
+outdir      = args.outdir
+
+# The activations follow the lookup table of the hardware, only the bit-accurate model has it
+if out_mode not in ("SOFTMAX", "LOG"):
+    raise SystemExit(f"Output mode {out_mode} is only supported by golden-cpp")
 
 if fixed_point == 0:
     match fpformat:
@@ -64,6 +91,27 @@ else:
 
     step    = step * 2**(width - i_int_bits - i_is_signed)
 
+# I/O formats selectable through CAST_CTRL, in the order of their encoding. NATIVE is the datapath format
+io_fmts = {
+    "NATIVE"    : (0, dtype if fixed_point == 0 else None,  width),
+    "FP16"      : (1, torch.float16,                        2),
+    "FP8_E4M3"  : (2, torch.float8_e4m3fn,                  1),
+    "FP8_E5M2"  : (3, torch.float8_e5m2,                    1),
+}
+
+in_code,  in_dtype,  in_width  = io_fmts[in_fmt]
+out_code, out_dtype, out_width = io_fmts[out_fmt]
+
+width = in_width
+
+def to_bits(t, fmt):
+    if fmt == "NATIVE":
+        return (np.frombuffer(t.float().numpy(), np.uint32) >> 16).astype(inttype)
+    elif io_fmts[fmt][2] == 1:
+        return t.view(torch.uint8).numpy().astype(inttype)
+    else:
+        return t.view(torch.int16).numpy().astype(np.uint16).astype(inttype)
+
 final_scores_np     = np.empty(0, dtype = inttype)
 final_baseline_np   = np.empty(0, dtype = inttype)
 denominators        = []
@@ -75,21 +123,31 @@ if fpformat == "BFLOAT16":
 for i in np.arange(0, vectors):
     if fixed_point == 0:
         if monotonic == 0:
-            scores = torch.empty(length, dtype = dtype).uniform_(0, range)
+            scores = torch.empty(length, dtype = torch.float32).uniform_(0, range).to(in_dtype)
         else:
-            scores = torch.arange(0, length * step, step, dtype = dtype)
+            scores = torch.arange(0, length * step, step, dtype = torch.float32).to(in_dtype)
+
+        # The hardware converts the scores to bf16, scales them and replaces the masked ones with -inf
+        scores_64 = (scores.float().to(dtype).float() * torch.tensor(scale, dtype = dtype).float()).to(dtype).double()
 
-        scores_64 = scores.double()
+        if valid_len >= 0:
+            scores_64[valid_len + causal * i:] = float("-inf")
 
         denominator = (scores_64 - scores_64.max()).exp().sum()
 
         denominators.append(denominator.item())
 
-        baseline = (scores_64 - scores_64.max()).exp() /denominator
+        if out_mode == "LOG":
+            baseline = scores_64 - scores_64.max() - denominator.log()
+        elif scores_64.max() == float("-inf"):
+            # Every element is masked, the hardware writes zeros instead of NaN
+            baseline = torch.zeros_like(scores_64)
+        else:
+            baseline = (scores_64 - scores_64.max()).exp() /denominator
 
         if fpformat == "BFLOAT16":
-            scores_np   = (np.frombuffer(scores.float().numpy(), np.uint32) >> 16).astype(inttype)
-            baseline_np = (np.frombuffer(baseline.to(dtype).float().numpy(), np.uint32) >> 16).astype(inttype)
+            scores_np   = to_bits(scores, in_fmt)
+            baseline_np = to_bits(baseline.to(dtype) if out_fmt == "NATIVE" else baseline.to(dtype).float().to(out_dtype), out_fmt)
         else:
             scores_np   = np.frombuffer(scores.numpy(), inttype)
             baseline_np = np.frombuffer(baseline.to(dtype).numpy(), inttype)
@@ -119,9 +177,37 @@ for i in np.arange(0, vectors):
         final_scores_np    = np.append(final_scores_np, scores_np)
         final_baseline_np  = np.append(final_baseline_np, baseline_np)
 
+# Binary images, loaded by the testbench at the address in their header. The scores are placed in the part of the
+# data memory that is neither dataram nor stack, followed by 4 KiB left free for the slot caches of the tests and by
+# the outputs. Both are sized by the data, so the firmware and the stimuli no longer grow with the test
+STIM_BASE   = 0x1c080000
+STIM_END    = 0x1c100000
+CACHE_SPACE = 0x1000
+
+in_bytes    = in_width
+out_bytes   = out_width
+
+scores_addr = STIM_BASE
+out_addr    = STIM_BASE + (len(final_scores_np) * in_bytes + 63) // 64 * 64 + CACHE_SPACE
 
+# Header of two 32-bit words, load address and payload size in bytes, then the payload as 32-bit memory words.
+# Every word is stored most significant byte first, as $fread fills the memory, so the file can be mapped as is
+def write_image(path, addr, values, elem_bytes):
+    payload = values.astype(f"<u{elem_bytes}").tobytes()
+    padded  = payload + bytes(-len(payload) % 4)
 
-with open("sw/golden-model/scores.h", "w") as file:
+    with open(path, "wb") as f:
+        np.array([addr, len(payload)], dtype = ">u4").tofile(f)
+        np.frombuffer(padded, dtype = "<u4").astype(">u4").tofile(f)
+
+if binary:
+    if out_addr + len(final_baseline_np) * out_bytes > STIM_END:
+        raise SystemExit(f"The test needs {out_addr + len(final_baseline_np) * out_bytes - STIM_BASE} bytes, only {STIM_END - STIM_BASE} are available")
+
+    write_image(os.path.join(outdir, "golden-model/stim.bin"), scores_addr, final_scores_np, in_bytes)
+    write_image(os.path.join(outdir, "golden-model/golden.bin"), out_addr, final_baseline_np, out_bytes)
+
+with open(os.path.join(outdir, "sw/golden-model/scores.h"), "w") as file:
     file.write("#ifndef __SOFTEX_SCORES__\n")
     file.write("#define __SOFTEX_SCORES__\n\n")
 
@@ -131,38 +217,69 @@ with open("sw/golden-model/scores.h", "w") as file:
 
     file.write(f"#define N_VECTORS  {vectors}\n\n")
 
+    # ACCURACY_CTRL, see archi_softex.h. The float64 reference above does not depend on it: run the coarse
+    # settings against golden-cpp
+    accuracy = (0 if exp_correction else 1) | (0 if exp_rounding else 2) | (((2 - newton_iters) & 0x3) << 4)
+    file.write(f"#define ACCURACY  0x{accuracy:02x}\n\n")
+
+    # OUT_MODE of OUT_CTRL, see archi_softex.h
+    if out_mode == "LOG":
+        file.write("#define OUT_MODE  1\n\n")
+
+    if scale != 1 or valid_len >= 0:
+        scale_bits = (np.frombuffer(torch.tensor([scale], dtype = torch.bfloat16).float().numpy(), np.uint32) >> 16)[0]
+
+        file.write(f"#define SCALE  0x{scale_bits:04x}\n\n")
+        file.write(f"#define VALID_LEN  {valid_len}\n\n")
+        file.write(f"#define CAUSAL  {causal}\n\n")
+
+    if in_fmt != "NATIVE" or out_fmt != "NATIVE":
+        file.write(f"#define IN_FMT  {in_code}\n\n")
+        file.write(f"#define OUT_FMT  {out_code}\n\n")
+
     if fixed_point:
         file.write(f"#define INPUT_INT_BITS  {i_int_bits}\n\n")
         file.write(f"#define INPUT_SIGNED  {i_is_signed}\n\n")
         file.write(f"#define OUTPUT_INT_BITS  {o_int_bits}\n\n")
         file.write(f"#define OUTPUT_SIGNED  {o_is_signed}\n\n")
     
-    file.write("#define SCORES {    \\\n")
+    # The tests declare their inputs with STIM_ARRAY and write their outputs from OUT_ADDR
+    if binary:
+        file.write(f"#define SCORES_ADDR  0x{scores_addr:08x}\n\n")
+        file.write(f"#define OUT_ADDR  0x{out_addr:08x}\n\n")
+        file.write("#define STIM_ARRAY(type, name)  static type * const name = (type *) SCORES_ADDR\n\n")
+    else:
+        file.write("#define OUT_ADDR  0x1c010000\n\n")
+        file.write("#define STIM_ARRAY(type, name)  static type name[] = SCORES\n\n")
 
-    for i in final_scores_np:
-        file.write(f"   0x{i:04x},    \\\n")
+        file.write("#define SCORES {    \\\n")
 
-    file.write("}\n\n")
+        for i in final_scores_np:
+            file.write(f"   0x{i:04x},    \\\n")
+
+        file.write("}\n\n")
 
     file.write("#endif")
 
-with open("sw/golden-model/golden.h", "w") as file:
+with open(os.path.join(outdir, "sw/golden-model/golden.h"), "w") as file:
     file.write("#ifndef __SOFTEX_GOLDEN__\n")
     file.write("#define __SOFTEX_GOLDEN__\n\n")
     
-    file.write("#define GOLDEN {    \\\n")
+    if not binary:
+        file.write("#define GOLDEN {    \\\n")
 
-    for i in final_baseline_np:
-        file.write(f"   0x{i:04x},    \\\n")
+        for i in final_baseline_np:
+            file.write(f"   0x{i:04x},    \\\n")
 
-    file.write("}\n\n")
+        file.write("}\n\n")
 
     file.write("#endif")
 
-with open("golden-model/golden_sum.txt", "w") as file:
+with open(os.path.join(outdir, "golden-model/golden_sum.txt"), "w") as file:
     for i in denominators:
         file.write(f"{i}\n")
 
-with open("golden-model/golden.txt", "w") as file:
-    for i in final_baseline_np:
-        file.write(f"{i}\n")
+if not binary:
+    with open(os.path.join(outdir, "golden-model/golden.txt"), "w") as file:
+        for i in final_baseline_np:
+            file.write(f"{i}\n")
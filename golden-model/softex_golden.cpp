@@ -0,0 +1,375 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Golden generator based on softex_model.hpp. It accepts the same knobs as
+// golden.py and writes the same files, but the expected results are the ones
+// produced by the hardware rather than the float64 reference.
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "softex_model.hpp"
+
+struct options {
+    std::string fpformat    = "BFLOAT16";
+    unsigned    bandwidth   = 128;
+    unsigned    acc_regs    = softex::DEFAULT_ACC_REGS;
+    int         exp_correction  = 1;
+    int         exp_rounding    = 1;
+    unsigned    newton_iters    = softex::DEFAULT_NEWTON_ITERS;
+    int         log_output      = 0;
+    int         lse_output      = 0;
+    unsigned    act             = 0;
+    size_t      length      = 1024;
+    double      range       = 128;
+    int         monotonic   = 0;
+    double      step        = 1;
+    size_t      vectors     = 1;
+    double      scale       = 1;
+    long        valid_len   = -1;
+    int         causal      = 0;
+    softex::io_fmt  in_fmt  = softex::io_fmt::native;
+    softex::io_fmt  out_fmt = softex::io_fmt::native;
+    unsigned    threads     = 0;
+    uint64_t    seed        = 0;
+    int         binary      = 0;
+    std::string outdir      = ".";
+};
+
+static void usage (const char *name) {
+    std::fprintf(stderr,
+        "Usage: %s [--fpformat BFLOAT16] [--bandwidth 128] [--acc_regs 4] [--length 1024] [--range 128]\n"
+        "          [--monotonic 0] [--step 1] [--vectors 1] [--scale 1] [--valid_len -1] [--causal 0]\n"
+        "          [--in_fmt NATIVE] [--out_fmt NATIVE] [--exp_correction 1] [--exp_rounding 1] [--newton_iters 2]\n"
+        "          [--out_mode SOFTMAX] [--threads 0] [--seed 0] [--binary 0] [--outdir .]\n"
+        "The output modes are SOFTMAX, LOG, LSE and the activations EXP, SIGMOID, SILU and GELU, whose random scores are\n"
+        "centred on zero. LSE writes the outputs of LOG and the row statistics a complete LSE job writes, as LSE_GOLDEN\n", name);
+}
+
+// NATIVE, FP16, FP8_E4M3 or FP8_E5M2, in the order of the CAST_CTRL encoding
+static bool parse_fmt (const char *val, softex::io_fmt &fmt) {
+    static const char *names[] = {"NATIVE", "FP16", "FP8_E4M3", "FP8_E5M2"};
+
+    for (int i = 0; i < 4; i++) {
+        if (std::strcmp(val, names[i]) == 0) {
+            fmt = softex::io_fmt(i);
+            return true;
+        }
+    }
+
+    std::fprintf(stderr, "Unsupported I/O format %s\n", val);
+    return false;
+}
+
+static bool parse_args (int argc, char **argv, options &opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return false;
+        }
+
+        const char *val = argv[++i];
+
+        if      (arg == "--fpformat")   opt.fpformat    = val;
+        else if (arg == "--bandwidth")  opt.bandwidth   = std::strtoul(val, nullptr, 0);
+        else if (arg == "--acc_regs")   opt.acc_regs    = std::strtoul(val, nullptr, 0);
+        else if (arg == "--length")     opt.length      = std::strtoull(val, nullptr, 0);
+        else if (arg == "--range")      opt.range       = std::strtod(val, nullptr);
+        else if (arg == "--monotonic")  opt.monotonic   = std::atoi(val);
+        else if (arg == "--step")       opt.step        = std::strtod(val, nullptr);
+        else if (arg == "--vectors")    opt.vectors     = std::strtoull(val, nullptr, 0);
+        else if (arg == "--scale")      opt.scale       = std::strtod(val, nullptr);
+        else if (arg == "--valid_len")  opt.valid_len   = std::strtol(val, nullptr, 0);
+        else if (arg == "--causal")     opt.causal      = std::atoi(val);
+        else if (arg == "--in_fmt")     { if (!parse_fmt(val, opt.in_fmt))  return false; }
+        else if (arg == "--out_fmt")    { if (!parse_fmt(val, opt.out_fmt)) return false; }
+        else if (arg == "--exp_correction") opt.exp_correction  = std::atoi(val);
+        else if (arg == "--exp_rounding")   opt.exp_rounding    = std::atoi(val);
+        else if (arg == "--newton_iters")   opt.newton_iters    = std::strtoul(val, nullptr, 0);
+        else if (arg == "--out_mode") {
+            // The log-sum-exp has no elementwise output, its tests check the statistics records on the core
+            if      (std::strcmp(val, "SOFTMAX") == 0)  opt.log_output = 0;
+            else if (std::strcmp(val, "LOG") == 0)      opt.log_output = 1;
+            else if (std::strcmp(val, "LSE") == 0)      opt.log_output = opt.lse_output = 1;
+            else if (std::strcmp(val, "EXP") == 0)      opt.act = 1;
+            else if (std::strcmp(val, "SIGMOID") == 0)  opt.act = 2;
+            else if (std::strcmp(val, "SILU") == 0)     opt.act = 3;
+            else if (std::strcmp(val, "GELU") == 0)     opt.act = 4;
+            else {
+                std::fprintf(stderr, "Unsupported output mode %s\n", val);
+                return false;
+            }
+        }
+        else if (arg == "--threads")    opt.threads     = std::strtoul(val, nullptr, 0);
+        else if (arg == "--seed")       opt.seed        = std::strtoull(val, nullptr, 0);
+        else if (arg == "--binary")     opt.binary      = std::atoi(val);
+        else if (arg == "--outdir")     opt.outdir      = val;
+        else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (opt.fpformat != "BFLOAT16") {
+        std::fprintf(stderr, "Unsupported format %s\n", opt.fpformat.c_str());
+        return false;
+    }
+
+    if (opt.bandwidth % 16 != 0 || opt.bandwidth == 0 || opt.bandwidth / 16 > 64) {
+        std::fprintf(stderr, "Unsupported bandwidth %u\n", opt.bandwidth);
+        return false;
+    }
+
+    // The activations are never masked, only the exponential takes the pre-scale
+    if (opt.act != 0 && (opt.valid_len >= 0 || (opt.act != 1 && opt.scale != 1))) {
+        std::fprintf(stderr, "The activations support neither a mask nor, apart from EXP, a scale\n");
+        return false;
+    }
+
+    if (opt.newton_iters > softex::DEFAULT_NEWTON_ITERS) {
+        std::fprintf(stderr, "At most %u Newton-Raphson iterations are supported\n", softex::DEFAULT_NEWTON_ITERS);
+        return false;
+    }
+
+    return true;
+}
+
+static FILE *open_or_die (const std::string &path, const char *mode = "w") {
+    FILE *f = std::fopen(path.c_str(), mode);
+
+    if (f == nullptr) {
+        std::perror(path.c_str());
+        std::exit(1);
+    }
+
+    return f;
+}
+
+static void write_array (FILE *f, const char *name, const std::vector<uint16_t> &v) {
+    std::fprintf(f, "#define %s {    \\\n", name);
+
+    for (uint16_t x : v)
+        std::fprintf(f, "   0x%04x,    \\\n", x);
+
+    std::fprintf(f, "}\n\n");
+}
+
+// Binary images, see golden.py. The scores are placed at STIM_BASE, followed by CACHE_SPACE bytes left free for the
+// slot caches of the tests and by the outputs
+constexpr uint32_t STIM_BASE    = 0x1c080000;
+constexpr uint32_t STIM_END     = 0x1c100000;
+constexpr uint32_t CACHE_SPACE  = 0x1000;
+
+// Load address and payload size in bytes, then the payload as 32-bit memory words, most significant byte first
+static void write_image (const std::string &path, uint32_t addr, const std::vector<uint16_t> &v, unsigned elem_bytes) {
+    std::vector<uint8_t> bytes;
+
+    for (uint16_t x : v)
+        for (unsigned b = 0; b < elem_bytes; b++)
+            bytes.push_back(uint8_t(x >> (8 * b)));
+
+    uint32_t size = uint32_t(bytes.size());
+
+    bytes.resize((bytes.size() + 3) / 4 * 4, 0);
+
+    FILE *f = open_or_die(path, "wb");
+
+    auto put_word = [f] (uint32_t w) {
+        uint8_t be[4] = {uint8_t(w >> 24), uint8_t(w >> 16), uint8_t(w >> 8), uint8_t(w)};
+        std::fwrite(be, 1, 4, f);
+    };
+
+    put_word(addr);
+    put_word(size);
+
+    for (size_t i = 0; i < bytes.size(); i += 4)
+        put_word(uint32_t(bytes[i]) | uint32_t(bytes[i + 1]) << 8 | uint32_t(bytes[i + 2]) << 16 | uint32_t(bytes[i + 3]) << 24);
+
+    std::fclose(f);
+}
+
+int main (int argc, char **argv) {
+    options opt;
+
+    if (!parse_args(argc, argv, opt)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    softex::params p;
+    p.lanes     = opt.bandwidth / 16;
+    p.acc_regs  = opt.acc_regs;
+
+    p.newton_iters      = opt.newton_iters;
+    p.exp_correction    = opt.exp_correction != 0;
+    p.exp_rounding      = opt.exp_rounding != 0;
+    p.log_output        = opt.log_output != 0;
+
+    const size_t total = opt.length * opt.vectors;
+
+    std::vector<uint16_t>   scores      (total);
+    std::vector<uint16_t>   golden      (total);
+    std::vector<float>      denominators(opt.vectors);
+
+    std::mt19937_64 rng(opt.seed);
+    std::uniform_real_distribution<float> dist(opt.act ? -float(opt.range) / 2 : 0.0f, opt.act ? float(opt.range) / 2 : float(opt.range));
+
+    for (size_t v = 0; v < opt.vectors; v++) {
+        for (size_t i = 0; i < opt.length; i++) {
+            float x = opt.monotonic ? float(double(i) * opt.step) : dist(rng);
+            scores[v * opt.length + i] = softex::f32_to_io(x, opt.in_fmt);
+        }
+    }
+
+    // The hardware converts the scores to bf16, scales them and replaces the masked ones with -inf before the datapath
+    const uint16_t          scale_bf16  = softex::f32_to_bf16(float(opt.scale));
+    const bool              transform   = opt.scale != 1 || opt.valid_len >= 0;
+    const bool              convert     = opt.in_fmt != softex::io_fmt::native || opt.out_fmt != softex::io_fmt::native;
+    std::vector<uint16_t>   inputs;
+
+    if (transform || convert) {
+        inputs.resize(total);
+
+        for (size_t v = 0; v < opt.vectors; v++) {
+            size_t valid = opt.valid_len < 0 ? opt.length : size_t(opt.valid_len) + (opt.causal ? v : 0);
+
+            for (size_t i = 0; i < opt.length; i++) {
+                uint16_t x = softex::io_to_bf16(scores[v * opt.length + i], opt.in_fmt);
+                inputs[v * opt.length + i] = i >= valid ? softex::BF16_NEG_INF : (transform ? softex::bf16_mul(x, scale_bf16) : x);
+            }
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (opt.act)
+        softex::activation(p, softex::act_mode(opt.act), transform || convert ? inputs.data() : scores.data(), total, golden.data(), opt.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : opt.threads);
+    else
+        softex::softmax_batch(p, transform || convert ? inputs.data() : scores.data(), opt.length, opt.vectors, golden.data(), denominators.data(), opt.threads);
+
+    for (uint16_t &y : golden)
+        y = softex::bf16_to_io(y, opt.out_fmt);
+
+    // The maximum and max + ln(denominator) of every row, as a complete SOFTEX_OUT_LSE job writes them
+    std::vector<softex::row_state> stats (opt.lse_output ? opt.vectors : 0);
+
+    for (size_t v = 0; v < stats.size(); v++)
+        softex::accumulate(p, (transform || convert ? inputs.data() : scores.data()) + v * opt.length, opt.length, stats[v]);
+
+    auto stop = std::chrono::steady_clock::now();
+
+    std::fprintf(stderr, "Computed %zu elements in %.3f ms\n", total, std::chrono::duration<double, std::milli>(stop - start).count());
+
+    const unsigned  in_bytes    = softex::io_fmt_bytes(opt.in_fmt);
+    const unsigned  out_bytes   = softex::io_fmt_bytes(opt.out_fmt);
+    const uint32_t  scores_addr = STIM_BASE;
+    const uint32_t  out_addr    = STIM_BASE + uint32_t((total * in_bytes + 63) / 64 * 64) + CACHE_SPACE;
+
+    if (opt.binary) {
+        if (out_addr + total * out_bytes > STIM_END) {
+            std::fprintf(stderr, "The test needs %zu bytes, only %u are available\n", out_addr + total * out_bytes - STIM_BASE, STIM_END - STIM_BASE);
+            return 1;
+        }
+
+        write_image(opt.outdir + "/golden-model/stim.bin", scores_addr, scores, in_bytes);
+        write_image(opt.outdir + "/golden-model/golden.bin", out_addr, golden, out_bytes);
+    }
+
+    FILE *f = open_or_die(opt.outdir + "/sw/golden-model/scores.h");
+
+    std::fprintf(f, "#ifndef __SOFTEX_SCORES__\n");
+    std::fprintf(f, "#define __SOFTEX_SCORES__\n\n");
+    std::fprintf(f, "#define LENGTH  %zu\n\n", opt.length);
+    std::fprintf(f, "#define FMT_WIDTH  %u\n\n", softex::io_fmt_bytes(opt.in_fmt));
+    std::fprintf(f, "#define N_VECTORS  %zu\n\n", opt.vectors);
+
+    if (transform) {
+        std::fprintf(f, "#define SCALE  0x%04x\n\n", scale_bf16);
+        std::fprintf(f, "#define VALID_LEN  %ld\n\n", opt.valid_len);
+        std::fprintf(f, "#define CAUSAL  %d\n\n", opt.causal);
+    }
+
+    // ACCURACY_CTRL, see archi_softex.h
+    std::fprintf(f, "#define ACCURACY  0x%02x\n\n", (opt.exp_correction ? 0 : 1) | (opt.exp_rounding ? 0 : 2) | ((softex::DEFAULT_NEWTON_ITERS - opt.newton_iters) & 0x3) << 4);
+
+    // OUT_MODE of OUT_CTRL, see archi_softex.h
+    if (opt.log_output)
+        std::fprintf(f, "#define OUT_MODE  %d\n\n", opt.lse_output ? 2 : 1);
+
+    // OUT_ACT of OUT_CTRL, see archi_softex.h
+    if (opt.act)
+        std::fprintf(f, "#define OUT_ACT  %u\n\n", opt.act);
+
+    if (convert) {
+        std::fprintf(f, "#define IN_FMT  %d\n\n", int(opt.in_fmt));
+        std::fprintf(f, "#define OUT_FMT  %d\n\n", int(opt.out_fmt));
+    }
+
+    // The tests declare their inputs with STIM_ARRAY and write their outputs from OUT_ADDR
+    if (opt.binary) {
+        std::fprintf(f, "#define SCORES_ADDR  0x%08x\n\n", scores_addr);
+        std::fprintf(f, "#define OUT_ADDR  0x%08x\n\n", out_addr);
+        std::fprintf(f, "#define STIM_ARRAY(type, name)  static type * const name = (type *) SCORES_ADDR\n\n");
+    } else {
+        std::fprintf(f, "#define OUT_ADDR  0x1c010000\n\n");
+        std::fprintf(f, "#define STIM_ARRAY(type, name)  static type name[] = SCORES\n\n");
+        write_array(f, "SCORES", scores);
+    }
+
+    std::fprintf(f, "#endif");
+    std::fclose(f);
+
+    f = open_or_die(opt.outdir + "/sw/golden-model/golden.h");
+
+    std::fprintf(f, "#ifndef __SOFTEX_GOLDEN__\n");
+    std::fprintf(f, "#define __SOFTEX_GOLDEN__\n\n");
+
+    if (!opt.binary)
+        write_array(f, "GOLDEN", golden);
+
+    // softex_stats_t initialisers, the LSE as the bits of its fp32 value
+    if (opt.lse_output) {
+        std::fprintf(f, "#define LSE_GOLDEN {    \\\n");
+
+        for (const softex::row_state &st : stats)
+            std::fprintf(f, "   {0x%04x, 0x%08x},    \\\n", st.max, softex::f32_bits(softex::log_sum_exp(st.denominator, st.max)));
+
+        std::fprintf(f, "}\n\n");
+    }
+
+    std::fprintf(f, "#endif");
+    std::fclose(f);
+
+    f = open_or_die(opt.outdir + "/golden-model/golden_sum.txt");
+
+    for (float d : denominators) {
+        char buf[32];
+        *std::to_chars(buf, buf + sizeof(buf) - 1, d).ptr = '\0';
+        std::fprintf(f, "%s\n", buf);
+    }
+
+    std::fclose(f);
+
+    if (!opt.binary) {
+        f = open_or_die(opt.outdir + "/golden-model/golden.txt");
+
+        for (uint16_t x : golden)
+            std::fprintf(f, "%u\n", x);
+
+        std::fclose(f);
+    }
+
+    return 0;
+}
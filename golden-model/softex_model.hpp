@@ -0,0 +1,952 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Bit-accurate model of the SoftEx datapath (BF16 inputs, FP32 accumulation).
+//
+// The model follows the RTL rather than the math:
+//  - expu_schraudolph + expu_correction, implemented on the raw bits;
+//  - the online maximum of softex_fp_glob_minmax, with the rescaling factor
+//    computed by i_new_old_max_diff + i_scal_exp;
+//  - the fp32 adder tree of softex_fp_red_sum;
+//  - the tagged partial accumulations of softex_acc_datapath, with ACC_REGS
+//    partial sums cycling through the accumulator FMA and the final pairwise
+//    reduction;
+//  - softex_acc_den_inverter followed by the Newton-Raphson iterations;
+//  - the bf16 normalisation in i_addmul_time_mux.
+//
+// The schedule of the accumulator is the one of a stall-free input stream,
+// where ACC_REGS equals NUM_REGS_FMA_ACC. Stalls on the input stream may reduce
+// the number of partial accumulations in flight; pass a smaller acc_regs to
+// reproduce such runs.
+//
+// As in the RTL, the lane strobes of the final beat are taken from the low
+// byte strobes of the stream, so lanes past the end of a row may take part in
+// the maximum and in the sum. The model reads those lanes as zero.
+
+#ifndef __SOFTEX_MODEL_HPP__
+#define __SOFTEX_MODEL_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace softex {
+
+// Defaults mirror softex_pkg
+constexpr unsigned  DEFAULT_LANES           = 8;    // N_ROWS
+constexpr unsigned  DEFAULT_ACC_REGS        = 4;    // NUM_REGS_FMA_ACC
+constexpr unsigned  DEFAULT_NEWTON_ITERS    = 2;    // N_NEWTON_ITERS
+
+constexpr uint16_t  BF16_NEG_INF            = 0xff80;
+constexpr uint16_t  BF16_POS_INF            = 0x7f80;
+
+// expu_schraudolph constants for FP16ALT
+constexpr int       EXPU_A_FRACTION         = 14;
+constexpr uint32_t  EXPU_A                  = 23637;    // int'(1 / ln(2) * 2 ** EXPU_A_FRACTION)
+constexpr uint32_t  EXPU_MAX_EXP            = 133;      // BIAS + (EXPONENT_BITS - (A_INT_BITS + MANTISSA_INT_BITS))
+
+// expu_correction constants
+constexpr uint32_t  EXPU_ALPHA              = 4;
+constexpr uint32_t  EXPU_BETA               = 7;
+constexpr uint32_t  EXPU_GAMMA_1            = 363;
+constexpr uint32_t  EXPU_GAMMA_2            = 278;
+
+// Logarithm of the accumulator, LOG_* of softex_pkg: ln(1 + t) ~= t * (C0 + C1 * t + ... + C4 * t^4)
+constexpr uint32_t  LOG_COEFFS []           = {0x3f7ffdd8, 0xbeffb6bf, 0x3eac32c2, 0xbe8ace65, 0x3e3577ca};
+constexpr uint32_t  LOG_LN2                 = 0x3f317218;
+constexpr uint32_t  LOG_SQRT2_MANT          = 0x003504f3;
+
+// The three fields after acc_regs follow ACCURACY_CTRL, log_output is OUT_MODE_LOG of OUT_CTRL
+struct params {
+    unsigned    lanes           = DEFAULT_LANES;
+    unsigned    acc_regs        = DEFAULT_ACC_REGS;
+    unsigned    newton_iters    = DEFAULT_NEWTON_ITERS;
+    bool        exp_correction  = true;
+    bool        exp_rounding    = true;
+    bool        log_output      = false;
+};
+
+// Content of a state slot: the running maximum and the denominator
+struct row_state {
+    uint16_t    max         = BF16_NEG_INF;
+    float       denominator = 0.0f;
+    bool        valid       = false;
+};
+
+/**********SCALAR PRIMITIVES**********/
+
+inline uint32_t f32_bits (float f) {
+    uint32_t b;
+    std::memcpy(&b, &f, sizeof(b));
+    return b;
+}
+
+inline float bits_f32 (uint32_t b) {
+    float f;
+    std::memcpy(&f, &b, sizeof(f));
+    return f;
+}
+
+inline float bf16_to_f32 (uint16_t h) {
+    return bits_f32(uint32_t(h) << 16);
+}
+
+// Round to nearest even. Since fp32 has more than 2 * 8 + 2 mantissa bits,
+// a bf16 add or mul computed in fp32 and rounded here is correctly rounded.
+inline uint16_t f32_to_bf16 (float f) {
+    uint32_t b = f32_bits(f);
+
+    if ((b & 0x7fffffff) > 0x7f800000)
+        return uint16_t((b >> 16) | 0x0040);
+
+    return uint16_t((b + 0x7fff + ((b >> 16) & 1)) >> 16);
+}
+
+inline uint16_t bf16_sub (uint16_t a, uint16_t b) {
+    return f32_to_bf16(bf16_to_f32(a) - bf16_to_f32(b));
+}
+
+inline uint16_t bf16_mul (uint16_t a, uint16_t b) {
+    return f32_to_bf16(bf16_to_f32(a) * bf16_to_f32(b));
+}
+
+// FP_GT of softex_macros.svh is a total order on the sign-magnitude encoding
+inline uint16_t order_key (uint16_t h) {
+    return h & 0x8000 ? uint16_t(~h) : uint16_t(h | 0x8000);
+}
+
+inline bool fp_gt (uint16_t a, uint16_t b) {
+    return order_key(a) > order_key(b);
+}
+
+/**********I/O FORMATS**********/
+
+// Formats selected at run time through CAST_CTRL, see softex_fp_cast_in / softex_fp_cast_out
+enum class io_fmt { native = 0, fp16 = 1, fp8_e4m3 = 2, fp8_e5m2 = 3 };
+
+struct io_fmt_desc {
+    unsigned    exp_bits;
+    unsigned    man_bits;
+    bool        has_inf;    // OCP E4M3 has no infinities and a single NaN encoding
+};
+
+inline io_fmt_desc describe (io_fmt f) {
+    switch (f) {
+        case io_fmt::fp16:      return {5, 10, true};
+        case io_fmt::fp8_e4m3:  return {4, 3, false};
+        case io_fmt::fp8_e5m2:  return {5, 2, true};
+        default:                return {8, 7, true};
+    }
+}
+
+inline unsigned io_fmt_bytes (io_fmt f) {
+    return f == io_fmt::fp8_e4m3 || f == io_fmt::fp8_e5m2 ? 1 : 2;
+}
+
+// Every value of the narrower formats is exact in fp32, so the only rounding is the final one to bf16
+inline uint16_t io_to_bf16 (uint16_t x, io_fmt f) {
+    if (f == io_fmt::native)
+        return x;
+
+    const io_fmt_desc d = describe(f);
+    const int       bias    = (1 << (d.exp_bits - 1)) - 1;
+    const uint32_t  e_max   = (1u << d.exp_bits) - 1;
+    const uint32_t  m_max   = (1u << d.man_bits) - 1;
+    const bool      sign    = (x >> (d.exp_bits + d.man_bits)) & 1;
+    const uint32_t  e       = (x >> d.man_bits) & e_max;
+    const uint32_t  m       = x & m_max;
+
+    if (d.has_inf ? e == e_max : (e == e_max && m == m_max))
+        return uint16_t((sign ? 0x8000 : 0) | (d.has_inf && m == 0 ? 0x7f80 : 0x7fc0));
+
+    float v = e == 0 ? std::ldexp(float(m), 1 - bias - int(d.man_bits)) : std::ldexp(float(m | (1u << d.man_bits)), int(e) - bias - int(d.man_bits));
+
+    return f32_to_bf16(sign ? -v : v);
+}
+
+// Round to nearest even; denormal inputs are flushed, overflows saturate to the largest finite value
+inline uint16_t f32_to_io (float v, io_fmt f) {
+    if (f == io_fmt::native)
+        return f32_to_bf16(v);
+
+    const uint32_t  x           = f32_bits(v);
+    const io_fmt_desc d = describe(f);
+    const int       bias        = (1 << (d.exp_bits - 1)) - 1;
+    const unsigned  width       = 1 + d.exp_bits + d.man_bits;
+    const uint16_t  sign        = uint16_t((x >> 31) << (width - 1));
+    const uint32_t  e           = (x >> 23) & 0xff;
+    const uint32_t  m           = x & 0x7fffff;
+    const uint32_t  max_finite  = d.has_inf ? ((((1u << d.exp_bits) - 2) << d.man_bits) | ((1u << d.man_bits) - 1)) : ((1u << (width - 1)) - 2);
+    const uint32_t  inf         = d.has_inf ? (((1u << d.exp_bits) - 1) << d.man_bits) : max_finite;
+    const uint32_t  nan         = d.has_inf ? (inf | (1u << (d.man_bits - 1))) : ((1u << (width - 1)) - 1);
+
+    if (e == 0)
+        return sign;
+
+    if (e == 0xff)
+        return uint16_t(sign | (m == 0 ? inf : nan));
+
+    const int new_exp = int(e) - 127 + bias;
+
+    if (new_exp >= (1 << d.exp_bits))
+        return uint16_t(sign | max_finite);
+
+    // Significand with the hidden bit, scaled so that the kept bits are above bit 32
+    const unsigned  shift   = new_exp > 0 ? 0 : unsigned(1 - new_exp);
+    const uint64_t  sig     = uint64_t(0x800000 | m) << (32 + d.man_bits - 23);
+    const uint64_t  sh      = shift >= 64 ? 0 : sig >> shift;
+    const bool      lost    = shift >= 64 ? sig != 0 : (sig & ((uint64_t(1) << shift) - 1)) != 0;
+
+    const uint32_t  kept    = uint32_t(sh >> 32) & ((1u << d.man_bits) - 1);
+    const bool      guard   = (sh >> 31) & 1;
+    const bool      sticky  = (sh & 0x7fffffff) != 0 || lost;
+
+    uint32_t rounded = ((new_exp > 0 ? uint32_t(new_exp) : 0u) << d.man_bits | kept) + (guard && (sticky || (kept & 1)));
+
+    if (rounded > max_finite)
+        rounded = max_finite;
+
+    return uint16_t(sign | rounded);
+}
+
+// Output conversion of softex_fp_cast_out
+inline uint16_t bf16_to_io (uint16_t x, io_fmt f) {
+    return f == io_fmt::native ? x : f32_to_io(bf16_to_f32(x), f);
+}
+
+inline uint16_t exp_schraudolph (uint16_t op, bool rounding = true) {
+    uint32_t sign       = op >> 15;
+    uint32_t exponent   = (op >> 7) & 0xff;
+    uint32_t mantissa   = 0x80 | (op & 0x7f);
+
+    uint32_t scaled     = mantissa * EXPU_A;
+    uint32_t shamt      = EXPU_MAX_EXP - exponent;
+    uint32_t shifted    = exponent > EXPU_MAX_EXP || shamt >= 32 ? 0 : (scaled >> (EXPU_A_FRACTION - 7)) >> shamt;
+    uint32_t rounded    = ((shifted >> 1) + (rounding ? shifted & 1 : 0)) & 0x7fff;
+    uint32_t sgn_mant   = (sign ? 0u - rounded : rounded) & 0x7fff;
+
+    bool ovfr       = exponent > EXPU_MAX_EXP ||
+                      (exponent == EXPU_MAX_EXP && (((scaled >> 22) & 1) || (sign && ((scaled >> 14) & 0xff) == 0xff)));
+    bool denormal   = sign && exponent == EXPU_MAX_EXP && (sgn_mant >> 7) == 0x81;
+
+    if (ovfr || denormal)
+        return sign ? 0x0000 : BF16_POS_INF;
+
+    return uint16_t((((sgn_mant >> 7) + 127) & 0xff) << 7 | (sgn_mant & 0x7f));
+}
+
+inline uint16_t exp_correction (uint16_t op) {
+    uint32_t mantissa   = op & 0x7f;
+    bool     upper      = (mantissa >> 6) & 1;
+
+    uint32_t mul_1      = upper ? (~(mantissa << 1) & 0x7f) : ((mantissa << 1) & 0x7f);
+    uint32_t res_mul_1  = mul_1 * (upper ? EXPU_BETA : EXPU_ALPHA);
+    uint32_t res_add_1  = mantissa + (upper ? EXPU_GAMMA_2 : EXPU_GAMMA_1);
+    uint32_t res_mul_2  = res_mul_1 * res_add_1;
+    uint32_t res_pre    = (res_mul_2 >> 12) & 0x7f;
+
+    return uint16_t((op & 0x7f80) | (upper ? (~res_pre & 0x7f) : res_pre));
+}
+
+inline uint16_t expu (uint16_t op) {
+    return exp_correction(exp_schraudolph(op));
+}
+
+inline uint16_t expu (uint16_t op, const params &p) {
+    uint16_t e = exp_schraudolph(op, p.exp_rounding);
+
+    return p.exp_correction ? exp_correction(e) : e;
+}
+
+// The vectorised exponentials implement the most accurate setting only
+inline bool simd_expu (const params &p) {
+    return p.exp_correction && p.exp_rounding;
+}
+
+// softex_acc_den_inverter with N_MANT_BITS = 7
+inline float reciprocal_approx (float den) {
+    uint32_t b          = f32_bits(den);
+    uint32_t sign       = b >> 31;
+    uint32_t exponent   = (b >> 23) & 0xff;
+    uint32_t sel        = (b >> 16) & 0x7f;
+
+    if (sel == 0)
+        return bits_f32(sign << 31 | ((254 - exponent) & 0xff) << 23);
+
+    uint32_t inv        = ~sel & 0x7f;
+    uint32_t prod       = (inv >> 1) * inv;
+
+    return bits_f32(sign << 31 | ((253 - exponent) & 0xff) << 23 | ((prod >> 6) & 0x7f) << 16);
+}
+
+inline float reciprocal (float den, unsigned newton_iters = DEFAULT_NEWTON_ITERS) {
+    float x = reciprocal_approx(den);
+
+    for (unsigned i = 0; i < newton_iters; i++) {
+        float t = std::fma(-den, x, 2.0f);
+        x = x * t;
+    }
+
+    return x;
+}
+
+// softex_acc_den_log and the LOG_* steps of softex_acc_ctrl: den = 2^e * m with m in [sqrt(2)/2, sqrt(2)),
+// then e * ln(2) + ln(m) with a Horner evaluation on the FMA. Every step is an fp32 operation
+inline float logarithm (float den) {
+    uint32_t b          = f32_bits(den);
+    uint32_t mantissa   = b & 0x7fffff;
+    int      halve      = mantissa >= LOG_SQRT2_MANT;
+    float    m          = bits_f32(uint32_t(halve ? 126 : 127) << 23 | mantissa);
+    float    e          = float(int((b >> 23) & 0xff) - 127 + halve);
+
+    float    t          = m - 1.0f;
+    float    acc        = std::fma(bits_f32(LOG_COEFFS[4]), t, bits_f32(LOG_COEFFS[3]));
+
+    for (int k = 2; k >= 0; k--)
+        acc = std::fma(acc, t, bits_f32(LOG_COEFFS[k]));
+
+    return std::fma(e, bits_f32(LOG_LN2), acc * t);
+}
+
+// OUT_MODE_LSE: the logarithm plus the maximum, in fp32
+inline float log_sum_exp (float den, uint16_t max) {
+    return logarithm(den) + bf16_to_f32(max);
+}
+
+/**********BEAT HELPERS**********/
+
+namespace detail {
+
+// softex_fp_add_rec: the lower (n + 1) / 2 lanes are reduced separately from the upper ones
+inline float tree_sum (const float *v, unsigned n) {
+    if (n == 1)
+        return v[0];
+
+    unsigned a = (n + 1) / 2;
+
+    return tree_sum(v, a) + tree_sum(v + a, n - a);
+}
+
+// Number of strobed lanes in a beat holding "valid" elements
+inline unsigned strobed_lanes (unsigned valid, unsigned lanes) {
+    return valid == lanes ? lanes : std::min(2 * valid, lanes);
+}
+
+inline void load_beat (const uint16_t *x, size_t len, size_t beat, unsigned lanes, uint16_t *dst, unsigned &strobed) {
+    size_t   base   = beat * lanes;
+    unsigned valid  = unsigned(std::min<size_t>(lanes, len - base));
+
+    for (unsigned i = 0; i < lanes; i++)
+        dst[i] = i < valid ? x[base + i] : 0;
+
+    strobed = strobed_lanes(valid, lanes);
+}
+
+inline float beat_sum_scalar (const params &p, const uint16_t *v, unsigned strobed, unsigned lanes, uint16_t max) {
+    float e[64];
+
+    for (unsigned i = 0; i < lanes; i++)
+        e[i] = i < strobed ? bf16_to_f32(expu(bf16_sub(v[i], max), p)) : 0.0f;
+
+    return tree_sum(e, lanes);
+}
+
+#if defined(__AVX2__)
+// Schraudolph + correction on 8 bf16 values held in the low half of 32-bit lanes
+inline __m256i expu_avx2 (__m256i h) {
+    const __m256i c_ff      = _mm256_set1_epi32(0xff);
+    const __m256i c_7f      = _mm256_set1_epi32(0x7f);
+    const __m256i c_7fff    = _mm256_set1_epi32(0x7fff);
+    const __m256i c_one     = _mm256_set1_epi32(1);
+    const __m256i c_maxexp  = _mm256_set1_epi32(EXPU_MAX_EXP);
+
+    __m256i sign        = _mm256_srli_epi32(h, 15);
+    __m256i exponent    = _mm256_and_si256(_mm256_srli_epi32(h, 7), c_ff);
+    __m256i mantissa    = _mm256_or_si256(_mm256_and_si256(h, c_7f), _mm256_set1_epi32(0x80));
+
+    __m256i scaled      = _mm256_mullo_epi32(mantissa, _mm256_set1_epi32(EXPU_A));
+    __m256i shifted     = _mm256_srlv_epi32(_mm256_srli_epi32(scaled, EXPU_A_FRACTION - 7), _mm256_sub_epi32(c_maxexp, exponent));
+    __m256i rounded     = _mm256_and_si256(_mm256_add_epi32(_mm256_srli_epi32(shifted, 1), _mm256_and_si256(shifted, c_one)), c_7fff);
+    __m256i is_neg      = _mm256_cmpeq_epi32(sign, c_one);
+    __m256i sgn_mant    = _mm256_and_si256(_mm256_blendv_epi8(rounded, _mm256_sub_epi32(_mm256_setzero_si256(), rounded), is_neg), c_7fff);
+
+    __m256i exp_gt      = _mm256_cmpgt_epi32(exponent, c_maxexp);
+    __m256i exp_eq      = _mm256_cmpeq_epi32(exponent, c_maxexp);
+    __m256i top_bit     = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_srli_epi32(scaled, 22), c_one), c_one);
+    __m256i top_ones    = _mm256_and_si256(is_neg, _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_srli_epi32(scaled, 14), c_ff), c_ff));
+    __m256i ovfr        = _mm256_or_si256(exp_gt, _mm256_and_si256(exp_eq, _mm256_or_si256(top_bit, top_ones)));
+    __m256i denormal    = _mm256_and_si256(_mm256_and_si256(is_neg, exp_eq), _mm256_cmpeq_epi32(_mm256_srli_epi32(sgn_mant, 7), _mm256_set1_epi32(0x81)));
+
+    __m256i new_exp     = _mm256_and_si256(_mm256_add_epi32(_mm256_srli_epi32(sgn_mant, 7), _mm256_set1_epi32(127)), c_ff);
+    __m256i res         = _mm256_or_si256(_mm256_slli_epi32(new_exp, 7), _mm256_and_si256(sgn_mant, c_7f));
+    __m256i special     = _mm256_andnot_si256(is_neg, _mm256_set1_epi32(BF16_POS_INF));
+    res                 = _mm256_blendv_epi8(res, special, _mm256_or_si256(ovfr, denormal));
+
+    __m256i cm          = _mm256_and_si256(res, c_7f);
+    __m256i upper       = _mm256_cmpeq_epi32(_mm256_and_si256(cm, _mm256_set1_epi32(0x40)), _mm256_set1_epi32(0x40));
+    __m256i cm2         = _mm256_and_si256(_mm256_slli_epi32(cm, 1), c_7f);
+    __m256i mul_1       = _mm256_blendv_epi8(cm2, _mm256_xor_si256(cm2, c_7f), upper);
+    __m256i res_mul_1   = _mm256_mullo_epi32(mul_1, _mm256_blendv_epi8(_mm256_set1_epi32(EXPU_ALPHA), _mm256_set1_epi32(EXPU_BETA), upper));
+    __m256i res_add_1   = _mm256_add_epi32(cm, _mm256_blendv_epi8(_mm256_set1_epi32(EXPU_GAMMA_1), _mm256_set1_epi32(EXPU_GAMMA_2), upper));
+    __m256i res_pre     = _mm256_and_si256(_mm256_srli_epi32(_mm256_mullo_epi32(res_mul_1, res_add_1), 12), c_7f);
+    __m256i corrected   = _mm256_blendv_epi8(res_pre, _mm256_xor_si256(res_pre, c_7f), upper);
+
+    return _mm256_or_si256(_mm256_and_si256(res, _mm256_set1_epi32(0x7f80)), corrected);
+}
+
+// Rounds fp32 values (finite or infinite) to bf16, returned in the low half of 32-bit lanes
+inline __m256i f32_to_bf16_avx2 (__m256 f) {
+    __m256i b = _mm256_castps_si256(f);
+    __m256i r = _mm256_add_epi32(_mm256_add_epi32(b, _mm256_set1_epi32(0x7fff)), _mm256_and_si256(_mm256_srli_epi32(b, 16), _mm256_set1_epi32(1)));
+
+    return _mm256_srli_epi32(r, 16);
+}
+
+inline __m256 bf16_to_f32_avx2 (__m256i h) {
+    return _mm256_castsi256_ps(_mm256_slli_epi32(h, 16));
+}
+
+// Exponentials of 8 consecutive scores, shifted by the maximum
+inline __m256i exp_diff_avx2 (const uint16_t *x, __m256 max) {
+    __m256i h = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(x)));
+
+    return expu_avx2(f32_to_bf16_avx2(_mm256_sub_ps(bf16_to_f32_avx2(h), max)));
+}
+
+inline float tree_sum_avx2 (__m256 e) {
+    __m256 s = _mm256_hadd_ps(e, e);
+    s = _mm256_hadd_ps(s, s);
+
+    return _mm_cvtss_f32(_mm256_castps256_ps128(s)) + _mm_cvtss_f32(_mm256_extractf128_ps(s, 1));
+}
+
+inline void store_bf16_avx2 (uint16_t *y, __m256i h) {
+    __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(y), packed);
+}
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+inline __m512i expu_avx512 (__m512i h) {
+    const __m512i c_ff      = _mm512_set1_epi32(0xff);
+    const __m512i c_7f      = _mm512_set1_epi32(0x7f);
+    const __m512i c_7fff    = _mm512_set1_epi32(0x7fff);
+    const __m512i c_one     = _mm512_set1_epi32(1);
+    const __m512i c_maxexp  = _mm512_set1_epi32(EXPU_MAX_EXP);
+
+    __m512i exponent    = _mm512_and_si512(_mm512_srli_epi32(h, 7), c_ff);
+    __m512i mantissa    = _mm512_or_si512(_mm512_and_si512(h, c_7f), _mm512_set1_epi32(0x80));
+    __mmask16 is_neg    = _mm512_test_epi32_mask(h, _mm512_set1_epi32(0x8000));
+
+    __m512i scaled      = _mm512_mullo_epi32(mantissa, _mm512_set1_epi32(EXPU_A));
+    __m512i shifted     = _mm512_srlv_epi32(_mm512_srli_epi32(scaled, EXPU_A_FRACTION - 7), _mm512_sub_epi32(c_maxexp, exponent));
+    __m512i rounded     = _mm512_and_si512(_mm512_add_epi32(_mm512_srli_epi32(shifted, 1), _mm512_and_si512(shifted, c_one)), c_7fff);
+    __m512i sgn_mant    = _mm512_and_si512(_mm512_mask_sub_epi32(rounded, is_neg, _mm512_setzero_si512(), rounded), c_7fff);
+
+    __mmask16 exp_gt    = _mm512_cmpgt_epu32_mask(exponent, c_maxexp);
+    __mmask16 exp_eq    = _mm512_cmpeq_epu32_mask(exponent, c_maxexp);
+    __mmask16 top_bit   = _mm512_test_epi32_mask(scaled, _mm512_set1_epi32(1 << 22));
+    __mmask16 top_ones  = is_neg & _mm512_cmpeq_epu32_mask(_mm512_and_si512(_mm512_srli_epi32(scaled, 14), c_ff), c_ff);
+    __mmask16 ovfr      = exp_gt | (exp_eq & (top_bit | top_ones));
+    __mmask16 denormal  = is_neg & exp_eq & _mm512_cmpeq_epu32_mask(_mm512_srli_epi32(sgn_mant, 7), _mm512_set1_epi32(0x81));
+
+    __m512i new_exp     = _mm512_and_si512(_mm512_add_epi32(_mm512_srli_epi32(sgn_mant, 7), _mm512_set1_epi32(127)), c_ff);
+    __m512i res         = _mm512_or_si512(_mm512_slli_epi32(new_exp, 7), _mm512_and_si512(sgn_mant, c_7f));
+    __m512i special     = _mm512_mask_blend_epi32(is_neg, _mm512_set1_epi32(BF16_POS_INF), _mm512_setzero_si512());
+    res                 = _mm512_mask_blend_epi32(ovfr | denormal, res, special);
+
+    __m512i cm          = _mm512_and_si512(res, c_7f);
+    __mmask16 upper     = _mm512_test_epi32_mask(cm, _mm512_set1_epi32(0x40));
+    __m512i cm2         = _mm512_and_si512(_mm512_slli_epi32(cm, 1), c_7f);
+    __m512i mul_1       = _mm512_mask_xor_epi32(cm2, upper, cm2, c_7f);
+    __m512i res_mul_1   = _mm512_mullo_epi32(mul_1, _mm512_mask_blend_epi32(upper, _mm512_set1_epi32(EXPU_ALPHA), _mm512_set1_epi32(EXPU_BETA)));
+    __m512i res_add_1   = _mm512_add_epi32(cm, _mm512_mask_blend_epi32(upper, _mm512_set1_epi32(EXPU_GAMMA_1), _mm512_set1_epi32(EXPU_GAMMA_2)));
+    __m512i res_pre     = _mm512_and_si512(_mm512_srli_epi32(_mm512_mullo_epi32(res_mul_1, res_add_1), 12), c_7f);
+    __m512i corrected   = _mm512_mask_xor_epi32(res_pre, upper, res_pre, c_7f);
+
+    return _mm512_or_si512(_mm512_and_si512(res, _mm512_set1_epi32(0x7f80)), corrected);
+}
+
+inline __m512i f32_to_bf16_avx512 (__m512 f) {
+    __m512i b = _mm512_castps_si512(f);
+    __m512i r = _mm512_add_epi32(_mm512_add_epi32(b, _mm512_set1_epi32(0x7fff)), _mm512_and_si512(_mm512_srli_epi32(b, 16), _mm512_set1_epi32(1)));
+
+    return _mm512_srli_epi32(r, 16);
+}
+
+inline __m512 bf16_to_f32_avx512 (__m512i h) {
+    return _mm512_castsi512_ps(_mm512_slli_epi32(h, 16));
+}
+
+// Two beats of 8 lanes each: returns the tree sums of the lower and the upper beat
+inline void tree_sum_x2_avx512 (__m512 e, float &lo, float &hi) {
+    __m512 s = _mm512_add_ps(e, _mm512_permute_ps(e, 0xb1));   // (0 + 1), (2 + 3), ...
+    s = _mm512_add_ps(s, _mm512_permute_ps(s, 0x4e));           // ((0 + 1) + (2 + 3)), ...
+    s = _mm512_add_ps(s, _mm512_shuffle_f32x4(s, s, 0xb1));     // lower half + upper half of each beat
+
+    lo = _mm512_cvtss_f32(s);
+    hi = _mm512_cvtss_f32(_mm512_shuffle_f32x4(s, s, 0xee));
+}
+#endif
+
+} // namespace detail
+
+/**********ACCUMULATION**********/
+
+namespace detail {
+
+struct addend_t {
+    float       value;
+    unsigned    tag;
+};
+
+// softex_acc_datapath: partial accumulations carry the tag of the maximum they
+// are referred to and cycle through the FMA in a fixed order. The factor FIFO
+// only exposes the oldest pending factor, so a partial can only be rescaled if
+// its tag is the lowest among the ones in flight.
+inline float accumulate_partials (const std::vector<addend_t> &addends, const std::vector<uint16_t> &factors, unsigned acc_regs, bool resume) {
+    std::deque<addend_t> ring;
+    size_t next = 0;
+
+    if (addends.empty())
+        return 0.0f;
+
+    auto min_tag = [&ring] () {
+        unsigned t = ~0u;
+        for (const addend_t &p : ring)
+            t = std::min(t, p.tag);
+        return t;
+    };
+
+    // One pass of the partial at the output of the FMA
+    auto step = [&] (bool flushing) {
+        addend_t p = ring.front();
+        ring.pop_front();
+
+        unsigned lowest = std::min(p.tag, min_tag());
+
+        if (!flushing && addends[next].tag == p.tag) {
+            p.value = p.value + addends[next++].value;
+        } else if (p.tag == lowest && p.tag < factors.size()) {
+            float f = bf16_to_f32(factors[p.tag]);
+
+            if (!flushing && addends[next].tag == p.tag + 1) {
+                p.value = std::fma(f, p.value, addends[next++].value);
+            } else {
+                p.value = f * p.value;
+            }
+
+            p.tag++;
+        } else {
+            p.value = p.value + 0.0f;
+        }
+
+        ring.push_back(p);
+    };
+
+    // When resuming, the loaded denominator is the first partial and it is
+    // waiting at the output of the FMA when the first addend arrives
+    if (resume) {
+        ring.push_back({addends[next].value + 0.0f, addends[next].tag});
+        next++;
+
+        if (next < addends.size())
+            step(false);
+    }
+
+    while (ring.size() < acc_regs && next < addends.size()) {
+        ring.push_back({addends[next].value + 0.0f, addends[next].tag});
+        next++;
+    }
+
+    while (next < addends.size())
+        step(false);
+
+    auto pending = [&] () {
+        for (const addend_t &p : ring)
+            if (p.tag < factors.size())
+                return true;
+        return false;
+    };
+
+    while (pending())
+        step(true);
+
+    // Final reduction: every other output is pushed back and summed with the next one
+    while (ring.size() > 1) {
+        addend_t a = ring.front();
+        ring.pop_front();
+        addend_t b = ring.front();
+        ring.pop_front();
+
+        ring.push_back({b.value + a.value, a.tag});
+    }
+
+    return ring.front().value;
+}
+
+template <typename F>
+inline void parallel_for (size_t n, unsigned threads, F &&f) {
+    threads = unsigned(std::max<size_t>(1, std::min<size_t>(threads, n)));
+
+    if (threads <= 1) {
+        f(size_t(0), n);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    size_t chunk = (n + threads - 1) / threads;
+
+    for (unsigned t = 0; t < threads; t++) {
+        size_t begin = t * chunk;
+        size_t end   = std::min(n, begin + chunk);
+
+        if (begin >= end)
+            break;
+
+        pool.emplace_back([&f, begin, end] () { f(begin, end); });
+    }
+
+    for (std::thread &t : pool)
+        t.join();
+}
+
+// Sums of the exponentiated beats [begin, end), each shifted by its own maximum
+inline void beat_sums (const params &p, const uint16_t *x, size_t len, const uint16_t *beat_max, size_t begin, size_t end, float *sums) {
+    const unsigned lanes    = p.lanes;
+    const size_t   full     = len / lanes;
+    size_t         k        = begin;
+
+    (void) full;
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+    if (lanes == 8 && simd_expu(p)) {
+        for (; k + 1 < std::min(end, full); k += 2) {
+            __m512i h   = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + k * lanes)));
+            __m512  max = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_inserti64x4(_mm512_set1_epi32(beat_max[k]), _mm256_set1_epi32(beat_max[k + 1]), 1), 16));
+            __m512i d   = f32_to_bf16_avx512(_mm512_sub_ps(bf16_to_f32_avx512(h), max));
+
+            tree_sum_x2_avx512(bf16_to_f32_avx512(expu_avx512(d)), sums[k - begin], sums[k + 1 - begin]);
+        }
+    }
+#endif
+
+#if defined(__AVX2__)
+    if (lanes % 8 == 0 && (lanes & (lanes - 1)) == 0 && simd_expu(p)) {
+        for (; k < std::min(end, full); k++) {
+            __m256  max = _mm256_set1_ps(bf16_to_f32(beat_max[k]));
+            float   part[8];
+
+            for (unsigned g = 0; g < lanes / 8; g++)
+                part[g] = tree_sum_avx2(bf16_to_f32_avx2(exp_diff_avx2(x + k * lanes + g * 8, max)));
+
+            // Groups of 8 lanes are combined pairwise, as in the upper levels of the tree
+            for (unsigned n = lanes / 8; n > 1; n /= 2)
+                for (unsigned g = 0; g < n / 2; g++)
+                    part[g] = part[2 * g] + part[2 * g + 1];
+
+            sums[k - begin] = part[0];
+        }
+    }
+#endif
+
+    for (; k < end; k++) {
+        uint16_t v[64];
+        unsigned strobed;
+
+        load_beat(x, len, k, lanes, v, strobed);
+        sums[k - begin] = beat_sum_scalar(p, v, strobed, lanes, beat_max[k]);
+    }
+}
+
+} // namespace detail
+
+// Partial accumulation of a row (or chunk of a row) into a state slot. If the
+// state is valid the maximum and the denominator are resumed from it, as when
+// SOFTEX_CMD_ACC_ONLY is issued without SOFTEX_CMD_ACQUIRE_SLOT.
+inline void accumulate (const params &p, const uint16_t *x, size_t len, row_state &state, unsigned threads = 1) {
+    const unsigned  lanes   = p.lanes;
+    const size_t    n_beats = (len + lanes - 1) / lanes;
+    const bool      resume  = state.valid;
+
+    std::vector<uint16_t>   beat_max    (n_beats);
+    std::vector<unsigned>   beat_tag    (n_beats);
+    std::vector<uint16_t>   factors;
+    std::vector<float>      sums        (n_beats);
+
+    uint16_t    cur_max     = resume ? state.max : BF16_NEG_INF;
+    bool        max_valid   = resume;
+    unsigned    tag         = 0;
+
+    // The maximum is a sequential scan, the rescaling factors are computed
+    // whenever it changes and a previous maximum exists
+    for (size_t k = 0; k < n_beats; k++) {
+        uint16_t v[64];
+        unsigned strobed;
+        uint16_t key = 0;
+
+        detail::load_beat(x, len, k, lanes, v, strobed);
+
+        for (unsigned i = 0; i < strobed; i++)
+            key = std::max(key, order_key(v[i]));
+
+        uint16_t vect_max = key & 0x8000 ? uint16_t(key & 0x7fff) : uint16_t(~key);
+
+        if (strobed != 0 && fp_gt(vect_max, cur_max)) {
+            if (max_valid) {
+                factors.push_back(expu(bf16_sub(cur_max, vect_max), p));
+                tag++;
+            }
+
+            cur_max = vect_max;
+        }
+
+        max_valid   = true;
+        beat_max[k] = cur_max;
+        beat_tag[k] = tag;
+    }
+
+    detail::parallel_for(n_beats, threads, [&] (size_t begin, size_t end) {
+        detail::beat_sums(p, x, len, beat_max.data(), begin, end, sums.data() + begin);
+    });
+
+    std::vector<detail::addend_t> addends;
+    addends.reserve(n_beats + 1);
+
+    if (resume)
+        addends.push_back({state.denominator, 0});
+
+    for (size_t k = 0; k < n_beats; k++)
+        addends.push_back({sums[k], beat_tag[k]});
+
+    state.denominator   = detail::accumulate_partials(addends, factors, std::max(1u, p.acc_regs), resume);
+    state.max           = cur_max;
+    state.valid         = true;
+}
+
+/**********NORMALISATION**********/
+
+// y = bf16(exp(x - max)) * bf16(reciprocal), both operations rounded to bf16
+inline void normalise (const params &p, const uint16_t *x, size_t len, uint16_t max, float recip, uint16_t *y, unsigned threads = 1) {
+    const uint16_t inv     = f32_to_bf16(recip);
+    const bool     simd    = simd_expu(p);
+
+    (void) simd;
+
+    detail::parallel_for(len, threads, [&] (size_t begin, size_t end) {
+        size_t i = begin;
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+        __m512 max_512 = _mm512_set1_ps(bf16_to_f32(max));
+        __m512 inv_512 = _mm512_set1_ps(bf16_to_f32(inv));
+
+        for (; simd && i + 16 <= end; i += 16) {
+            __m512i h = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i)));
+            __m512i e = detail::expu_avx512(detail::f32_to_bf16_avx512(_mm512_sub_ps(detail::bf16_to_f32_avx512(h), max_512)));
+            __m512i r = detail::f32_to_bf16_avx512(_mm512_mul_ps(detail::bf16_to_f32_avx512(e), inv_512));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(y + i), _mm512_cvtepi32_epi16(r));
+        }
+#endif
+
+#if defined(__AVX2__)
+        __m256 max_256 = _mm256_set1_ps(bf16_to_f32(max));
+        __m256 inv_256 = _mm256_set1_ps(bf16_to_f32(inv));
+
+        for (; simd && i + 8 <= end; i += 8) {
+            __m256i e = detail::exp_diff_avx2(x + i, max_256);
+            __m256i r = detail::f32_to_bf16_avx2(_mm256_mul_ps(detail::bf16_to_f32_avx2(e), inv_256));
+
+            detail::store_bf16_avx2(y + i, r);
+        }
+#endif
+
+        for (; i < end; i++)
+            y[i] = bf16_mul(expu(bf16_sub(x[i], max), p), inv);
+    });
+}
+
+// y = bf16(x - max) - bf16(ln), a single rounding as the FMSUB of the datapath computes bf16(x - max) * 1 - bf16(ln)
+inline void normalise_log (const uint16_t *x, size_t len, uint16_t max, float ln, uint16_t *y, unsigned threads = 1) {
+    const uint16_t ln_bf16 = f32_to_bf16(ln);
+
+    detail::parallel_for(len, threads, [&] (size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            y[i] = bf16_sub(bf16_sub(x[i], max), ln_bf16);
+    });
+}
+
+// The normalisation of a DIV_ONLY job or of a complete one, in the mode selected by the parameters. A row whose
+// elements are all masked has a -inf maximum, its probabilities are written as zeros instead of NaN
+inline void normalise_state (const params &p, const uint16_t *x, size_t len, const row_state &state, uint16_t *y, unsigned threads = 1) {
+    if (!p.log_output && state.max == BF16_NEG_INF)
+        std::fill(y, y + len, uint16_t(0));
+    else if (p.log_output)
+        normalise_log(x, len, state.max, logarithm(state.denominator), y, threads);
+    else
+        normalise(p, x, len, state.max, reciprocal(state.denominator, p.newton_iters), y, threads);
+}
+
+/**********TOP-K**********/
+
+constexpr unsigned  TOPK_MAX                = 8;            // TOPK_MAX
+constexpr uint32_t  TOPK_NO_INDEX           = 0xffffffff;
+
+struct topk_entry {
+    uint32_t    index   = TOPK_NO_INDEX;
+    uint16_t    value   = 0;
+};
+
+// softex_topk: the "k" largest outputs of a row, best first, the lowest index first on ties
+inline std::vector<topk_entry> topk (const uint16_t *y, size_t len, unsigned k) {
+    std::vector<topk_entry> res(k);
+    std::vector<uint32_t>   order(len);
+
+    for (size_t i = 0; i < len; i++)
+        order[i] = uint32_t(i);
+
+    const size_t n = std::min(size_t(k), len);
+
+    std::partial_sort(order.begin(), order.begin() + n, order.end(), [y] (uint32_t a, uint32_t b) {
+        return fp_gt(y[a], y[b]) || (y[a] == y[b] && a < b);
+    });
+
+    for (size_t e = 0; e < n; e++)
+        res[e] = {order[e], y[order[e]]};
+
+    return res;
+}
+
+/**********SPARSE OUTPUT**********/
+
+// softex_sparse: the outputs of a row above "threshold", by increasing index
+inline std::vector<topk_entry> sparse (const uint16_t *y, size_t len, uint16_t threshold) {
+    std::vector<topk_entry> res;
+
+    for (size_t i = 0; i < len; i++)
+        if (fp_gt(y[i], threshold))
+            res.push_back({uint32_t(i), y[i]});
+
+    return res;
+}
+
+/**********ACTIVATIONS**********/
+
+// OUT_ACT of OUT_CTRL
+enum class act_mode : unsigned { none = 0, exp = 1, sigmoid = 2, silu = 3, gelu = 4 };
+
+// Pre-scale factors of the sigmoid-based activations, -1 and -1.703125
+constexpr uint16_t  ACT_SCALE_NEG           = 0xbf80;
+constexpr uint16_t  ACT_SCALE_GELU          = 0xbfda;
+
+// The reciprocal table of softex_act: num / (den * d) for d >= 1, from the mantissa of d alone. The result is rounded
+// to 7 mantissa bits and flushed to zero below the normal range
+inline uint16_t act_reciprocal (uint16_t d, uint64_t num, uint64_t den, bool negative) {
+    const uint32_t  exponent    = (d >> 7) & 0xff;
+    const uint64_t  m           = 128 + (d & 0x7f);
+    const uint16_t  sign        = negative ? 0x8000 : 0;
+
+    if (exponent == 0xff)
+        return (d & 0x7f) ? 0x7fc0 : sign;
+
+    int sh = 0;
+
+    while (num << (7 + sh) < den * m)
+        sh++;
+
+    uint64_t q = ((2 * num << (14 + sh)) / (den * m) + 1) / 2;
+
+    if (q == 256) {
+        q = 128;
+        sh--;
+    }
+
+    const int r_exp = 254 - int(exponent) - sh;
+
+    if (r_exp <= 0)
+        return sign;
+
+    return uint16_t(sign | uint32_t(r_exp) << 7 | (q & 0x7f));
+}
+
+// The activation of an input that entered the datapath, pre-scaled by SCALE for act_mode::exp only. Like the
+// hardware: z = k * x in the pre-scale, t = exp(z - 0), d = t * 1 + 1 in a single rounding, then the last multiply
+inline uint16_t activation (const params &p, act_mode act, uint16_t x) {
+    if (act == act_mode::exp)
+        return expu(bf16_sub(x, 0), p);
+
+    const uint16_t  z   = bf16_mul(x, act == act_mode::gelu ? ACT_SCALE_GELU : ACT_SCALE_NEG);
+    const uint16_t  t   = expu(bf16_sub(z, 0), p);
+    const uint16_t  d   = f32_to_bf16(bf16_to_f32(t) + 1.0f);
+
+    switch (act) {
+        case act_mode::sigmoid: return act_reciprocal(d, 1, 1, false);
+        case act_mode::silu:    return bf16_mul(z, act_reciprocal(d, 1, 1, true));
+        default:                return bf16_mul(z, act_reciprocal(d, 64, 109, true));
+    }
+}
+
+inline void activation (const params &p, act_mode act, const uint16_t *x, size_t len, uint16_t *y, unsigned threads = 1) {
+    detail::parallel_for(len, threads, [&] (size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            y[i] = activation(p, act, x[i]);
+    });
+}
+
+/**********FULL SOFTMAX**********/
+
+// A complete job (neither ACC_ONLY nor DIV_ONLY). Returns the final state,
+// whose denominator is the one written to golden_sum.txt.
+inline row_state softmax (const params &p, const uint16_t *x, size_t len, uint16_t *y, unsigned threads = 1) {
+    row_state state;
+
+    accumulate(p, x, len, state, threads);
+    normalise_state(p, x, len, state, y, threads);
+
+    return state;
+}
+
+// Independent rows of "len" elements, spread over the available threads
+inline void softmax_batch (const params &p, const uint16_t *x, size_t len, size_t n_vectors, uint16_t *y, float *denominators, unsigned threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // With fewer rows than threads each row is split across threads instead
+    if (n_vectors < threads) {
+        for (size_t v = 0; v < n_vectors; v++) {
+            row_state s = softmax(p, x + v * len, len, y + v * len, threads);
+
+            if (denominators)
+                denominators[v] = s.denominator;
+        }
+
+        return;
+    }
+
+    detail::parallel_for(n_vectors, threads, [&] (size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            row_state s = softmax(p, x + v * len, len, y + v * len, 1);
+
+            if (denominators)
+                denominators[v] = s.denominator;
+        }
+    });
+}
+
+} // namespace softex
+
+#endif
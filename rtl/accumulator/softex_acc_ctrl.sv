@@ -27,6 +27,8 @@ module softex_acc_ctrl import softex_pkg::*; #(
         INVERSION,
         INV_MUL,
         INV_FMA,
+        LOG_START,
+        LOG_FMA,
         FINISHED
     } acc_state_t;
 
@@ -36,6 +38,10 @@ module softex_acc_ctrl import softex_pkg::*; #(
     logic [$clog2(N_INV_ITERS) + 1 : 0] iteration_cnt;
     logic iteration_cnt_enable;
 
+    logic [$clog2(N_LOG_COEFFS + 4) - 1 : 0]    log_step_cnt,
+                                                log_last_step;
+    logic log_step_cnt_enable;
+
     logic   disable_ready,
             push_fma_res,
             red_out_cnt,
@@ -47,6 +53,9 @@ module softex_acc_ctrl import softex_pkg::*; #(
             res_valid,
             fma_inv_valid,
             first_inv_iter,
+            logging,
+            fma_log_valid,
+            log_store,
             accumulation_done,
             inversion_done;
 
@@ -89,6 +98,27 @@ module softex_acc_ctrl import softex_pkg::*; #(
         end
     end
 
+    always_ff @(posedge clk_i or negedge rst_ni) begin : log_step_counter
+        if (~rst_ni) begin
+            log_step_cnt <= '0;
+        end else begin
+            if (clear_i | (current_state == LOG_START)) begin
+                log_step_cnt <= '0;
+            end else if (log_step_cnt_enable) begin
+                log_step_cnt <= log_step_cnt + 1;
+            end
+        end
+    end
+
+    /*  The logarithm is a sequence of operations of the FMA, see softex_acc_datapath:      *
+     *      0:                  t = m - 1                                                   *
+     *      1:                  e                                                           *
+     *      2 - N_LOG_COEFFS:   Horner evaluation of the polynomial in t                    *
+     *      N_LOG_COEFFS + 1:   times t                                                     *
+     *      N_LOG_COEFFS + 2:   plus e * ln(2), the result is ln(denominator)               *
+     *      N_LOG_COEFFS + 3:   plus the maximum, only with "add_max"                       */
+    assign log_last_step = ctrl_i.add_max ? N_LOG_COEFFS + 3 : N_LOG_COEFFS + 2;
+
     assign flags_o.reducing     = reducing;
     assign flags_o.acc_done     = accumulation_done;
     assign flags_o.inv_done     = inversion_done;
@@ -107,6 +137,10 @@ module softex_acc_ctrl import softex_pkg::*; #(
     assign ctrl_datapath_o.new_inv_iter     = iteration_cnt_enable;
     assign ctrl_datapath_o.fma_inv_valid    = fma_inv_valid;
     assign ctrl_datapath_o.first_inv_iter   = first_inv_iter;
+    assign ctrl_datapath_o.logging          = logging;
+    assign ctrl_datapath_o.fma_log_valid    = fma_log_valid;
+    assign ctrl_datapath_o.log_store        = log_store;
+    assign ctrl_datapath_o.log_step         = current_state == LOG_START ? '0 : log_step_cnt + 1;
 
     assign ctrl_datapath_o.load_reciprocal  = ctrl_i.load_reciprocal;
     assign ctrl_datapath_o.reciprocal       = ctrl_i.reciprocal;
@@ -125,6 +159,10 @@ module softex_acc_ctrl import softex_pkg::*; #(
         fma_inv_valid           = '0;
         inv_fma                 = '0;
         first_inv_iter          = '0;
+        log_step_cnt_enable     = '0;
+        logging                 = '0;
+        fma_log_valid           = '0;
+        log_store               = '0;
         accumulation_done       = '0;
         inversion_done          = '0;
 
@@ -168,12 +206,17 @@ module softex_acc_ctrl import softex_pkg::*; #(
 
                     if (ctrl_i.acc_only) begin
                         next_state = IDLE;
+                    end else if (ctrl_i.logarithm) begin
+                        next_state = LOG_START;
                     end else begin
                         inverting       = '1;
                         push_fma_res    = '0;
                         inv_enable      = '1;
 
-                        if (COMB_INV) begin
+                        // With no Newton-Raphson iterations the first approximation is the reciprocal
+                        if (COMB_INV & (ctrl_i.newton_iters == '0)) begin
+                            next_state      = FINISHED;
+                        end else if (COMB_INV) begin
                             next_state      = INV_FMA;
                             fma_inv_valid   = '1;
                             inv_fma         = '1;
@@ -190,9 +233,13 @@ module softex_acc_ctrl import softex_pkg::*; #(
                 inverting = '1;
 
                 if (flags_datapath_i.inv_appr_valid) begin
-                    next_state = INV_FMA;
-                    fma_inv_valid = '1;
-                    inv_fma = '1;
+                    if (ctrl_i.newton_iters == '0) begin
+                        next_state = FINISHED;
+                    end else begin
+                        next_state = INV_FMA;
+                        fma_inv_valid = '1;
+                        inv_fma = '1;
+                    end
                 end
             end
 
@@ -214,7 +261,7 @@ module softex_acc_ctrl import softex_pkg::*; #(
                 if (flags_datapath_i.fma_o_valid) begin
                     iteration_cnt_enable = '1;
 
-                    if (iteration_cnt == (N_INV_ITERS - 1)) begin
+                    if (iteration_cnt == (ctrl_i.newton_iters - 1)) begin
                         next_state = FINISHED;
                     end else begin
                         next_state = INV_FMA;
@@ -224,6 +271,28 @@ module softex_acc_ctrl import softex_pkg::*; #(
                 end
             end
 
+            // The denominator register is now valid, the first operation of the logarithm is issued
+            LOG_START: begin
+                logging         = '1;
+                fma_log_valid   = '1;
+                next_state      = LOG_FMA;
+            end
+
+            // Each result of the FMA is an operand of the next step
+            LOG_FMA: begin
+                logging = '1;
+
+                if (flags_datapath_i.fma_o_valid) begin
+                    if (log_step_cnt == log_last_step) begin
+                        log_store   = '1;
+                        next_state  = FINISHED;
+                    end else begin
+                        log_step_cnt_enable = '1;
+                        fma_log_valid       = '1;
+                    end
+                end
+            end
+
             FINISHED: begin
                 res_valid       = '1;
                 disable_ready   = '0;
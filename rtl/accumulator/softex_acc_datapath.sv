@@ -32,6 +32,7 @@ module softex_acc_datapath import softex_pkg::*; #(
     input   logic [ADD_WIDTH - 1 : 0]           add_i       ,
     input   logic                               mul_valid_i ,
     input   logic [MUL_WIDTH - 1 : 0]           mul_i       ,
+    input   logic [MUL_WIDTH - 1 : 0]           max_i       ,
     output  logic                               ready_o     ,
     output  logic                               valid_o     ,
     output  softex_pkg::acc_datapath_flags_t    flags_o     ,
@@ -41,6 +42,12 @@ module softex_acc_datapath import softex_pkg::*; #(
     localparam int unsigned ZEROPAD_MUL = ACC_WIDTH - MUL_WIDTH;
     localparam int unsigned ZEROPAD_ADD = ACC_WIDTH - ADD_WIDTH;
 
+    localparam int unsigned ACC_MANT_BITS   = fpnew_pkg::man_bits(ACC_FPFORMAT);
+    localparam int unsigned ACC_EXP_BITS    = fpnew_pkg::exp_bits(ACC_FPFORMAT);
+
+    localparam logic [ACC_WIDTH - 1 : 0]    ACC_NEG_ONE     = {1'b1, 1'b0, {(ACC_EXP_BITS - 1){1'b1}}, {ACC_MANT_BITS{1'b0}}};
+    localparam logic [ACC_WIDTH - 1 : 0]    LOG_NEG_EXP_OFFS = {1'b1, ACC_EXP_BITS'(fpnew_pkg::bias(ACC_FPFORMAT) + ACC_MANT_BITS), ACC_MANT_BITS'(LOG_EXP_OFFS)};
+
     localparam int unsigned USES_CNT_W  = ~(NUM_REGS_FMA & (NUM_REGS_FMA - 1)) ? $clog2(NUM_REGS_FMA) + 1 : $clog2(NUM_REGS_FMA);
 
     typedef struct packed {
@@ -70,6 +77,14 @@ module softex_acc_datapath import softex_pkg::*; #(
                                 inv_appr_d,
                                 inv_appr_q;
 
+    logic [ACC_WIDTH - 1 : 0]   log_mant,
+                                log_exp,
+                                log_t_q,
+                                log_e_q;
+
+    logic [3 * ACC_WIDTH - 1 : 0]   log_operands;
+    fpnew_pkg::operation_e          log_operation;
+
     //Addend FIFO Signals
     addend_t    addend,
                 i_addend;
@@ -84,6 +99,8 @@ module softex_acc_datapath import softex_pkg::*; #(
     factor_t                    factor;
     factor_t                    i_factor;
 
+    logic [MUL_WIDTH - 1 : 0]   factor_pre_cast;
+
     logic                       factor_pop,
                                 factor_push;
 
@@ -166,6 +183,8 @@ module softex_acc_datapath import softex_pkg::*; #(
                 inv_appr_q <= '0;
             end else if (ctrl_i.load_reciprocal) begin
                 inv_appr_q <= ctrl_i.reciprocal;
+            end else if (ctrl_i.log_store) begin
+                inv_appr_q <= fma_res;
             end else if (inv_appr_enable) begin
                 inv_appr_q <= inv_appr_d;
             end
@@ -182,7 +201,7 @@ module softex_acc_datapath import softex_pkg::*; #(
      *        its tag matches the one of the factor                         */
 
     assign addend_match = (factor_match ? ((fma_o_tag + 1'b1) == addend.tag) : (fma_o_tag == addend.tag)) & fma_o_valid & ~addend_empty;
-    assign addend_pop   = (ctrl_i.reducing | ctrl_i.inverting) ? (addend_match & fma_o_valid) : (addend_match | (~fma_o_valid & ~addend_empty));
+    assign addend_pop   = (ctrl_i.reducing | ctrl_i.inverting | ctrl_i.logging) ? (addend_match & fma_o_valid) : (addend_match | (~fma_o_valid & ~addend_empty));
     assign addend_push  = (add_valid_i & ready_o) | (ctrl_i.push_fma_res & fma_o_valid);
 
     assign i_addend.value   =   ctrl_i.push_fma_res ? fma_res : add_i;
@@ -257,6 +276,9 @@ module softex_acc_datapath import softex_pkg::*; #(
         end
     end
 
+    // The last step of the logarithm adds the maximum, it goes through the cast of the factors as the FIFO is empty
+    assign factor_pre_cast = ctrl_i.logging ? max_i : factor.value;
+
     if (MUL_FPFORMAT != ACC_FPFORMAT) begin : gen_factor_cast
         fpnew_cast_multi #(
             .FpFmtConfig    (   softex_pkg::fmt_to_conf(MUL_FPFORMAT, ACC_FPFORMAT) ),
@@ -268,7 +290,7 @@ module softex_acc_datapath import softex_pkg::*; #(
         ) i_factor_cast (
             .clk_i              (   clk_i                               ),
             .rst_ni             (   rst_ni                              ),
-            .operands_i         (   {{ZEROPAD_MUL{1'b0}}, factor.value} ),
+            .operands_i         (   {{ZEROPAD_MUL{1'b0}}, factor_pre_cast}  ),
             .is_boxed_i         (   '1                                  ),
             .rnd_mode_i         (   fpnew_pkg::RNE                      ),
             .op_i               (   fpnew_pkg::F2F                      ),
@@ -293,11 +315,13 @@ module softex_acc_datapath import softex_pkg::*; #(
             .busy_o             (                                       )
         );
     end else begin : assign_factor
-        assign fma_factor = factor.value;
+        assign fma_factor = factor_pre_cast;
     end
 
     always_comb begin : fma_op_selection
-        unique casex ({ctrl_i.inv_fma, ctrl_i.inverting, fma_o_valid, factor_match, addend_match})
+        if (ctrl_i.logging) begin
+            fma_operation = log_operation;
+        end else unique casex ({ctrl_i.inv_fma, ctrl_i.inverting, fma_o_valid, factor_match, addend_match})
             5'b?00??:   fma_operation = fpnew_pkg::ADD;
             5'b?0100:   fma_operation = fpnew_pkg::ADD;
             5'b?0110:   fma_operation = fpnew_pkg::MUL;
@@ -310,9 +334,9 @@ module softex_acc_datapath import softex_pkg::*; #(
         endcase
     end
 
-    assign fma_i_valid  = (ctrl_i.reducing ? (~addend_empty & fma_o_valid) : (~addend_empty | (~factor_empty & fma_o_valid))) | ctrl_i.fma_inv_valid;
+    assign fma_i_valid  = (ctrl_i.reducing ? (~addend_empty & fma_o_valid) : (~addend_empty | (~factor_empty & fma_o_valid))) | ctrl_i.fma_inv_valid | ctrl_i.fma_log_valid;
     assign fma_i_tag    = factor_uses_cnt_enable ? (fma_o_tag + 1) : (fma_o_valid ? fma_o_tag : addend.tag);
-    assign fma_i_ready  = (ctrl_i.reducing | ctrl_i.inverting) ? fma_o_valid : (~addend_empty | (~factor_empty));
+    assign fma_i_ready  = (ctrl_i.reducing | ctrl_i.inverting | ctrl_i.logging) ? fma_o_valid : (~addend_empty | (~factor_empty));
 
     assign fma_addend_pre_cast = ((fma_o_valid & addend_match) ? addend.value : '0);
 
@@ -356,7 +380,9 @@ module softex_acc_datapath import softex_pkg::*; #(
     end
 
     always_comb begin
-        unique casex ({ctrl_i.inv_fma, ctrl_i.inverting, fma_o_valid})
+        if (ctrl_i.logging) begin
+            fma_operands = log_operands;
+        end else unique casex ({ctrl_i.inv_fma, ctrl_i.inverting, fma_o_valid})
             3'b?00:     fma_operands = {fma_addend, addend.value, fma_factor};
             3'b?01:     fma_operands = {fma_addend, fma_res, fma_factor};
 
@@ -425,6 +451,59 @@ module softex_acc_datapath import softex_pkg::*; #(
         .inv_o      (   inv_appr            )
     );
 
+    softex_acc_den_log #(
+        .FPFORMAT   (   ACC_FPFORMAT    )
+    ) i_denominator_log (
+        .den_i      (   den_q           ),
+        .mant_o     (   log_mant        ),
+        .exp_o      (   log_exp         )
+    );
+
+    // The reduced mantissa and the exponent are the results of the first two steps, kept for the following ones
+    always_ff @(posedge clk_i or negedge rst_ni) begin : log_registers
+        if (~rst_ni) begin
+            log_t_q <= '0;
+            log_e_q <= '0;
+        end else begin
+            if (clear_i) begin
+                log_t_q <= '0;
+                log_e_q <= '0;
+            end else if (ctrl_i.fma_log_valid) begin
+                if (ctrl_i.log_step == 1)
+                    log_t_q <= fma_res;
+
+                if (ctrl_i.log_step == 2)
+                    log_e_q <= fma_res;
+            end
+        end
+    end
+
+    // Operands of each step of the logarithm, see softex_acc_ctrl
+    always_comb begin : log_step_selection
+        if (ctrl_i.log_step == 0) begin
+            log_operation   = fpnew_pkg::ADD;
+            log_operands    = {ACC_NEG_ONE, log_mant, {ACC_WIDTH{1'b0}}};
+        end else if (ctrl_i.log_step == 1) begin
+            log_operation   = fpnew_pkg::ADD;
+            log_operands    = {LOG_NEG_EXP_OFFS, log_exp, {ACC_WIDTH{1'b0}}};
+        end else if (ctrl_i.log_step == 2) begin
+            log_operation   = fpnew_pkg::FMADD;
+            log_operands    = {LOG_COEFFS [N_LOG_COEFFS - 2], log_t_q, LOG_COEFFS [N_LOG_COEFFS - 1]};
+        end else if (ctrl_i.log_step <= N_LOG_COEFFS) begin
+            log_operation   = fpnew_pkg::FMADD;
+            log_operands    = {LOG_COEFFS [N_LOG_COEFFS - ctrl_i.log_step], log_t_q, fma_res};
+        end else if (ctrl_i.log_step == N_LOG_COEFFS + 1) begin
+            log_operation   = fpnew_pkg::MUL;
+            log_operands    = {{ACC_WIDTH{1'b0}}, log_t_q, fma_res};
+        end else if (ctrl_i.log_step == N_LOG_COEFFS + 2) begin
+            log_operation   = fpnew_pkg::FMADD;
+            log_operands    = {fma_res, LOG_LN2, log_e_q};
+        end else begin
+            log_operation   = fpnew_pkg::ADD;
+            log_operands    = {fma_factor, fma_res, {ACC_WIDTH{1'b0}}};
+        end
+    end
+
     assign flags_o.addend_valid         = add_valid_i;
     assign flags_o.addend_empty         = addend_empty;
     assign flags_o.factor_empty         = factor_empty;
@@ -0,0 +1,43 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+`include "../softex_macros.svh"
+
+
+module softex_acc_den_log import softex_pkg::*; #(
+    parameter fpnew_pkg::fp_format_e    FPFORMAT    = FPFORMAT_ACC  ,
+
+    localparam int unsigned WIDTH   = fpnew_pkg::fp_width(FPFORMAT)
+) (
+    input   logic [WIDTH - 1 : 0]   den_i   ,
+    output  logic [WIDTH - 1 : 0]   mant_o  ,
+    output  logic [WIDTH - 1 : 0]   exp_o
+);
+
+    localparam int unsigned MANTISSA_BITS   = fpnew_pkg::man_bits(FPFORMAT);
+    localparam int unsigned EXPONENT_BITS   = fpnew_pkg::exp_bits(FPFORMAT);
+    localparam int unsigned BIAS            = fpnew_pkg::bias(FPFORMAT);
+
+    logic [EXPONENT_BITS - 1 : 0]   exponent;
+    logic [MANTISSA_BITS - 1 : 0]   mantissa;
+
+    logic   halve;
+
+    /*  This module splits the denominator for the logarithm computed by the accumulator FMA:          *
+     *  den = 2^e * m with m in [sqrt(2)/2, sqrt(2)), so that ln(den) = e * ln(2) + ln(1 + (m - 1)).    *
+     *  "mant_o" is m itself, "exp_o" is 2^MANTISSA_BITS + LOG_EXP_OFFS + e, from which the FMA         *
+     *  recovers e exactly with a subtraction.                                                          */
+
+    assign mantissa = den_i [`MANTISSA(FPFORMAT)];
+    assign exponent = den_i [`EXPONENT(FPFORMAT)];
+
+    assign halve    = mantissa >= LOG_SQRT2_MANT [MANTISSA_BITS - 1 : 0];
+
+    assign mant_o   = {1'b0, halve ? EXPONENT_BITS'(BIAS - 1) : EXPONENT_BITS'(BIAS), mantissa};
+    assign exp_o    = {1'b0, EXPONENT_BITS'(BIAS + MANTISSA_BITS), MANTISSA_BITS'(LOG_EXP_OFFS + exponent - BIAS + halve)};
+
+endmodule
@@ -28,6 +28,7 @@ module softex_acc_top import softex_pkg::*; #(
     input   logic [ADD_WIDTH - 1 : 0]       add_i       ,
     input   logic                           mul_valid_i ,
     input   logic [MUL_WIDTH - 1 : 0]       mul_i       ,
+    input   logic [MUL_WIDTH - 1 : 0]       max_i       ,
     output  logic                           ready_o     ,
     output  logic                           valid_o     ,
     output  softex_pkg::accumulator_flags_t flags_o     ,
@@ -66,6 +67,7 @@ module softex_acc_top import softex_pkg::*; #(
         .add_i          (   add_i           ),
         .mul_valid_i    (   mul_valid_i     ),
         .mul_i          (   mul_i           ),
+        .max_i          (   max_i           ),
         .ready_o        (   ready_o         ),
         .valid_o        (   valid_o         ),
         .flags_o        (   datapath_flags  ),
@@ -31,6 +31,7 @@ import fpnew_pkg::*;
     input   logic                       rst_ni      ,
     input   logic                       clear_i     ,
     input   logic [NUM_REGS - 1 : 0]    enable_i    ,
+    input   softex_pkg::expu_ctrl_t     ctrl_i      ,
     input   logic [WIDTH - 1 : 0]       op_i        ,
     output  logic [WIDTH - 1 : 0]       res_o            
 );
@@ -98,8 +99,9 @@ import fpnew_pkg::*;
         .A_FRACTION     (   A_FRACTION      ),
         .ENABLE_ROUNDING(   ENABLE_ROUNDING )
     ) expu_schraudolph (
-        .op_i   (   op_before   ),
-        .res_o  (   res_sch     )  
+        .op_i   (   op_before       ),
+        .round_i(   ctrl_i.rounding ),
+        .res_o  (   res_sch         )  
     );
 
     generate
@@ -119,7 +121,8 @@ import fpnew_pkg::*;
                 .res_o  (   res_cor )   
             );
 
-            assign result   = res_cor;
+            // The correction can be skipped per job. It is combinational, so the latency of the unit does not change
+            assign result   = ctrl_i.correction ? res_cor : res_sch;
         end else begin
             assign result   = res_sch;
         end
@@ -17,6 +17,7 @@ import fpnew_pkg::*;
     localparam int unsigned WIDTH   = fpnew_pkg::fp_width(FPFORMAT)
 ) (
     input   logic [WIDTH - 1 : 0]   op_i    ,
+    input   logic                   round_i ,
     output  logic [WIDTH - 1 : 0]   res_o                
 );
 
@@ -56,7 +57,7 @@ import fpnew_pkg::*;
 
     assign scaled_mantissa  =   (mantissa * A);
     assign shifted_mantissa =   (scaled_mantissa [MANTISSA_BITS + A_FRACTION + A_INT_BITS : A_FRACTION - MANTISSA_BITS] >> (MAX_EXP - exponent));
-    assign rounded_mantissa =   shifted_mantissa [EXPONENT_BITS + MANTISSA_BITS : 1] + (ENABLE_ROUNDING ? shifted_mantissa [0] : '0);
+    assign rounded_mantissa =   shifted_mantissa [EXPONENT_BITS + MANTISSA_BITS : 1] + (ENABLE_ROUNDING & round_i ? shifted_mantissa [0] : '0);
     assign signed_mantissa  =   sign == 1'b0 ? rounded_mantissa : -rounded_mantissa;
 
     assign ovfr =   (exponent > MAX_EXP) || (
@@ -33,6 +33,7 @@ import fpnew_pkg::*;
     input   logic                                   rst_ni      ,
     input   logic                                   clear_i     ,
     input   logic                                   enable_i    ,
+    input   softex_pkg::expu_ctrl_t                 ctrl_i      ,
     input   logic                                   valid_i     ,
     input   logic                                   ready_i     ,
     input   logic [N_ROWS - 1 : 0]                  strb_i      ,
@@ -88,6 +89,7 @@ import fpnew_pkg::*;
                 .rst_ni     (   rst_ni          ),
                 .clear_i    (   clear_i         ),
                 .enable_i   (   row_enable  [i] ),
+                .ctrl_i     (   ctrl_i          ),
                 .op_i       (   op_i        [i] ),
                 .res_o      (   res_o       [i] )
             );
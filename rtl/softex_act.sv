@@ -0,0 +1,199 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+`include "softex_macros.svh"
+
+module softex_act
+import hwpe_stream_package::*;
+import softex_pkg::*;
+#(
+    parameter fpnew_pkg::fp_format_e    FPFORMAT    = FPFORMAT_IN       ,
+    parameter softex_pkg::regs_config_t REG_POS     = DEFAULT_REG_POS   ,
+    parameter int unsigned              NUM_REGS    = 0                 ,
+    parameter int unsigned              VECT_WIDTH  = 1                 ,
+    parameter int unsigned              FIFO_DEPTH  = 8                 ,   // Beats between the exponential and this stage, must be a multiple of 2
+
+    localparam int unsigned WIDTH   = fpnew_pkg::fp_width(FPFORMAT)
+) (
+    input   logic                                       clk_i       ,
+    input   logic                                       rst_ni      ,
+    input   logic                                       clear_i     ,
+    input   logic [2 : 0]                               act_i       ,
+    output  logic                                       busy_o      ,
+
+    input   logic                                       z_valid_i   ,
+    output  logic                                       z_ready_o   ,
+    input   logic [VECT_WIDTH - 1 : 0] [WIDTH - 1 : 0]  z_i         ,
+
+    input   logic                                       valid_i     ,
+    output  logic                                       ready_o     ,
+    input   logic [VECT_WIDTH - 1 : 0]                  strb_i      ,
+    input   logic [VECT_WIDTH - 1 : 0] [WIDTH - 1 : 0]  data_i      ,
+
+    output  logic                                       valid_o     ,
+    input   logic                                       ready_i     ,
+    output  logic [VECT_WIDTH - 1 : 0]                  strb_o      ,
+    output  logic [VECT_WIDTH - 1 : 0] [WIDTH - 1 : 0]  res_o
+);
+
+    /*  Last stage of the elementwise activations. The datapath computes z = k * x in the pre-scale, t = exp(z)     *
+     *  and d = t + 1 in the MUL phase of "i_addmul_time_mux"; "z" is kept in a FIFO while its exponential is in    *
+     *  flight. A lookup table on the mantissa of "d" gives r = c / d, rounded to the format, and a multiplier       *
+     *  emits y = a * b:                                                                                              *
+     *                                                                                                                *
+     *      ACT_EXP         k = SCALE (1 by default)    y = 1 * t                                                     *
+     *      ACT_SIGMOID     k = -1                      y = 1 * (1 / d)                                               *
+     *      ACT_SILU        k = -1                      y = z * -(1 / d)                                              *
+     *      ACT_GELU        k = -1.703125               y = z * -((64 / 109) / d)                                     *
+     *                                                                                                                *
+     *  Since 64 / 109 = 1 / 1.703125, the last two are x / (1 + exp(-k' x)), GELU being approximated by its sigmoid  *
+     *  form. As d >= 1 the table never overflows, the reciprocals below the normal range are flushed to zero.       */
+
+    localparam int unsigned EXP_BITS    = fpnew_pkg::exp_bits(FPFORMAT);
+    localparam int unsigned MAN_BITS    = fpnew_pkg::man_bits(FPFORMAT);
+    localparam int unsigned BIAS        = 2 ** (EXP_BITS - 1) - 1;
+
+    localparam logic [WIDTH - 1 : 0]    ONE = {2'b00, {(EXP_BITS - 1){1'b1}}, {(MAN_BITS){1'b0}}};
+    localparam logic [WIDTH - 1 : 0]    NAN = {1'b0, {(EXP_BITS){1'b1}}, 1'b1, {(MAN_BITS - 1){1'b0}}};
+
+    // Each entry holds the extra right shift of the exponent and the mantissa of num / (den * 1.m)
+    typedef logic [MAN_BITS + 1 : 0]                    lut_entry_t;
+    typedef lut_entry_t [2 ** MAN_BITS - 1 : 0]         lut_t;
+
+    function automatic lut_t recip_lut(longint unsigned num, longint unsigned den);
+        lut_t               lut;
+        longint unsigned    m,
+                            q;
+        int unsigned        sh;
+
+        for (int unsigned i = 0; i < 2 ** MAN_BITS; i++) begin
+            m   = 2 ** MAN_BITS + i;
+            sh  = 0;
+
+            while (num * 2 ** (MAN_BITS + sh) < den * m) begin
+                sh++;
+            end
+
+            q = (2 * num * 2 ** (2 * MAN_BITS + sh) / (den * m) + 1) / 2;
+
+            // Rounded up to the next power of two
+            if (q == 2 ** (MAN_BITS + 1)) begin
+                q   = 2 ** MAN_BITS;
+                sh  = sh - 1;
+            end
+
+            lut [i] = {2'(sh), MAN_BITS'(q)};
+        end
+
+        return lut;
+    endfunction
+
+    localparam lut_t    SIGMOID_LUT = recip_lut(1, 1);
+    localparam lut_t    GELU_LUT    = recip_lut(64, 109);
+
+    logic   gelu,
+            neg_z;
+
+    logic [VECT_WIDTH - 1 : 0] [WIDTH - 1 : 0]  recip;
+
+    logic [VECT_WIDTH - 1 : 0] [2 : 0] [WIDTH - 1 : 0]  fma_operands;
+    logic [VECT_WIDTH - 1 : 0]                          fma_valids,
+                                                        fma_readies,
+                                                        busy;
+
+    logic   fma_i_valid;
+
+    hwpe_stream_intf_stream #(.DATA_WIDTH(WIDTH * VECT_WIDTH))  z_fifo_d    (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH(WIDTH * VECT_WIDTH))  z_fifo_q    (.clk(clk_i));
+
+    assign gelu     = act_i == ACT_GELU;
+    assign neg_z    = act_i inside {ACT_SILU, ACT_GELU};
+
+    assign z_fifo_d.valid   = z_valid_i;
+    assign z_fifo_d.data    = z_i;
+    assign z_fifo_d.strb    = '1;
+
+    assign z_ready_o        = z_fifo_d.ready;
+
+    hwpe_stream_fifo #(
+        .DATA_WIDTH (   WIDTH * VECT_WIDTH  ),
+        .FIFO_DEPTH (   FIFO_DEPTH          )
+    ) i_z_fifo (
+        .clk_i      (   clk_i       ),
+        .rst_ni     (   rst_ni      ),
+        .clear_i    (   clear_i     ),
+        .flags_o    (               ),
+        .push_i     (   z_fifo_d    ),
+        .pop_o      (   z_fifo_q    )
+    );
+
+    // The lanes share the handshake of the first one, as in softex_fp_vect_addmul
+    assign fma_i_valid      = valid_i & z_fifo_q.valid;
+    assign ready_o          = fma_readies [0] & z_fifo_q.valid;
+    assign z_fifo_q.ready   = fma_readies [0] & valid_i;
+
+    for (genvar i = 0; i < VECT_WIDTH; i++) begin : gen_act_lanes
+        logic [EXP_BITS - 1 : 0]    d_exp;
+        logic [MAN_BITS - 1 : 0]    d_man;
+        lut_entry_t                 entry;
+        logic signed [EXP_BITS + 1 : 0] r_exp;
+
+        assign d_exp    = data_i [i][`EXPONENT(FPFORMAT)];
+        assign d_man    = data_i [i][`MANTISSA(FPFORMAT)];
+        assign entry    = gelu ? GELU_LUT [d_man] : SIGMOID_LUT [d_man];
+        assign r_exp    = $signed((EXP_BITS + 2)'(2 * BIAS)) - $signed({2'b00, d_exp}) - $signed({{(EXP_BITS){1'b0}}, entry [MAN_BITS +: 2]});
+
+        always_comb begin : reciprocal
+            if (d_exp == '1) begin
+                recip [i] = d_man != '0 ? NAN : {neg_z, {(WIDTH - 1){1'b0}}};
+            end else if (r_exp <= 0) begin
+                recip [i] = {neg_z, {(WIDTH - 1){1'b0}}};
+            end else begin
+                recip [i] = {neg_z, r_exp [EXP_BITS - 1 : 0], entry [MAN_BITS - 1 : 0]};
+            end
+        end
+
+        assign fma_operands [i][0] = neg_z ? z_fifo_q.data [WIDTH * i +: WIDTH] : ONE;
+        assign fma_operands [i][1] = act_i == ACT_EXP ? data_i [i] : recip [i];
+        assign fma_operands [i][2] = '0;
+
+        fpnew_fma #(
+            .FpFormat       (   FPFORMAT                                    ),
+            .NumPipeRegs    (   NUM_REGS                                    ),
+            .PipeConfig     (   softex_pkg::softex_to_cvfpu(REG_POS)        ),
+            .TagType        (   logic                                       ),
+            .AuxType        (   logic                                       )
+        ) i_act_mul (
+            .clk_i              (   clk_i               ),
+            .rst_ni             (   rst_ni              ),
+            .operands_i         (   fma_operands [i]    ),
+            .is_boxed_i         (   '1                  ),
+            .rnd_mode_i         (   fpnew_pkg::RNE      ),
+            .op_i               (   fpnew_pkg::MUL      ),
+            .op_mod_i           (   '0                  ),
+            .tag_i              (   '0                  ),
+            .mask_i             (   strb_i [i]          ),
+            .aux_i              (   '0                  ),
+            .in_valid_i         (   fma_i_valid         ),
+            .in_ready_o         (   fma_readies [i]     ),
+            .flush_i            (   clear_i             ),
+            .result_o           (   res_o [i]           ),
+            .status_o           (                       ),
+            .extension_bit_o    (                       ),
+            .tag_o              (                       ),
+            .mask_o             (   strb_o [i]          ),
+            .aux_o              (                       ),
+            .out_valid_o        (   fma_valids [i]      ),
+            .out_ready_i        (   ready_i             ),
+            .busy_o             (   busy [i]            )
+        );
+    end
+
+    assign valid_o  = fma_valids [0];
+    assign busy_o   = |busy | z_fifo_q.valid;
+
+endmodule
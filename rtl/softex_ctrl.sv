@@ -19,25 +19,45 @@ import softex_pkg::*;
     parameter int unsigned              DATA_WIDTH      = DATA_W - 32           ,
     parameter int unsigned              INT_WIDTH       = INT_W                 ,
     parameter fpnew_pkg::fp_format_e    IN_FPFORMAT     = FPFORMAT_IN           ,
-    parameter fpnew_pkg::fp_format_e    ACC_FPFORMAT    = FPFORMAT_ACC          
+    parameter fpnew_pkg::fp_format_e    ACC_FPFORMAT    = FPFORMAT_ACC          ,
+    parameter bit                       DUAL_ROW        = DUAL_ROW_LANE
 ) (
     input   logic                           clk_i               ,
     input   logic                           rst_ni              ,
     input   logic                           enable_i            ,
     input   hci_streamer_flags_t            in_stream_flags_i   ,
     input   hci_streamer_flags_t            out_stream_flags_i  ,
+    input   hci_streamer_flags_t            slot_in_flags_i     ,
+    input   hci_streamer_flags_t            slot_out_flags_i    ,
+    input   hci_streamer_flags_t            desc_flags_i        ,
+    input   hci_streamer_flags_t            stats_flags_i       ,
+    input   softex_pkg::streamer_perf_t     streamer_perf_i     ,
     input   softex_pkg::datapath_flags_t    datapath_flgs_i     ,
     input   softex_pkg::slot_t              state_slot_i        ,
+    input   softex_pkg::slot_regfile_flags_t slot_flags_i       ,
+    input   softex_pkg::row_buf_flags_t     row_buf_flags_i     ,
+    input   softex_pkg::merge_flags_t       merge_flags_i       ,
+    input   softex_pkg::sparse_flags_t      sparse_flags_i      ,
     output  logic                           clear_o             ,
     output  logic                           busy_o              ,
     output  logic [N_CORES - 1 : 0] [1 : 0] evt_o               ,
     output  hci_streamer_ctrl_t             in_stream_ctrl_o    ,
     output  hci_streamer_ctrl_t             out_stream_ctrl_o   ,
+    output  hci_streamer_ctrl_t             desc_ctrl_o         ,
+    output  hci_streamer_ctrl_t             stats_ctrl_o        ,
     output  softex_pkg::datapath_ctrl_t     datapath_ctrl_o     ,
     output  softex_pkg::slot_regfile_ctrl_t slot_ctrl_o         ,
+    output  softex_pkg::row_buf_ctrl_t      row_buf_ctrl_o      ,
+    output  softex_pkg::merge_ctrl_t        merge_ctrl_o        ,
+    output  softex_pkg::topk_ctrl_t         topk_ctrl_o         ,
+    output  softex_pkg::sparse_ctrl_t       sparse_ctrl_o       ,
     output  softex_pkg::cast_ctrl_t         in_cast_ctrl_o      ,
     output  softex_pkg::cast_ctrl_t         out_cast_ctrl_o     ,
 
+    hwpe_stream_intf_stream.sink            desc_i              ,
+    hwpe_stream_intf_stream.source          stats_o             ,
+    hwpe_stream_intf_stream.sink            topk_i              ,
+
     hwpe_ctrl_intf_periph.slave             periph
 );
 
@@ -47,6 +67,15 @@ import softex_pkg::*;
     // The number of bits read when the input is integer
     localparam int unsigned DATA_WIDTH_INT  = INT_WIDTH * DATA_WIDTH / IN_WIDTH > DATA_WIDTH ? DATA_WIDTH : INT_WIDTH * DATA_WIDTH / IN_WIDTH;
 
+    // The number of bits read when the input is FP8
+    localparam int unsigned DATA_WIDTH_FP8  = 8 * DATA_WIDTH / IN_WIDTH;
+
+    // Pre-scale factors of the sigmoid-based activations, -1 and -1.703125
+    localparam int unsigned             IN_EXP_BITS     = fpnew_pkg::exp_bits(IN_FPFORMAT);
+    localparam int unsigned             IN_MAN_BITS     = fpnew_pkg::man_bits(IN_FPFORMAT);
+    localparam logic [IN_WIDTH - 1 : 0] ACT_SCALE_NEG   = {2'b10, {(IN_EXP_BITS - 1){1'b1}}, {(IN_MAN_BITS){1'b0}}};
+    localparam logic [IN_WIDTH - 1 : 0] ACT_SCALE_GELU  = {2'b10, {(IN_EXP_BITS - 1){1'b1}}, 7'b1011010, {(IN_MAN_BITS - 7){1'b0}}};
+
     typedef enum logic [2:0] {
         IDLE,
         WAIT_SLOT_VALID,
@@ -68,7 +97,8 @@ import softex_pkg::*;
                 next_state;
 
     logic   in_start,
-            out_start;
+            out_start,
+            rb_replay;
 
     logic   dp_acc_finished,
             dp_dividing,
@@ -80,7 +110,99 @@ import softex_pkg::*;
     logic   clear,
             clear_regs;
 
-    logic   slave_done;
+    logic   slave_done,
+            job_done;
+
+    job_params_t    job,
+                    reg_job,
+                    desc_job,
+                    desc_next_job;
+
+    logic   desc_mode,
+            desc_start,
+            desc_active,
+            desc_job_valid,
+            desc_next_valid,
+            desc_job_ack,
+            desc_last,
+            desc_evt;
+
+    logic   desc_slot_req_valid,
+            periph_slot_req,
+            periph_prefetch_req;
+
+    slot_req_op_t   desc_slot_req_op;
+
+    logic [31 : 0]  row_cnt_q,
+                    in_row_offs_q,
+                    out_row_offs_q;
+
+    logic   row_pending,
+            more_rows,
+            next_row;
+
+    logic   launch_ahead,
+            row_ahead,
+            job_ahead,
+            job_ahead_ok,
+            job_ahead_q,
+            ahead_dispatch,
+            launched_q,
+            early_done_q;
+
+    logic [31 : 0]  ahead_in_addr_q;
+
+    logic [31 : 0]  in_beats_left_q;
+
+    logic [31 : 0]  accuracy;
+    logic [1 : 0]   newton_skip;
+
+    logic [1 : 0]   out_mode;
+    logic           log_mode,
+                    lse_mode;
+
+    logic   dual_row,
+            norm_handover,
+            lane_busy_q;
+
+    logic   stats_out,
+            stats_start,
+            stats_pending_q,
+            stats_valid_q,
+            merging;
+
+    logic [IN_WIDTH - 1 : 0]    stats_max_q;
+    logic [ACC_WIDTH - 1 : 0]   stats_den_q;
+
+    logic [3 : 0]   topk_k;
+    logic           topk_enable,
+                    topk_start,
+                    topk_sel_q,
+                    topk_written_q;
+
+    logic           sparse_enable,
+                    sparse_start,
+                    sparse_sel_q,
+                    sparse_written_q;
+
+    logic [2 : 0]   act_mode;
+    logic           act_enable;
+
+    logic   cpl_enable,
+            cpl_start,
+            cpl_sel_q,
+            cpl_written_q,
+            cpl_evt,
+            evt_fire,
+            done_evt,
+            last_row;
+
+    logic [31 : 0]  cpl_idx_q,
+                    cpl_status_q,
+                    cpl_cycles_q,
+                    job_id_q,
+                    job_cycles_q,
+                    evt_cnt_q;
 
     logic   acc_only,
             div_only,
@@ -99,16 +221,43 @@ import softex_pkg::*;
 
     logic [16 : 0]   current_slot;
 
-    logic [$clog2(DATA_WIDTH / 8) - 1 : 0]  length_lftovr,
-                                            int_length_lftovr;
+    logic   in_fp8,
+            out_fp8;
+
+    logic [31 : 0]  n_elements,
+                    out_len;
+
+    logic   perf_sel,
+            perf_r_valid;
 
-    logic   lftovr_inc,
-            int_lftovr_inc;
+    logic [PERF_CNT_W - 1 : 0]  perf_r_data,
+                                perf_cnt;
+
+    logic [ID_WIDTH - 1 : 0]    perf_r_id;
+
+    logic [N_PERF_CNT - 1 : 0] [PERF_CNT_W - 1 : 0] perf_inc;
 
     hwpe_ctrl_package::ctrl_regfile_t   reg_file;
     hwpe_ctrl_package::ctrl_slave_t     ctrl_slave;
     hwpe_ctrl_package::flags_slave_t    flgs_slave;
 
+    hwpe_ctrl_intf_periph #(.ID_WIDTH(ID_WIDTH)) slave_periph (.clk(clk_i));
+
+    // Accesses to the performance counters are served here, everything else goes to the slave
+    assign perf_sel             = periph.add [$clog2(PERF_CNT_OFFS)];
+
+    assign slave_periph.req     = periph.req & ~perf_sel;
+    assign slave_periph.add     = periph.add;
+    assign slave_periph.wen     = periph.wen;
+    assign slave_periph.be      = periph.be;
+    assign slave_periph.data    = periph.data;
+    assign slave_periph.id      = periph.id;
+
+    assign periph.gnt           = perf_sel ? periph.req : slave_periph.gnt;
+    assign periph.r_data        = perf_r_valid ? perf_r_data : slave_periph.r_data;
+    assign periph.r_valid       = perf_r_valid | slave_periph.r_valid;
+    assign periph.r_id          = perf_r_valid ? perf_r_id : slave_periph.r_id;
+
     hwpe_ctrl_slave  #(
         .REGFILE_SCM    (   CTRL_REGFILE_SCM    ),
         .N_CORES        (   N_CORES             ),
@@ -120,7 +269,7 @@ import softex_pkg::*;
         .clk_i      (   clk_i       ),
         .rst_ni     (   rst_ni      ),
         .clear_o    (   clear       ),
-        .cfg        (   periph      ),
+        .cfg        (   slave_periph),
         .ctrl_i     (   ctrl_slave  ),
         .flags_o    (   flgs_slave  ),
         .reg_file   (   reg_file    )
@@ -151,31 +300,158 @@ import softex_pkg::*;
         end
     end
 
-    assign length_lftovr        = reg_file.hwpe_params [TOT_LEN] [$clog2(DATA_WIDTH / 8) - 1 : 0];
+    // When a descriptor ring is running the job parameters come from the current descriptor instead of the register file
+    assign reg_job.in_addr      = reg_file.hwpe_params [IN_ADDR];
+    assign reg_job.out_addr     = reg_file.hwpe_params [OUT_ADDR];
+    assign reg_job.tot_len      = reg_file.hwpe_params [TOT_LEN];
+    assign reg_job.commands     = reg_file.hwpe_params [COMMANDS];
+    assign reg_job.cast_ctrl    = reg_file.hwpe_params [CAST_CTRL];
+    assign reg_job.rows             = reg_file.hwpe_params [ROWS];
+    assign reg_job.in_row_stride    = reg_file.hwpe_params [IN_ROW_STRIDE];
+    assign reg_job.out_row_stride   = reg_file.hwpe_params [OUT_ROW_STRIDE];
+
+    assign job                  = desc_active ? desc_job : reg_job;
+
+    /*  In strided mode (ROWS > 1) a single job computes an independent softmax on each row of a tile. Once a row   *
+     *  is finished the datapath registers are cleared and the next row is dispatched as if it were a new job.      */
+    always_ff @(posedge clk_i or negedge rst_ni) begin : row_counter
+        if (~rst_ni) begin
+            row_cnt_q       <= '0;
+            in_row_offs_q   <= '0;
+            out_row_offs_q  <= '0;
+        end else begin
+            if (clear) begin
+                row_cnt_q       <= '0;
+                in_row_offs_q   <= '0;
+                out_row_offs_q  <= '0;
+            end else if (next_row) begin
+                row_cnt_q       <= row_cnt_q + 1;
+                in_row_offs_q   <= in_row_offs_q + job.in_row_stride;
+                out_row_offs_q  <= out_row_offs_q + job.out_row_stride;
+            end else if (job_done) begin
+                row_cnt_q       <= '0;
+                in_row_offs_q   <= '0;
+                out_row_offs_q  <= '0;
+            end
+        end
+    end
 
-    // If the total length of the vector is not a multiple of the data width we need to increse the number of loads / stores by one
-    assign lftovr_inc           = length_lftovr != '0;
+    assign row_pending          = row_cnt_q != '0;
+    assign more_rows            = (row_cnt_q + 1) < job.rows;
+    assign last_row             = ~more_rows | acc_only | div_only;
+
+    /*  The input of the next row is fetched as soon as every input beat of the current row has entered the      *
+     *  accelerator, while the normalisation is still draining. Those beats are held at the row buffer until the  *
+     *  row is dispatched, which then does not pay for the memory latency nor for a pass through IDLE.            *
+     *  The next row is either the following one of a strided job or, in a descriptor ring, the first row of the  *
+     *  prefetched descriptor once the current one is on its last row. The descriptor must share the commands,   *
+     *  the formats and the length of the current job, so that only the input address of the stream changes, and  *
+     *  the job must not be dual-row, whose lane still owns the output when the next job is dispatched.           *
+     *  Jobs queued in the control slave are not launched ahead: it exposes the registers of the running context  *
+     *  only. Partial (ACC_ONLY/DIV_ONLY) jobs have a single row, and activation rows go straight to DIVIDING,    *
+     *  which does not dispatch held beats, so neither is launched ahead.                                         */
+    assign row_ahead            = ((current_state == DIVIDING) | (dual_row & (current_state inside {WAIT_DATAPATH_EMPTY, WAIT_ACCUMULATION, WAIT_INVERSION}))) &
+                                  ~launched_q & more_rows & ~(acc_only | div_only) & ~act_enable & (in_beats_left_q == '0) & in_stream_flags_i.ready_start;
+
+    assign job_ahead_ok         = desc_active & ~desc_last & desc_next_valid & (desc_next_job.commands [15 : 0] == job.commands [15 : 0]) &
+                                  (desc_next_job.cast_ctrl == job.cast_ctrl) & (desc_next_job.tot_len == job.tot_len);
+
+    assign job_ahead            = (current_state == DIVIDING) & ~dual_row & job_ahead_ok &
+                                  ~launched_q & ~more_rows & ~(acc_only | div_only) & ~act_enable & (in_beats_left_q == '0) & in_stream_flags_i.ready_start;
+
+    assign launch_ahead         = row_ahead | job_ahead;
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : launch_register
+        if (~rst_ni) begin
+            launched_q      <= '0;
+            job_ahead_q     <= '0;
+            ahead_in_addr_q <= '0;
+            early_done_q    <= '0;
+            in_beats_left_q <= '0;
+        end else begin
+            if (clear) begin
+                launched_q      <= '0;
+                job_ahead_q     <= '0;
+                ahead_in_addr_q <= '0;
+                early_done_q    <= '0;
+                in_beats_left_q <= '0;
+            end else begin
+                if (in_start) begin
+                    in_beats_left_q <= in_stream_ctrl_o.addressgen_ctrl.tot_len;
+                end else if (streamer_perf_i.in_beat & (in_beats_left_q != '0)) begin
+                    in_beats_left_q <= in_beats_left_q - 1;
+                end
+
+                if (launch_ahead) begin
+                    launched_q  <= '1;
+                end else if (next_row | ahead_dispatch) begin
+                    launched_q  <= '0;
+                end
+
+                if (job_ahead) begin
+                    job_ahead_q     <= '1;
+                    ahead_in_addr_q <= desc_next_job.in_addr;
+                end else if (ahead_dispatch) begin
+                    job_ahead_q     <= '0;
+                end
+
+                // The stream of a row launched ahead may end before the row is dispatched
+                if (current_state == ACCUMULATION) begin
+                    early_done_q    <= '0;
+                end else if (launched_q & in_stream_flags_i.done) begin
+                    early_done_q    <= '1;
+                end
+            end
+        end
+    end
 
-    // Same as before but with integer inputs
-    assign int_length_lftovr    = reg_file.hwpe_params [TOT_LEN] [$clog2(DATA_WIDTH_INT / 8) - 1 : 0];
+    /*  With CMD_DUAL_ROW the normalisation of a row is handed over to the lane of the datapath, fed by the row    *
+     *  buffer, and the accumulation of the next row starts right away. The rows must fit in the row buffer and    *
+     *  the lane has no pre-scale nor mask: otherwise the job runs in the sequential mode, as it does when a top-k *
+     *  is recorded or the output is sparse, which only observe the main path.                                    */
+    assign dual_row             = DUAL_ROW & job.commands [CMD_DUAL_ROW] & ~(acc_only | div_only) & ~merging & ~job.commands [CMD_SCALE] & ~job.commands [CMD_MASK] & ~log_mode & ~topk_enable & ~sparse_enable & ~act_enable &
+                                  (in_stream_ctrl_o.addressgen_ctrl.tot_len <= ROW_BUF_DEPTH);
 
-    assign int_lftovr_inc       = int_length_lftovr != '0;
+    // The lane owns the output stream until the row it normalises has been written
+    always_ff @(posedge clk_i or negedge rst_ni) begin : lane_register
+        if (~rst_ni) begin
+            lane_busy_q <= '0;
+        end else begin
+            if (clear) begin
+                lane_busy_q <= '0;
+            end else if (norm_handover) begin
+                lane_busy_q <= '1;
+            end else if (out_stream_flags_i.done) begin
+                lane_busy_q <= '0;
+            end
+        end
+    end
+
+    // If the total length of the vector is not a multiple of the data width we need to increse the number of loads / stores by one
+    function automatic logic [31 : 0] n_beats(logic [31 : 0] len, int unsigned beat_bytes);
+        return len / beat_bytes + (len % beat_bytes != 0);
+    endfunction
+
+    // TOT_LEN is expressed in bytes of the input format, the output can have a different element width
+    assign n_elements           = cast_input ? job.tot_len / (INT_WIDTH / 8) : (in_fp8 ? job.tot_len : job.tot_len / (IN_WIDTH / 8));
+    assign out_len              = cast_output ? n_elements * (INT_WIDTH / 8) : (out_fp8 ? n_elements : n_elements * (IN_WIDTH / 8));
 
     assign in_stream_ctrl_o.req_start                       = in_start;
-    assign in_stream_ctrl_o.addressgen_ctrl.base_addr       = reg_file.hwpe_params [IN_ADDR];
-    assign in_stream_ctrl_o.addressgen_ctrl.tot_len         = cast_input ? reg_file.hwpe_params [TOT_LEN] / (DATA_WIDTH_INT / 8) + int_length_lftovr : reg_file.hwpe_params [TOT_LEN] / (DATA_WIDTH / 8) + lftovr_inc;
-    assign in_stream_ctrl_o.addressgen_ctrl.d0_len          = reg_file.hwpe_params [TOT_LEN];   // Used by the strobe generator
-    assign in_stream_ctrl_o.addressgen_ctrl.d0_stride       = cast_input ? DATA_WIDTH_INT / 8 : DATA_WIDTH / 8;
+    assign in_stream_ctrl_o.addressgen_ctrl.base_addr       = job_ahead ? desc_next_job.in_addr : job_ahead_q ? ahead_in_addr_q :
+                                                              job.in_addr + in_row_offs_q + ((row_ahead | launched_q) ? job.in_row_stride : '0);
+    assign in_stream_ctrl_o.addressgen_ctrl.tot_len         = cast_input ? n_beats(job.tot_len, DATA_WIDTH_INT / 8) : (in_fp8 ? n_beats(job.tot_len, DATA_WIDTH_FP8 / 8) : n_beats(job.tot_len, DATA_WIDTH / 8));
+    assign in_stream_ctrl_o.addressgen_ctrl.d0_len          = job.tot_len;   // Used by the strobe generator
+    assign in_stream_ctrl_o.addressgen_ctrl.d0_stride       = cast_input ? DATA_WIDTH_INT / 8 : (in_fp8 ? DATA_WIDTH_FP8 / 8 : DATA_WIDTH / 8);
     assign in_stream_ctrl_o.addressgen_ctrl.d1_len          = '0;
     assign in_stream_ctrl_o.addressgen_ctrl.d1_stride       = '0;
     assign in_stream_ctrl_o.addressgen_ctrl.d2_stride       = '0;
     assign in_stream_ctrl_o.addressgen_ctrl.dim_enable_1h   = '0;
 
     assign out_stream_ctrl_o.req_start                      = out_start;
-    assign out_stream_ctrl_o.addressgen_ctrl.base_addr      = reg_file.hwpe_params [OUT_ADDR];
-    assign out_stream_ctrl_o.addressgen_ctrl.tot_len        = cast_output ? reg_file.hwpe_params [TOT_LEN] / (DATA_WIDTH_INT / 8) + int_length_lftovr : reg_file.hwpe_params [TOT_LEN] / (DATA_WIDTH / 8) + lftovr_inc;
-    assign out_stream_ctrl_o.addressgen_ctrl.d0_len         = reg_file.hwpe_params [TOT_LEN];   // Used by the strobe generator
-    assign out_stream_ctrl_o.addressgen_ctrl.d0_stride      = cast_output ? DATA_WIDTH_INT / 8 : DATA_WIDTH / 8;
+    assign out_stream_ctrl_o.addressgen_ctrl.base_addr      = job.out_addr + out_row_offs_q;
+    assign out_stream_ctrl_o.addressgen_ctrl.tot_len        = cast_output ? n_beats(out_len, DATA_WIDTH_INT / 8) : (out_fp8 ? n_beats(out_len, DATA_WIDTH_FP8 / 8) : n_beats(out_len, DATA_WIDTH / 8));
+    assign out_stream_ctrl_o.addressgen_ctrl.d0_len         = out_len;   // Used by the strobe generator
+    assign out_stream_ctrl_o.addressgen_ctrl.d0_stride      = cast_output ? DATA_WIDTH_INT / 8 : (out_fp8 ? DATA_WIDTH_FP8 / 8 : DATA_WIDTH / 8);
     assign out_stream_ctrl_o.addressgen_ctrl.d1_len         = '0;
     assign out_stream_ctrl_o.addressgen_ctrl.d1_stride      = '0;
     assign out_stream_ctrl_o.addressgen_ctrl.d2_stride      = '0;
@@ -190,55 +466,307 @@ import softex_pkg::*;
     assign datapath_ctrl_o.load_denominator                 = dp_load_denominator;
     assign datapath_ctrl_o.accumulator_ctrl.load_reciprocal = dp_load_reciprocal;
 
-    assign datapath_ctrl_o.max                              = state_slot_i.maximum;
-    assign datapath_ctrl_o.denominator                      = state_slot_i.denominator;
+    // The result of a merge is loaded into the datapath when it has to be inverted, an activation subtracts zero
+    assign datapath_ctrl_o.max                              = act_enable ? '0 : merging ? merge_flags_i.max : state_slot_i.maximum;
+    assign datapath_ctrl_o.denominator                      = merging ? merge_flags_i.denominator : state_slot_i.denominator;
+
+    // Pre-scale and masking of the input scores. With CMD_CAUSAL the valid length grows by one at each row.
+    // The activations based on the sigmoid take the pre-scale for their own factor and are never masked
+    assign datapath_ctrl_o.scale_enable                     = job.commands [CMD_SCALE] | (act_enable & (act_mode != ACT_EXP));
+    assign datapath_ctrl_o.scale                            = (~act_enable | (act_mode == ACT_EXP)) ? reg_file.hwpe_params [SCALE] [IN_WIDTH - 1 : 0] :
+                                                              act_mode == ACT_GELU ? ACT_SCALE_GELU : ACT_SCALE_NEG;
+    assign datapath_ctrl_o.mask_enable                      = job.commands [CMD_MASK] & ~act_enable;
+    assign datapath_ctrl_o.mask_restart                     = (in_start & ~launch_ahead) | rb_replay;
+    assign datapath_ctrl_o.valid_len                        = reg_file.hwpe_params [VALID_LEN] + (job.commands [CMD_CAUSAL] ? row_cnt_q : '0);
+    assign datapath_ctrl_o.norm_load                        = norm_handover;
+
+    // Accuracy knobs of the job. The skipped Newton-Raphson iterations saturate at N_NEWTON_ITERS
+    assign accuracy                                         = reg_file.hwpe_params [ACCURACY_CTRL];
+    assign newton_skip                                      = accuracy [ACCURACY_NEWTON +: 2];
+
+    assign datapath_ctrl_o.expu_ctrl.correction             = ~accuracy [ACCURACY_EXP_RAW];
+    assign datapath_ctrl_o.expu_ctrl.rounding               = ~accuracy [ACCURACY_EXP_TRUNC];
+    assign datapath_ctrl_o.accumulator_ctrl.newton_iters    = newton_skip >= N_NEWTON_ITERS ? '0 : N_NEWTON_ITERS - newton_skip;
     assign datapath_ctrl_o.accumulator_ctrl.reciprocal      = state_slot_i.denominator;
 
-    assign acc_only                                         = reg_file.hwpe_params [COMMANDS] [CMD_ACC_ONLY];       // We stop as soon as the denominator is valid, no inversion is performed
-    assign div_only                                         = reg_file.hwpe_params [COMMANDS] [CMD_DIV_ONLY];       // Only perform the normalisation step. The maximum and the denominator are recovered from the state slot
-    assign last                                             = reg_file.hwpe_params [COMMANDS] [CMD_LAST];           // We are performing the last partial accumulation / normalisation
-    assign set_cache_addr                                   = reg_file.hwpe_params [COMMANDS] [CMD_SET_CACHE_ADDR]; // Sets the base address of the state slot cache
-    assign acquire_slot                                     = reg_file.hwpe_params [COMMANDS] [CMD_ACQUIRE_SLOT];   // This is the first partial iteration of a new operation
-    assign no_operation                                     = reg_file.hwpe_params [COMMANDS] [CMD_NO_OP];          // No operation has to be performed; currently used to update the cache address without necessarily starting an operation 
-    assign cast_input                                       = reg_file.hwpe_params [COMMANDS] [CMD_INT_INPUT];      // Cast the input from fixed point to floating point
-    assign cast_output                                      = reg_file.hwpe_params [COMMANDS] [CMD_INT_OUTPUT];     // Cast the output from floating point to fixed point
-
-    assign current_slot                                     = reg_file.hwpe_params [COMMANDS] [31 -: 16];
-
-    assign in_cast_ctrl_o.int_bits                          = reg_file.hwpe_params [CAST_CTRL] [6 : 0];
-    assign in_cast_ctrl_o.is_signed                         = reg_file.hwpe_params [CAST_CTRL] [7];
+    /*  With OUT_MODE_LOG the accumulator computes ln(denominator) instead of the reciprocal and the normalisation   *
+     *  emits x - max - ln(denominator). With OUT_MODE_LSE it adds the maximum, the result is written in place of    *
+     *  the denominator of the row statistics and there is no normalisation. The slot of a partial job holds the     *
+     *  logarithm instead of the reciprocal, so all the jobs of a slot must use the same mode.                       */
+    assign out_mode                                         = reg_file.hwpe_params [OUT_CTRL][OUT_MODE +: 2];
+    assign log_mode                                         = (out_mode inside {OUT_MODE_LOG, OUT_MODE_LSE}) & ~act_enable;
+    assign lse_mode                                         = (out_mode == OUT_MODE_LSE) & ~act_enable;
+
+    assign datapath_ctrl_o.accumulator_ctrl.logarithm       = log_mode;
+    assign datapath_ctrl_o.accumulator_ctrl.add_max         = lse_mode;
+    assign datapath_ctrl_o.log_output                       = log_mode & dp_dividing;
+
+    /*  With a non-zero OUT_ACT the job is an elementwise activation instead of a softmax: there is no accumulation,  *
+     *  the input goes straight through the DIVIDING step with a zero maximum and softex_act in place of the         *
+     *  normalisation. It overrides OUT_MODE, takes neither a slot nor the row buffer and is never split, but can     *
+     *  be sparse or record a top-k. ACT_EXP is pre-scaled by SCALE with CMD_SCALE, the others by their constant.     */
+    assign act_mode                                         = reg_file.hwpe_params [OUT_CTRL][OUT_ACT +: 3];
+    assign act_enable                                       = (act_mode != ACT_NONE) & ~acc_only & ~div_only & ~merging;
+
+    assign datapath_ctrl_o.act                              = act_enable ? act_mode : 3'(ACT_NONE);
+
+    assign acc_only                                         = job.commands [CMD_ACC_ONLY];       // We stop as soon as the denominator is valid, no inversion is performed
+    assign div_only                                         = job.commands [CMD_DIV_ONLY];       // Only perform the normalisation step. The maximum and the denominator are recovered from the state slot
+    assign last                                             = job.commands [CMD_LAST];           // We are performing the last partial accumulation / normalisation
+    assign set_cache_addr                                   = job.commands [CMD_SET_CACHE_ADDR]; // Sets the base address of the state slot cache
+    assign acquire_slot                                     = job.commands [CMD_ACQUIRE_SLOT];   // This is the first partial iteration of a new operation
+    assign no_operation                                     = job.commands [CMD_NO_OP];          // No operation has to be performed; currently used to update the cache address without necessarily starting an operation 
+    assign cast_input                                       = job.commands [CMD_INT_INPUT];      // Cast the input from fixed point to floating point
+    assign cast_output                                      = job.commands [CMD_INT_OUTPUT];     // Cast the output from floating point to fixed point
+
+    assign stats_out                                        = job.commands [CMD_STATS_OUT];      // Write the row maximum and denominator to STATS_ADDR
+    assign merging                                          = job.commands [CMD_MERGE_STATS];    // The input is a list of saved statistics to be merged instead of a vector
+
+    assign current_slot                                     = job.commands [31 -: 16];
+
+    assign in_cast_ctrl_o.int_bits                          = job.cast_ctrl [6 : 0];
+    assign in_cast_ctrl_o.is_signed                         = job.cast_ctrl [7];
     assign in_cast_ctrl_o.enable                            = cast_input;
+    assign in_cast_ctrl_o.fp_fmt                            = io_fmt_e'(job.cast_ctrl [17 : 16]);
     
-    assign out_cast_ctrl_o.int_bits                         = reg_file.hwpe_params [CAST_CTRL] [14 : 8];
-    assign out_cast_ctrl_o.is_signed                        = reg_file.hwpe_params [CAST_CTRL] [15];
+    assign out_cast_ctrl_o.int_bits                         = job.cast_ctrl [14 : 8];
+    assign out_cast_ctrl_o.is_signed                        = job.cast_ctrl [15];
     assign out_cast_ctrl_o.enable                           = cast_output;    
+    assign out_cast_ctrl_o.fp_fmt                           = io_fmt_e'(job.cast_ctrl [19 : 18]);
+
+    assign in_fp8                                           = in_cast_ctrl_o.fp_fmt inside {FMT_FP8_E4M3, FMT_FP8_E5M2};
+    assign out_fp8                                          = out_cast_ctrl_o.fp_fmt inside {FMT_FP8_E4M3, FMT_FP8_E5M2};
+
+    assign desc_mode                                        = reg_file.hwpe_params [COMMANDS] [CMD_DESC_MODE];   // The job parameters are fetched from the descriptor ring
+
+    // With a descriptor ring the job is over only once the last descriptor has been executed
+    assign slave_done                                       = job_done & (~desc_active | desc_last);
 
     assign ctrl_slave.done                                  = slave_done;
     assign ctrl_slave.evt                                   = '0;
 
+    /*  The end of job event can be coalesced: with a period N in EVT_CTRL [31:16] only every N-th completed job    *
+     *  raises it. EVT_SKIP silences a job, EVT_MARK always raises the event and restarts the count.              */
+    assign evt_fire                                         = reg_file.hwpe_params [EVT_CTRL] [EVT_MARK] |
+                                                              (~reg_file.hwpe_params [EVT_CTRL] [EVT_SKIP] & ((evt_cnt_q + 1) >= reg_file.hwpe_params [EVT_CTRL] [31 : 16]));
+    assign done_evt                                         = slave_done & evt_fire;
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : job_counters
+        if (~rst_ni) begin
+            evt_cnt_q       <= '0;
+            job_id_q        <= '0;
+            job_cycles_q    <= '0;
+        end else begin
+            if (clear) begin
+                evt_cnt_q       <= '0;
+                job_id_q        <= '0;
+                job_cycles_q    <= '0;
+            end else begin
+                if (slave_done) begin
+                    evt_cnt_q   <= evt_fire ? '0 : evt_cnt_q + 1;
+                end
+
+                if (job_done) begin
+                    job_id_q        <= job_id_q + 1;
+                    job_cycles_q    <= '0;
+                end else if ((current_state != IDLE) | row_pending) begin
+                    job_cycles_q    <= job_cycles_q + 1;
+                end
+            end
+        end
+    end
+
+    // The row buffer records every accumulation step and replays it during the normalisation if the whole vector fitted
+    assign row_buf_ctrl_o.capture                           = (in_start & (next_state == ACCUMULATION)) | (next_row & launched_q) | ahead_dispatch;
+    assign row_buf_ctrl_o.replay                            = rb_replay;
+    assign row_buf_ctrl_o.hold                              = launched_q;
+    assign row_buf_ctrl_o.swap                              = norm_handover;
+
     assign slot_ctrl_o.cache_base_addr                      = slot_cache_base_addr;
     assign slot_ctrl_o.addr                                 = current_slot;
 
-    // "request" commands are pushed as soon a partial operation is detected  
-    assign slot_ctrl_o.req_valid                            = periph.req & periph.gnt & (periph.add [ID_WIDTH - 1 : 0] == (COMMANDS * 4 + 32)) & (periph.data [CMD_ACC_ONLY] | periph.data [CMD_DIV_ONLY]);
-    assign slot_ctrl_o.req_op.addr                          = periph.data [31 -: 16];
-    assign slot_ctrl_o.req_op.op                            = periph.data [CMD_ACQUIRE_SLOT] ? ALLOC : LOAD;
+    // "request" commands are pushed as soon a partial operation is detected. Only the low address bits are decoded, so
+    // reads and the performance counters, which alias the register offsets, are excluded
+    assign periph_slot_req                                  = periph.req & periph.gnt & ~perf_sel & ~periph.wen & (periph.add [ID_WIDTH - 1 : 0] == (COMMANDS * 4 + 32)) & (periph.data [CMD_ACC_ONLY] | periph.data [CMD_DIV_ONLY]) & ~periph.data [CMD_DESC_MODE];
+
+    // Writing a slot id to PREFETCH_SLOT brings that slot on chip ahead of the job that will use it. A prefetch is only
+    // a hint, it is dropped when the request FIFO has no room left beyond the one kept for the jobs
+    assign periph_prefetch_req                              = periph.req & periph.gnt & (periph.add [ID_WIDTH - 1 : 0] == (PREFETCH_SLOT * 4 + 32)) & ~perf_sel & ~periph.wen & slot_flags_i.prefetch_room;
+
+    // Requests coming from the descriptor fetcher are served when the core is not writing a command
+    assign slot_ctrl_o.req_valid                            = periph_slot_req | periph_prefetch_req | desc_slot_req_valid;
+    assign slot_ctrl_o.req_op.addr                          = periph_slot_req ? periph.data [31 -: 16] : periph_prefetch_req ? periph.data [15 : 0] : desc_slot_req_op.addr;
+    assign slot_ctrl_o.req_op.op                            = periph_slot_req ? (periph.data [CMD_ACQUIRE_SLOT] ? ALLOC : LOAD) : periph_prefetch_req ? PREFETCH : desc_slot_req_op.op;
 
 
     assign slot_ctrl_o.update_valid                         = state_slot_en;
     assign slot_ctrl_o.update_op.addr                       = current_slot;
-    assign slot_ctrl_o.update_op.op                         = last & div_only ? FREE : UPDATE;   
-    assign slot_ctrl_o.update_op.maximum                    = datapath_flgs_i.max;
-    assign slot_ctrl_o.update_op.denominator                = (acc_only & ~last) ? datapath_flgs_i.accumulator_flags.denominator : datapath_flgs_i.accumulator_flags.reciprocal;
+    assign slot_ctrl_o.update_op.op                         = last & (div_only | lse_mode) ? FREE : UPDATE;   // An LSE has no normalisation, the last accumulation frees the slot
+    assign slot_ctrl_o.update_op.maximum                    = (merging & ~last) ? merge_flags_i.max : datapath_flgs_i.max;
+    assign slot_ctrl_o.update_op.denominator                = (merging & ~last) ? merge_flags_i.denominator : (acc_only & ~last) ? datapath_flgs_i.accumulator_flags.denominator : datapath_flgs_i.accumulator_flags.reciprocal;
+
+    // A merge starts from the content of the slot unless a new one is being acquired
+    assign merge_ctrl_o.enable                              = merging;
+    assign merge_ctrl_o.start                               = in_start & merging;
+    assign merge_ctrl_o.load                                = acc_only & ~acquire_slot;
+    assign merge_ctrl_o.max                                 = state_slot_i.maximum;
+    assign merge_ctrl_o.denominator                         = state_slot_i.denominator;
+    assign merge_ctrl_o.expu_ctrl                           = datapath_ctrl_o.expu_ctrl;
+
+    /*  With CMD_STATS_OUT the maximum and the denominator of each row are written to STATS_ADDR + row * STATS_BYTES  *
+     *  as soon as the accumulation (or the merge) is over. The job only completes once the store is done.            */
+    /*  With a non-zero OUT_TOPK the "k" largest outputs of each row and their indexes are written to               *
+     *  TOPK_ADDR + row * k * TOPK_ENTRY_BYTES once the row has been normalised, see softex_topk. Only complete     *
+     *  jobs record them: the indexes of a partial job would not be the ones of the row.                           */
+    assign topk_k                                           = reg_file.hwpe_params [OUT_CTRL][OUT_TOPK +: 4];
+    assign topk_enable                                      = (topk_k != '0) & ~acc_only & ~div_only & ~merging & ~lse_mode;
+
+    assign topk_ctrl_o.enable                               = topk_enable;
+    assign topk_ctrl_o.clear                                = clear_regs;
+    assign topk_ctrl_o.start                                = topk_start;
+    assign topk_ctrl_o.k                                    = topk_k > TOPK_MAX ? TOPK_MAX : topk_k;
+
+    /*  With OUT_SPARSE the normalised row is not written to OUT_ADDR as it is: softex_sparse stores only the       *
+     *  outputs above THRESHOLD, as (index, value) entries from OUT_ADDR + row * OUT_ROW_STRIDE + SPARSE_HDR_BYTES, *
+     *  and the count of entries is written in the header before them. The indexes are the ones of the row, so     *
+     *  only complete jobs can be sparse. The values are in the datapath format, the output cast does not apply.   */
+    assign sparse_enable                                    = reg_file.hwpe_params [OUT_CTRL][OUT_SPARSE] & ~acc_only & ~div_only & ~merging & ~lse_mode;
+
+    assign sparse_ctrl_o.enable                             = sparse_enable;
+    assign sparse_ctrl_o.clear                              = clear_regs;
+    assign sparse_ctrl_o.base_addr                          = job.out_addr + out_row_offs_q + SPARSE_HDR_BYTES;
+    assign sparse_ctrl_o.tot_len                            = n_beats(n_elements * (IN_WIDTH / 8), DATA_WIDTH / 8);
+    assign sparse_ctrl_o.threshold                          = reg_file.hwpe_params [THRESHOLD] [IN_WIDTH - 1 : 0];
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : stats_register
+        if (~rst_ni) begin
+            stats_pending_q <= '0;
+            stats_valid_q   <= '0;
+            stats_max_q     <= '0;
+            stats_den_q     <= '0;
+        end else begin
+            if (clear) begin
+                stats_pending_q <= '0;
+                stats_valid_q   <= '0;
+                stats_max_q     <= '0;
+                stats_den_q     <= '0;
+            end else if (stats_start) begin
+                stats_pending_q <= '1;
+                stats_valid_q   <= '1;
+                stats_max_q     <= merging ? merge_flags_i.max : datapath_flgs_i.max;
+                stats_den_q     <= merging ? merge_flags_i.denominator : (lse_mode ? datapath_flgs_i.accumulator_flags.reciprocal : datapath_flgs_i.accumulator_flags.denominator);
+            end else if (cpl_start | topk_start | sparse_start) begin
+                stats_pending_q <= '1;
+                stats_valid_q   <= ~topk_start; // The top-k record is streamed by softex_topk
+            end else begin
+                if (stats_o.valid & stats_o.ready)
+                    stats_valid_q   <= '0;
+
+                if (stats_flags_i.done)
+                    stats_pending_q <= '0;
+            end
+        end
+    end
+
+    /*  With CPL_COUNT != 0 each job that runs the datapath writes a completion record (job id, status, cycles)   *
+     *  to the ring at CPL_ADDR before it completes, so that the core can process a whole batch of completions    *
+     *  after a single event. The record goes through the statistics store channel.                               */
+    assign cpl_enable                                       = reg_file.hwpe_params [CPL_COUNT] != '0;
+    assign cpl_evt                                          = (desc_active & ~desc_last) ? job.commands [CMD_DESC_EVT] : evt_fire;
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : cpl_register
+        if (~rst_ni) begin
+            cpl_idx_q       <= '0;
+            cpl_sel_q       <= '0;
+            cpl_written_q   <= '0;
+            cpl_status_q    <= '0;
+            cpl_cycles_q    <= '0;
+            topk_sel_q      <= '0;
+            topk_written_q  <= '0;
+            sparse_sel_q    <= '0;
+            sparse_written_q <= '0;
+        end else begin
+            if (clear) begin
+                cpl_idx_q       <= '0;
+                cpl_sel_q       <= '0;
+                topk_sel_q      <= '0;
+                topk_written_q  <= '0;
+                sparse_sel_q    <= '0;
+                sparse_written_q <= '0;
+                cpl_written_q   <= '0;
+                cpl_status_q    <= '0;
+                cpl_cycles_q    <= '0;
+            end else begin
+                if (cpl_start) begin
+                    cpl_idx_q       <= (cpl_idx_q + 1) >= reg_file.hwpe_params [CPL_COUNT] ? '0 : cpl_idx_q + 1;
+                    cpl_written_q   <= '1;
+                    cpl_status_q    <= (32'(1) << CPL_DONE) | (32'(cpl_evt) << CPL_EVT) | (32'(desc_active) << CPL_DESC);
+                    cpl_cycles_q    <= job_cycles_q;
+                end else if (job_done) begin
+                    cpl_written_q   <= '0;
+                end
+
+                // The top-k record and the sparse header are written once per row
+                if (topk_start) begin
+                    topk_written_q  <= '1;
+                end else if (clear_regs) begin
+                    topk_written_q  <= '0;
+                end
+
+                if (sparse_start) begin
+                    sparse_written_q <= '1;
+                end else if (clear_regs) begin
+                    sparse_written_q <= '0;
+                end
+
+                if (stats_start | cpl_start | topk_start | sparse_start) begin
+                    cpl_sel_q       <= cpl_start;
+                    topk_sel_q      <= topk_start;
+                    sparse_sel_q    <= sparse_start;
+                end
+            end
+        end
+    end
+
+    assign stats_o.valid                                    = topk_sel_q ? topk_i.valid : stats_valid_q;
+    assign stats_o.data                                     = topk_sel_q ? topk_i.data : cpl_sel_q ? {{(DATA_WIDTH - 128){1'b0}}, 32'h0, cpl_cycles_q, cpl_status_q, job_id_q} :
+                                                              sparse_sel_q ? {{(DATA_WIDTH - 64){1'b0}}, 32'h0, sparse_flags_i.count} :
+                                                                          {{(DATA_WIDTH - 64){1'b0}}, {(32 - ACC_WIDTH){1'b0}}, stats_den_q, {(32 - IN_WIDTH){1'b0}}, stats_max_q};
+    assign stats_o.strb                                     = topk_sel_q ? topk_i.strb : cpl_sel_q ? {{((DATA_WIDTH - 128) / 8){1'b0}}, {CPL_BYTES{1'b1}}} : {{((DATA_WIDTH - 64) / 8){1'b0}}, {STATS_BYTES{1'b1}}};
+
+    assign topk_i.ready                                     = topk_sel_q & stats_o.ready;
+
+    assign stats_ctrl_o.req_start                           = stats_start | cpl_start | topk_start | sparse_start;
+    assign stats_ctrl_o.addressgen_ctrl.base_addr           = cpl_start ? reg_file.hwpe_params [CPL_ADDR] + cpl_idx_q * CPL_BYTES :
+                                                              topk_start ? reg_file.hwpe_params [TOPK_ADDR] + row_cnt_q * topk_ctrl_o.k * TOPK_ENTRY_BYTES :
+                                                              sparse_start ? job.out_addr + out_row_offs_q :
+                                                              reg_file.hwpe_params [STATS_ADDR] + row_cnt_q * STATS_BYTES;
+    assign stats_ctrl_o.addressgen_ctrl.tot_len             = topk_start ? n_beats(topk_ctrl_o.k * TOPK_ENTRY_BYTES, DATA_WIDTH / 8) : 1;
+    assign stats_ctrl_o.addressgen_ctrl.d0_len              = '0;
+    assign stats_ctrl_o.addressgen_ctrl.d0_stride           = topk_start ? DATA_WIDTH / 8 : '0;
+    assign stats_ctrl_o.addressgen_ctrl.d1_len              = '0;
+    assign stats_ctrl_o.addressgen_ctrl.d1_stride           = '0;
+    assign stats_ctrl_o.addressgen_ctrl.d2_stride           = '0;
+    assign stats_ctrl_o.addressgen_ctrl.dim_enable_1h       = '0;
 
     always_comb begin : ctrl_sfm
         next_state          = current_state;
         out_start           = '0;
         in_start            = '0;
+        rb_replay           = '0;
+        norm_handover       = '0;
         dp_acc_finished     = '0;
         dp_disable_max      = '0;
         dp_dividing         = '0;
-        slave_done          = '0;
+        job_done            = '0;
+        desc_start          = '0;
+        desc_job_ack        = '0;
+        stats_start         = '0;
+        cpl_start           = '0;
+        topk_start          = '0;
+        sparse_start        = '0;
+        next_row            = '0;
+        ahead_dispatch      = '0;
         busy_o              = '1;
         clear_regs          = '0;
         state_slot_en       = '0;
@@ -250,15 +778,53 @@ import softex_pkg::*;
 
         case (current_state)
             IDLE: begin
-                busy_o = '0;
+                busy_o = desc_active | row_pending;
+
+                if (row_pending) begin
+                    // Next row of a strided job, the parameters have already been checked by the first one
+                    in_start    = '1;
+
+                    if (act_enable) begin
+                        next_state  = DIVIDING;
+                        out_start   = ~sparse_enable;
+                        dp_load_max = '1;
+                    end else begin
+                        next_state  = ACCUMULATION;
+                    end
+                end else if (desc_job_valid & job_ahead_q) begin
+                    // The input of this descriptor was launched during the previous one and is held at the row buffer
+                    desc_job_ack    = '1;
+                    ahead_dispatch  = '1;
+                    next_state      = ACCUMULATION;
+
+                    if (set_cache_addr) begin
+                        cache_base_addr_en = '1;
+                    end
+                end else if (flgs_slave.start & desc_mode) begin
+                    busy_o      = '1;
+                    desc_start  = '1;
+
+                    if (set_cache_addr) begin
+                        cache_base_addr_en = '1;
+                    end
+
+                    if (reg_file.hwpe_params [DESC_COUNT] == '0) begin
+                        job_done    = '1;
+                    end
+                end else if (flgs_slave.start | desc_job_valid) begin
+                    desc_job_ack = desc_job_valid;
 
-                if (flgs_slave.start) begin
                     if (set_cache_addr) begin
                         cache_base_addr_en = '1;
                     end
 
                     if (~no_operation) begin
-                        if (~state_slot_i.valid & (acc_only | div_only)) begin
+                        if (act_enable) begin
+                            next_state  = DIVIDING;
+                            out_start   = ~sparse_enable;
+                            in_start    = '1;
+                            dp_load_max = '1;
+                        end else if (~state_slot_i.valid & (acc_only | div_only)) begin
                             next_state = WAIT_SLOT_VALID;
                         end else begin
                             casex ({div_only, acc_only})
@@ -267,7 +833,8 @@ import softex_pkg::*;
                                 2'b1?:  next_state  = DIVIDING;
                             endcase
 
-                            if ((acc_only | div_only) & ~acquire_slot) begin
+                            // The merge unit loads the slot on its own
+                            if ((acc_only | div_only) & ~acquire_slot & ~merging) begin
                                 dp_load_max = '1;
 
                                 if (acc_only) begin
@@ -285,14 +852,14 @@ import softex_pkg::*;
                             end  
                         end
                     end else begin
-                        slave_done = '1;
+                        job_done = '1;
                     end
                 end
             end
 
             WAIT_SLOT_VALID: begin
                 if (state_slot_i.valid) begin
-                    if (~acquire_slot) begin
+                    if (~acquire_slot & ~merging) begin
                         dp_load_max = '1;
                     end
 
@@ -300,7 +867,7 @@ import softex_pkg::*;
                         next_state          = ACCUMULATION;
                         in_start            = '1;
 
-                        if (~acquire_slot) begin
+                        if (~acquire_slot & ~merging) begin
                             dp_load_denominator = '1;
                         end
                     end else begin
@@ -316,13 +883,25 @@ import softex_pkg::*;
             end
 
             ACCUMULATION: begin
-                if (in_stream_flags_i.done) begin
+                if (in_stream_flags_i.done | early_done_q) begin
                     next_state = WAIT_DATAPATH_EMPTY;
                 end
             end
 
             WAIT_DATAPATH_EMPTY: begin
-                if (~datapath_flgs_i.datapath_busy) begin
+                if (merging) begin
+                    // A merge does not go through the datapath, unless the result has to be inverted
+                    if (~merge_flags_i.busy) begin
+                        if (acc_only & last) begin
+                            next_state          = WAIT_ACCUMULATION;
+                            dp_load_max         = '1;
+                            dp_load_denominator = '1;
+                        end else begin
+                            next_state          = FINISHED;
+                            stats_start         = stats_out;
+                        end
+                    end
+                end else if (~datapath_flgs_i.datapath_busy) begin
                     next_state      = WAIT_ACCUMULATION;
                     dp_acc_finished = '1;
                 end
@@ -333,13 +912,24 @@ import softex_pkg::*;
                 dp_disable_max  = '1;
 
                 if (datapath_flgs_i.accumulator_flags.acc_done) begin
+                    stats_start = stats_out & ~lse_mode;
+
                     if (acc_only & ~last) begin
                         next_state          = FINISHED;
                     end else begin
-                        if (~acc_only) begin
+                        if (~acc_only & ~lse_mode) begin
                             dp_acc_finished = '0;
-                            out_start       = '1;
-                            in_start        = '1;
+
+                            // In the dual-row mode the output stream is started by the hand over to the lane
+                            if (~dual_row) begin
+                                out_start   = ~sparse_enable;
+
+                                if (row_buf_flags_i.valid) begin
+                                    rb_replay   = '1;
+                                end else begin
+                                    in_start    = '1;
+                                end
+                            end
                         end
 
                         next_state      = WAIT_INVERSION;
@@ -352,8 +942,17 @@ import softex_pkg::*;
                 dp_disable_max  = '1;
 
                 if (datapath_flgs_i.accumulator_flags.inv_done) begin
-                    if (acc_only) begin
+                    stats_start = lse_mode;
+
+                    if (acc_only | lse_mode) begin
                         next_state = FINISHED;
+                    end else if (dual_row) begin
+                        // Wait for the lane to be done with the previous row
+                        if (~lane_busy_q & out_stream_flags_i.ready_start) begin
+                            norm_handover   = '1;
+                            out_start       = '1;
+                            next_state      = FINISHED;
+                        end
                     end else begin
                         next_state = DIVIDING;
                     end
@@ -364,29 +963,136 @@ import softex_pkg::*;
                 dp_dividing     = '1;
                 dp_disable_max  = '1;
 
-                if (out_stream_flags_i.done) begin
+                if (sparse_enable ? sparse_flags_i.done : out_stream_flags_i.done) begin
                     next_state  = FINISHED;
                 end
             end
 
             FINISHED: begin
                 dp_dividing = '0;
-                slave_done  = '1;
-                busy_o      = '0;
-                clear_regs  = '1;
 
-                // The slot only needs to be updated if we are accumulating or if this is the last normalisation iteration
-                if (acc_only | (div_only & last)) begin
-                    state_slot_en = '1;
-                end
+                // Wait for the statistics of the row to be written and, at the end of the job, for the lane
+                if (~stats_pending_q & ~(lane_busy_q & ~more_rows)) begin
+                    // The completion record is the last store of the job
+                    if (sparse_enable & ~sparse_written_q) begin
+                        sparse_start    = '1;
+                    end else if (topk_enable & ~topk_written_q) begin
+                        topk_start  = '1;
+                    end else if (last_row & cpl_enable & ~cpl_written_q) begin
+                        cpl_start   = '1;
+                    end else begin
+                        clear_regs  = '1;
+
+                        next_state      = IDLE;
+
+                        if (~last_row) begin
+                            next_row    = '1;
+
+                            // The input of the next row is already flowing
+                            if (launched_q) begin
+                                next_state  = ACCUMULATION;
+                            end
+                        end else begin
+                            job_done    = '1;
+                            busy_o      = desc_active & ~desc_last;
+                        end
 
-                next_state      = IDLE;
+                        // The slot only needs to be updated if we are accumulating or if this is the last normalisation iteration
+                        if (acc_only | (div_only & last)) begin
+                            state_slot_en = '1;
+                        end
+                    end
+                end
             end
         endcase
+
+        if (launch_ahead) begin
+            in_start    = '1;
+        end
+    end
+
+    /*      PERFORMANCE COUNTERS      */
+
+    always_comb begin : perf_increments
+        perf_inc    = '0;
+
+        perf_inc [PERF_CYCLES]                  = current_state != IDLE;
+        perf_inc [PERF_STATE + current_state]   = 1;
+        perf_inc [PERF_IN_STALL]                = streamer_perf_i.in_stall;
+        perf_inc [PERF_OUT_STALL]               = streamer_perf_i.out_stall;
+        perf_inc [PERF_SLOT_LOAD]               = ~slot_in_flags_i.ready_start;
+        perf_inc [PERF_SLOT_STORE]              = ~slot_out_flags_i.ready_start;
+        perf_inc [PERF_RESCALES]                = datapath_flgs_i.rescale;
+        perf_inc [PERF_IN_BEATS]                = streamer_perf_i.in_beat;
+        perf_inc [PERF_OUT_BEATS]               = streamer_perf_i.out_beat;
+        perf_inc [PERF_DESCRIPTORS]             = job_done & desc_active;
+        perf_inc [PERF_RB_BEATS]                = row_buf_flags_i.beat;
+        perf_inc [PERF_SLOT_HITS]               = slot_flags_i.hit;
+        perf_inc [PERF_SLOT_MISSES]             = slot_flags_i.miss;
+
+        if ((current_state == FINISHED) & clear_regs) begin
+            perf_inc [PERF_ELEMENTS]            = n_elements;
+        end
+    end
+
+    softex_perf_counters #(
+        .N_COUNTERS (   N_PERF_CNT  ),
+        .CNT_WIDTH  (   PERF_CNT_W  )
+    ) i_perf_counters (
+        .clk_i      (   clk_i                                           ),
+        .rst_ni     (   rst_ni                                          ),
+        .clear_i    (   clear                                           ),
+        .inc_i      (   perf_inc                                        ),
+        .idx_i      (   periph.add [2 +: $clog2(N_PERF_CNT)]            ),
+        .cnt_o      (   perf_cnt                                        )
+    );
+
+    // The counters are read-only, writes are granted and ignored
+    always_ff @(posedge clk_i or negedge rst_ni) begin : perf_read
+        if (~rst_ni) begin
+            perf_r_valid    <= '0;
+            perf_r_data     <= '0;
+            perf_r_id       <= '0;
+        end else begin
+            perf_r_valid    <= periph.req & perf_sel;
+            perf_r_data     <= perf_cnt;
+            perf_r_id       <= periph.id;
+        end
     end
 
+    /*      DESCRIPTOR RING      */
+
+    softex_desc_fetch #(
+        .DATA_WIDTH (   DATA_WIDTH  )
+    ) i_desc_fetch (
+        .clk_i              (   clk_i                               ),
+        .rst_ni             (   rst_ni                              ),
+        .clear_i            (   clear                               ),
+        .start_i            (   desc_start                          ),
+        .base_addr_i        (   reg_file.hwpe_params [DESC_ADDR]    ),
+        .count_i            (   reg_file.hwpe_params [DESC_COUNT]   ),
+        .job_ack_i          (   desc_job_ack                        ),
+        .job_done_i         (   job_done                            ),
+        .slot_req_ready_i   (   ~(periph_slot_req | periph_prefetch_req)    ),
+        .stream_flags_i     (   desc_flags_i                        ),
+        .stream_ctrl_o      (   desc_ctrl_o                         ),
+        .active_o           (   desc_active                         ),
+        .job_valid_o        (   desc_job_valid                      ),
+        .job_last_o         (   desc_last                           ),
+        .job_o              (   desc_job                            ),
+        .next_valid_o       (   desc_next_valid                     ),
+        .next_job_o         (   desc_next_job                       ),
+        .slot_req_valid_o   (   desc_slot_req_valid                 ),
+        .slot_req_op_o      (   desc_slot_req_op                    ),
+        .evt_o              (   desc_evt                            ),
+        .stream_i           (   desc_i                              )
+    );
+
     assign clear_o  = clear;
 
-    assign  evt_o   = flgs_slave.evt;
+    // The end of job event of the slave is replaced by the coalesced one. Descriptors flagged with CMD_DESC_EVT raise an intermediate event
+    for (genvar i = 0; i < N_CORES; i++) begin : gen_evt
+        assign  evt_o [i]   = {flgs_slave.evt [i] [1], done_evt | desc_evt};
+    end
 
 endmodule
\ No newline at end of file
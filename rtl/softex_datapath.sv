@@ -20,7 +20,9 @@ import softex_pkg::*;
     parameter int unsigned              MAX_REGS        = NUM_REGS_MAX      ,
     parameter int unsigned              EXP_REGS        = NUM_REGS_EXPU     ,
     parameter int unsigned              FMA_REGS_IN     = NUM_REGS_FMA_IN   ,
-    parameter int unsigned              FMA_REGS_ACC    = NUM_REGS_FMA_ACC
+    parameter int unsigned              FMA_REGS_ACC    = NUM_REGS_FMA_ACC  ,
+    parameter bit                       DUAL_ROW        = DUAL_ROW_LANE     ,
+    parameter bit                       SPLIT_LDST      = SPLIT_LDST_PORTS
 ) (
     input   logic                           clk_i       ,
     input   logic                           rst_ni      ,
@@ -29,6 +31,7 @@ import softex_pkg::*;
     output  softex_pkg::datapath_flags_t    flags_o     ,
 
     hwpe_stream_intf_stream.sink            stream_i    ,
+    hwpe_stream_intf_stream.sink            norm_i      ,
     hwpe_stream_intf_stream.source          stream_o
 );
 
@@ -36,6 +39,9 @@ import softex_pkg::*;
     localparam int unsigned ACC_WIDTH       = fpnew_pkg::fp_width(ACC_FPFORMAT);
     localparam int unsigned VECT_SUM_DELAY  = $clog2(VECT_WIDTH) * SUM_REGS_ACC;
 
+    localparam logic [IN_WIDTH - 1 : 0] NEG_INF = {1'b1, {(fpnew_pkg::exp_bits(IN_FPFORMAT)){1'b1}}, {(fpnew_pkg::man_bits(IN_FPFORMAT)){1'b0}}};
+    localparam logic [IN_WIDTH - 1 : 0] IN_ONE  = {2'b00, {(fpnew_pkg::exp_bits(IN_FPFORMAT) - 1){1'b1}}, {(fpnew_pkg::man_bits(IN_FPFORMAT)){1'b0}}};
+
     logic [IN_WIDTH - 1 : 0]    old_max,
                                 new_max,
                                 max_diff,
@@ -72,7 +78,27 @@ import softex_pkg::*;
 
     logic   addmul_o_busy,
             exp_o_busy,
-            sum_o_busy;
+            sum_o_busy,
+            scale_o_busy;
+
+    logic [31 : 0]  elem_cnt_q;
+
+    logic   row_masked;
+
+    logic [VECT_WIDTH - 1 : 0] [IN_WIDTH - 1 : 0]   masked_data,
+                                                    scaled_data,
+                                                    scaled_masked_data,
+                                                    in_data;
+
+    logic [VECT_WIDTH - 1 : 0]  scaled_strb,
+                                in_strb,
+                                in_mask,
+                                scaled_mask;
+
+    logic   scale_valid,
+            scale_ready,
+            in_valid,
+            in_ready;
 
     logic [1:0] addmul_ready;
 
@@ -90,6 +116,21 @@ import softex_pkg::*;
             expu_o_tag,
             sum_o_tag;
 
+    logic   norm_valid;
+
+    logic   act_enable,
+            act_fma,
+            act_z_ready,
+            act_ready,
+            act_valid,
+            act_o_busy;
+
+    logic [VECT_WIDTH - 1 : 0] [IN_WIDTH - 1 : 0]   act_res;
+    logic [VECT_WIDTH - 1 : 0]                      act_strb;
+
+    logic [VECT_WIDTH - 1 : 0] [IN_WIDTH - 1 : 0]   norm_res;
+    logic [VECT_WIDTH - 1 : 0]                      norm_strb;
+
     softex_pkg::operation_t    addmul_op;
 
     flags_fifo_t    add_fifo_o_flgs;
@@ -100,24 +141,116 @@ import softex_pkg::*;
     hwpe_stream_intf_stream #(.DATA_WIDTH(IN_WIDTH * VECT_WIDTH + 1))  add_fifo_d  (.clk(clk_i));
     hwpe_stream_intf_stream #(.DATA_WIDTH(IN_WIDTH * VECT_WIDTH + 1))  add_fifo_q  (.clk(clk_i));
                             
-    assign stream_i.ready   = max_ready & delay_ready;
-    assign stream_o.valid   = mul_valid;
+    assign in_ready         = max_ready & delay_ready;
+
+    // The normalisation lane and the DIVIDING step are never active at the same time, nor are the activations
+    assign stream_o.valid   = act_enable ? act_valid : mul_valid | norm_valid;
+
+    // A row whose elements are all masked has a -inf maximum, exp(-inf - -inf) would make every output NaN. Its
+    // probabilities are written as exact zeros instead. The lane never runs masked rows
+    assign row_masked       = (new_max == NEG_INF) & ~ctrl_i.log_output & ~act_enable;
 
     always_comb begin
         stream_o.strb = '0;
         stream_o.data = '0;
 
         for (int i = 0; i < VECT_WIDTH; i++) begin
-            stream_o.strb [IN_WIDTH/8 * i +: IN_WIDTH/8]    = {(IN_WIDTH/8){mul_strb [i]}};
-            stream_o.data [IN_WIDTH * i +: IN_WIDTH]        = mul_res [i];
+            stream_o.strb [IN_WIDTH/8 * i +: IN_WIDTH/8]    = {(IN_WIDTH/8){act_enable ? act_strb [i] : norm_valid ? norm_strb [i] : mul_strb [i]}};
+            stream_o.data [IN_WIDTH * i +: IN_WIDTH]        = act_enable ? act_res [i] : norm_valid ? norm_res [i] : row_masked ? '0 : mul_res [i];
+        end
+    end
+
+    assign flags_o.datapath_busy = |{addmul_o_busy, exp_o_busy, sum_o_busy, scale_o_busy, act_o_busy, ~add_fifo_o_flgs.empty};
+
+    /*  The input scores are optionally scaled and masked before entering the datapath.             *
+     *  Masked elements (index >= valid_len) are replaced by -inf: they do not affect the maximum,  *
+     *  their exponential is zero and they produce exact zeros on output. The mask is applied to    *
+     *  the output of the pre-scale, so that a non-positive SCALE does not turn -inf into +inf or   *
+     *  NaN; the mask bits travel through "i_pre_scale" as its tag.                                 */
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : element_counter
+        if (~rst_ni) begin
+            elem_cnt_q <= '0;
+        end else begin
+            if (clear_i | ctrl_i.clear_regs | ctrl_i.mask_restart) begin
+                elem_cnt_q <= '0;
+            end else if (stream_i.valid & stream_i.ready) begin
+                elem_cnt_q <= elem_cnt_q + VECT_WIDTH;
+            end
         end
     end
 
-    assign flags_o.datapath_busy = |{addmul_o_busy, exp_o_busy, sum_o_busy, ~add_fifo_o_flgs.empty};
+    for (genvar i = 0; i < VECT_WIDTH; i++) begin : gen_input_mask
+        assign in_mask [i]              = ctrl_i.mask_enable & ((elem_cnt_q + i) >= ctrl_i.valid_len);
+
+        assign masked_data [i]          = in_mask [i] ? NEG_INF : stream_i.data [i * IN_WIDTH +: IN_WIDTH];
+        assign scaled_masked_data [i]   = scaled_mask [i] ? NEG_INF : scaled_data [i];
+    end
+
+    softex_fp_vect_addmul #(
+        .FPFORMAT           (   IN_FPFORMAT ),
+        .REG_POS            (   REG_POS     ),
+        .NUM_REGS           (   FMA_REGS_IN ),
+        .VECT_WIDTH         (   VECT_WIDTH  ),
+        .TAG_TYPE           (   logic [VECT_WIDTH - 1 : 0]  )
+    ) i_pre_scale (
+        .clk_i              (   clk_i                                           ),
+        .rst_ni             (   rst_ni                                          ),
+        .clear_i            (   clear_i                                         ),
+        .enable_i           (   '1                                              ),
+        .round_mode_i       (   fpnew_pkg::RNE                                  ),
+        .operation_i        (   softex_pkg::MUL                                 ),
+        .op_mod_add_i       (   '0                                              ),
+        .op_mod_mul_i       (   '0                                              ),
+        .mul_fma_i          (   '0                                              ),
+        .busy_o             (   scale_o_busy                                    ),
+        .add_valid_i        (   '0                                              ),
+        .add_scal_valid_i   (   '0                                              ),
+        .add_ready_i        (   '0                                              ),
+        .add_strb_i         (   '0                                              ),
+        .add_vect_i         (   '0                                              ),
+        .add_scal_i         (   '0                                              ),
+        .add_tag_i          (   '0                                              ),
+        .add_valid_o        (                                                   ),
+        .add_ready_o        (                                                   ),
+        .add_strb_o         (                                                   ),
+        .add_res_o          (                                                   ),
+        .add_tag_o          (                                                   ),
+        .mul_valid_i        (   stream_i.valid & ctrl_i.scale_enable            ),
+        .mul_scal_valid_i   (   '1                                              ),
+        .mul_ready_i        (   in_ready                                        ),
+        .mul_strb_i         (   stream_i.strb [VECT_WIDTH - 1 : 0]              ),
+        .mul_vect_i         (   stream_i.data [IN_WIDTH * VECT_WIDTH - 1 : 0]   ),
+        .mul_scal_i         (   ctrl_i.scale                                    ),
+        .mul_add_scal_i     (   '0                                              ),
+        .mul_tag_i          (   in_mask                                         ),
+        .mul_valid_o        (   scale_valid                                     ),
+        .mul_ready_o        (   scale_ready                                     ),
+        .mul_strb_o         (   scaled_strb                                     ),
+        .mul_res_o          (   scaled_data                                     ),
+        .mul_tag_o          (   scaled_mask                                     )
+    );
+
+    // When scaling is disabled the pre-scale stage is bypassed
+    assign in_valid         = ctrl_i.scale_enable ? scale_valid : stream_i.valid;
+    assign in_data          = ctrl_i.scale_enable ? scaled_masked_data : masked_data;
+    assign in_strb          = ctrl_i.scale_enable ? scaled_strb : stream_i.strb [VECT_WIDTH - 1 : 0];
+
+    assign stream_i.ready   = ctrl_i.scale_enable ? scale_ready : in_ready;
 
     // During the normalisation step "i_addmul_time_mux" is used to both
     // substract the maximum value to the input and to normalise the 
-    // exponentiated score
+    // exponentiated score. With "log_output" the difference skips the
+    // exponential and the second operation subtracts ln(denominator).
+    // With an activation the maximum is zero and the second operation
+    // computes exp(z) + 1 (or exp(z) * 1), finished by "i_act".
+    // With SPLIT_LDST the stores have their own port and the two
+    // operations get one FMA each, so the counter has no effect. The
+    // MUL FMA then sees the accumulation beats too and only takes them
+    // while dividing; the shared FMA is left as it was
+
+    assign act_enable   = ctrl_i.act != ACT_NONE;
+    assign act_fma      = ctrl_i.act inside {ACT_SIGMOID, ACT_SILU, ACT_GELU};
 
     assign fma_arb_cnt_enable = ctrl_i.dividing & addmul_ready [fma_arb_cnt];
     always_ff @(posedge clk_i or negedge rst_ni) begin : fma_arbitration_counter
@@ -132,7 +265,8 @@ import softex_pkg::*;
         end
     end
 
-    assign flags_o.max  = new_max;
+    assign flags_o.max      = new_max;
+    assign flags_o.rescale  = fact_fifo_d.valid & fact_fifo_d.ready;
 
     softex_fp_glob_minmax #(
         .FPFORMAT   (   IN_FPFORMAT     ),
@@ -144,11 +278,11 @@ import softex_pkg::*;
         .rst_ni          (  rst_ni                                          ),
         .clear_i         (  clear_i | ctrl_i.clear_regs                     ),
         .enable_i        (  '1                                              ),
-        .valid_i         (  stream_i.valid & ~ctrl_i.disable_max            ),
+        .valid_i         (  in_valid & ~ctrl_i.disable_max                  ),
         .ready_i         (  max_diff_ready & diff_ready                     ),
         .operation_i     (  softex_pkg::MAX                                 ),
-        .strb_i          (  stream_i.strb [VECT_WIDTH - 1 : 0]              ),
-        .vect_i          (  stream_i.data [VECT_WIDTH * IN_WIDTH - 1 : 0]   ),
+        .strb_i          (  in_strb                                         ),
+        .vect_i          (  in_data                                         ),
         .load_i          (  ctrl_i.max                                      ),
         .load_en_i       (  ctrl_i.load_max                                 ),
         .cur_minmax_o    (  old_max                                         ),
@@ -199,6 +333,7 @@ import softex_pkg::*;
         .rst_ni     (   rst_ni              ),
         .clear_i    (   clear_i             ),
         .enable_i   (   '1                  ),      
+        .ctrl_i     (   ctrl_i.expu_ctrl    ),
         .valid_i    (   max_diff_valid      ),
         .ready_i    (   fact_fifo_d.ready   ),
         .strb_i     (   '1                  ),
@@ -237,10 +372,10 @@ import softex_pkg::*;
         .rst_ni     (   rst_ni                                          ),
         .enable_i   (   '1                                              ),
         .clear_i    (   clear_i                                         ),
-        .valid_i    (   stream_i.valid                                  ),
+        .valid_i    (   in_valid                                        ),
         .ready_i    (   diff_ready                                      ),
-        .data_i     (   stream_i.data [VECT_WIDTH * IN_WIDTH - 1 : 0]   ),
-        .strb_i     (   stream_i.strb [VECT_WIDTH - 1 : 0]              ),
+        .data_i     (   in_data                                         ),
+        .strb_i     (   in_strb                                         ),
         .valid_o    (   delay_valid                                     ),
         .ready_o    (   delay_ready                                     ),
         .data_o     (   delayed_data                                    ),
@@ -257,7 +392,8 @@ import softex_pkg::*;
         .REG_POS            (   REG_POS     ),
         .NUM_REGS           (   FMA_REGS_IN ),
         .VECT_WIDTH         (   VECT_WIDTH  ),
-        .TAG_TYPE           (   logic       )    
+        .TAG_TYPE           (   logic       ),
+        .PARALLEL           (   SPLIT_LDST  )
     ) i_addmul_time_mux (
         .clk_i              (   clk_i                                           ),
         .rst_ni             (   rst_ni                                          ),
@@ -266,11 +402,12 @@ import softex_pkg::*;
         .round_mode_i       (   fpnew_pkg::RNE                                  ),
         .operation_i        (   addmul_op                                       ),
         .op_mod_add_i       (   '1                                              ),
-        .op_mod_mul_i       (   '0                                              ),
+        .op_mod_mul_i       (   ctrl_i.log_output                               ),
+        .mul_fma_i          (   ctrl_i.log_output | act_fma                     ),
         .busy_o             (   addmul_o_busy                                   ),
         .add_valid_i        (   delay_valid                                     ),
         .add_scal_valid_i   (   '1                                              ),
-        .add_ready_i        (   exp_ready                                       ),
+        .add_ready_i        (   ctrl_i.log_output ? add_fifo_d.ready : exp_ready & (act_z_ready | ~act_enable)  ),
         .add_strb_i         (   delayed_strb                                    ),
         .add_vect_i         (   delayed_data                                    ),
         .add_scal_i         (   new_max                                         ),
@@ -280,12 +417,13 @@ import softex_pkg::*;
         .add_strb_o         (   diff_strb                                       ),
         .add_res_o          (   diff_vect                                       ),
         .add_tag_o          (   addmul_o_tag                                    ),
-        .mul_valid_i        (   add_fifo_q.valid                                ),
-        .mul_scal_valid_i   (   cast_valid                                      ),
-        .mul_ready_i        (   stream_o.ready                                  ),
+        .mul_valid_i        (   add_fifo_q.valid & (ctrl_i.dividing | ~SPLIT_LDST)  ),
+        .mul_scal_valid_i   (   cast_valid | act_enable                         ),
+        .mul_ready_i        (   act_enable ? act_ready : stream_o.ready         ),
         .mul_strb_i         (   add_fifo_q.strb [VECT_WIDTH - 1 : 0]            ),
         .mul_vect_i         (   add_fifo_q.data [IN_WIDTH * VECT_WIDTH - 1 : 0] ),
-        .mul_scal_i         (   inv_cast                                        ),
+        .mul_scal_i         (   ctrl_i.log_output | act_enable ? IN_ONE : inv_cast  ),
+        .mul_add_scal_i     (   act_enable ? IN_ONE : inv_cast                  ),
         .mul_tag_i          (   '0                                              ),
         .mul_valid_o        (   mul_valid                                       ),
         .mul_ready_o        (   mul_ready                                       ),
@@ -305,7 +443,8 @@ import softex_pkg::*;
         .rst_ni     (   rst_ni              ),
         .clear_i    (   clear_i             ),
         .enable_i   (   '1                  ),
-        .valid_i    (   diff_valid          ),
+        .ctrl_i     (   ctrl_i.expu_ctrl    ),
+        .valid_i    (   diff_valid & ~ctrl_i.log_output & (act_z_ready | ~act_enable)   ),
         .ready_i    (   add_fifo_d.ready    ),
         .strb_i     (   diff_strb           ),
         .op_i       (   diff_vect           ),
@@ -318,9 +457,34 @@ import softex_pkg::*;
         .busy_o     (   exp_o_busy          )
     );
 
-    assign add_fifo_d.valid = exp_valid;
-    assign add_fifo_d.data  = {expu_o_tag, exp_vect};
-    assign add_fifo_d.strb  = {{(IN_WIDTH / 8 * VECT_WIDTH - VECT_WIDTH){1'b0}}, exp_strb};
+    // The input of each exponential of an activation is kept for the last stage
+    softex_act #(
+        .FPFORMAT   (   IN_FPFORMAT ),
+        .REG_POS    (   REG_POS     ),
+        .NUM_REGS   (   FMA_REGS_IN ),
+        .VECT_WIDTH (   VECT_WIDTH  )
+    ) i_act (
+        .clk_i      (   clk_i                                                   ),
+        .rst_ni     (   rst_ni                                                  ),
+        .clear_i    (   clear_i                                                 ),
+        .act_i      (   ctrl_i.act                                              ),
+        .busy_o     (   act_o_busy                                              ),
+        .z_valid_i  (   act_enable & diff_valid & exp_ready                     ),
+        .z_ready_o  (   act_z_ready                                             ),
+        .z_i        (   diff_vect                                               ),
+        .valid_i    (   act_enable & mul_valid                                  ),
+        .ready_o    (   act_ready                                               ),
+        .strb_i     (   mul_strb                                                ),
+        .data_i     (   mul_res                                                 ),
+        .valid_o    (   act_valid                                               ),
+        .ready_i    (   stream_o.ready                                          ),
+        .strb_o     (   act_strb                                                ),
+        .res_o      (   act_res                                                 )
+    );
+
+    assign add_fifo_d.valid = ctrl_i.log_output ? diff_valid : exp_valid;
+    assign add_fifo_d.data  = ctrl_i.log_output ? {addmul_o_tag, diff_vect} : {expu_o_tag, exp_vect};
+    assign add_fifo_d.strb  = {{(IN_WIDTH / 8 * VECT_WIDTH - VECT_WIDTH){1'b0}}, ctrl_i.log_output ? diff_strb : exp_strb};
 
     hwpe_stream_fifo #(
         .DATA_WIDTH (   IN_WIDTH * VECT_WIDTH + 1   ),
@@ -379,6 +543,7 @@ import softex_pkg::*;
         .add_i          (   acc_i_add                                   ),      
         .mul_valid_i    (   fact_fifo_q.valid & sum_o_tag & sum_valid   ),
         .mul_i          (   fact_fifo_q.data                            ),         
+        .max_i          (   old_max                                     ),
         .ready_o        (   acc_ready                                   ),    
         .valid_o        (   acc_valid                                   ),
         .flags_o        (   flags_o.accumulator_flags                   ),
@@ -427,4 +592,161 @@ import softex_pkg::*;
 
     assign inv_cast = inv_cast_res;
 
+    /*  With DUAL_ROW a second lane normalises a row replayed by the row buffer while the main path is already  *
+     *  accumulating the next one. "norm_load" takes a snapshot of the maximum and of the reciprocal of the row  *
+     *  handed over, so that the main path can be cleared. Like "i_addmul_time_mux", the lane FMA alternates     *
+     *  the subtraction of the maximum and the normalisation, as the stores only get half of the memory port     *
+     *  while the next row is being loaded. With SPLIT_LDST the two run on separate FMAs.                        */
+
+    if (DUAL_ROW) begin : gen_norm_lane
+        logic [IN_WIDTH - 1 : 0]    norm_max_q,
+                                    norm_inv_q;
+
+        logic   norm_arb_cnt;
+
+        logic   norm_diff_valid,
+                norm_diff_ready,
+                norm_diff_tag,
+                norm_exp_valid,
+                norm_exp_ready,
+                norm_mul_ready;
+
+        logic [1:0] norm_ready;
+
+        logic [VECT_WIDTH - 1 : 0] [IN_WIDTH - 1 : 0]   norm_diff,
+                                                        norm_exp;
+
+        logic [VECT_WIDTH - 1 : 0]  norm_diff_strb,
+                                    norm_exp_strb;
+
+        hwpe_stream_intf_stream #(.DATA_WIDTH(IN_WIDTH * VECT_WIDTH))  norm_fifo_d  (.clk(clk_i));
+        hwpe_stream_intf_stream #(.DATA_WIDTH(IN_WIDTH * VECT_WIDTH))  norm_fifo_q  (.clk(clk_i));
+
+        always_ff @(posedge clk_i or negedge rst_ni) begin : norm_registers
+            if (~rst_ni) begin
+                norm_max_q  <= '0;
+                norm_inv_q  <= '0;
+            end else begin
+                if (clear_i) begin
+                    norm_max_q  <= '0;
+                    norm_inv_q  <= '0;
+                end else if (ctrl_i.norm_load) begin
+                    norm_max_q  <= new_max;
+                    norm_inv_q  <= inv_cast;
+                end
+            end
+        end
+
+        assign norm_ready [0] = norm_diff_ready;
+        assign norm_ready [1] = norm_mul_ready;
+
+        always_ff @(posedge clk_i or negedge rst_ni) begin : norm_arbitration_counter
+            if (~rst_ni) begin
+                norm_arb_cnt <= '0;
+            end else begin
+                if (clear_i) begin
+                    norm_arb_cnt <= '0;
+                end else if (norm_ready [norm_arb_cnt]) begin
+                    norm_arb_cnt <= norm_arb_cnt + 1;
+                end
+            end
+        end
+
+        softex_fp_vect_addmul #(
+            .FPFORMAT           (   IN_FPFORMAT ),
+            .REG_POS            (   REG_POS     ),
+            .NUM_REGS           (   FMA_REGS_IN ),
+            .VECT_WIDTH         (   VECT_WIDTH  ),
+            .TAG_TYPE           (   logic       ),
+            .PARALLEL           (   SPLIT_LDST  )
+        ) i_norm_addmul (
+            .clk_i              (   clk_i                                               ),
+            .rst_ni             (   rst_ni                                              ),
+            .clear_i            (   clear_i                                             ),
+            .enable_i           (   '1                                                  ),
+            .round_mode_i       (   fpnew_pkg::RNE                                      ),
+            .operation_i        (   norm_arb_cnt == '0 ? softex_pkg::ADD : softex_pkg::MUL  ),
+            .op_mod_add_i       (   '1                                                  ),
+            .op_mod_mul_i       (   '0                                                  ),
+            .mul_fma_i          (   '0                                                  ),
+            .busy_o             (                                                       ),
+            .add_valid_i        (   norm_i.valid                                        ),
+            .add_scal_valid_i   (   '1                                                  ),
+            .add_ready_i        (   norm_exp_ready                                      ),
+            .add_strb_i         (   norm_i.strb [VECT_WIDTH - 1 : 0]                    ),
+            .add_vect_i         (   norm_i.data [IN_WIDTH * VECT_WIDTH - 1 : 0]         ),
+            .add_scal_i         (   norm_max_q                                          ),
+            .add_tag_i          (   '0                                                  ),
+            .add_valid_o        (   norm_diff_valid                                     ),
+            .add_ready_o        (   norm_diff_ready                                     ),
+            .add_strb_o         (   norm_diff_strb                                      ),
+            .add_res_o          (   norm_diff                                           ),
+            .add_tag_o          (                                                       ),
+            .mul_valid_i        (   norm_fifo_q.valid                                   ),
+            .mul_scal_valid_i   (   '1                                                  ),
+            .mul_ready_i        (   stream_o.ready                                      ),
+            .mul_strb_i         (   norm_fifo_q.strb [VECT_WIDTH - 1 : 0]               ),
+            .mul_vect_i         (   norm_fifo_q.data                                    ),
+            .mul_scal_i         (   norm_inv_q                                          ),
+            .mul_add_scal_i     (   '0                                                  ),
+            .mul_tag_i          (   '0                                                  ),
+            .mul_valid_o        (   norm_valid                                          ),
+            .mul_ready_o        (   norm_mul_ready                                      ),
+            .mul_strb_o         (   norm_strb                                           ),
+            .mul_res_o          (   norm_res                                            ),
+            .mul_tag_o          (                                                       )
+        );
+
+        assign norm_i.ready = norm_diff_ready;
+
+        expu_top #(
+            .FPFORMAT               (   IN_FPFORMAT         ),
+            .REG_POS                (   softex_pkg::BEFORE  ),
+            .NUM_REGS               (   EXP_REGS            ),
+            .N_ROWS                 (   VECT_WIDTH          ),
+            .TAG_TYPE               (   logic               )
+        ) i_norm_exp (
+            .clk_i      (   clk_i               ),
+            .rst_ni     (   rst_ni              ),
+            .clear_i    (   clear_i             ),
+            .enable_i   (   '1                  ),
+            .ctrl_i     (   ctrl_i.expu_ctrl    ),
+            .valid_i    (   norm_diff_valid     ),
+            .ready_i    (   norm_fifo_d.ready   ),
+            .strb_i     (   norm_diff_strb      ),
+            .op_i       (   norm_diff           ),
+            .tag_i      (   '0                  ),
+            .res_o      (   norm_exp            ),
+            .valid_o    (   norm_exp_valid      ),
+            .ready_o    (   norm_exp_ready      ),
+            .strb_o     (   norm_exp_strb       ),
+            .tag_o      (                       ),
+            .busy_o     (                       )
+        );
+
+        assign norm_fifo_d.valid    = norm_exp_valid;
+        assign norm_fifo_d.data     = norm_exp;
+        assign norm_fifo_d.strb     = {{(IN_WIDTH / 8 * VECT_WIDTH - VECT_WIDTH){1'b0}}, norm_exp_strb};
+
+        hwpe_stream_fifo #(
+            .DATA_WIDTH (   IN_WIDTH * VECT_WIDTH   ),
+            .FIFO_DEPTH (   2                       )
+        ) i_norm_fifo (
+            .clk_i      (   clk_i           ),
+            .rst_ni     (   rst_ni          ),
+            .clear_i    (   clear_i         ),
+            .flags_o    (                   ),
+            .push_i     (   norm_fifo_d     ),
+            .pop_o      (   norm_fifo_q     )
+        );
+
+        assign norm_fifo_q.ready    = norm_mul_ready;
+    end else begin : gen_no_norm_lane
+        assign norm_i.ready = '0;
+
+        assign norm_valid   = '0;
+        assign norm_res     = '0;
+        assign norm_strb    = '0;
+    end
+
 endmodule
\ No newline at end of file
@@ -0,0 +1,236 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+module softex_desc_fetch
+import hci_package::*;
+import hwpe_stream_package::*;
+import softex_pkg::*;
+#(
+    parameter int unsigned  DATA_WIDTH  = DATA_W - 32
+) (
+    input   logic                           clk_i           ,
+    input   logic                           rst_ni          ,
+    input   logic                           clear_i         ,
+    input   logic                           start_i         ,
+    input   logic [31 : 0]                  base_addr_i     ,
+    input   logic [31 : 0]                  count_i         ,
+    input   logic                           job_ack_i       ,
+    input   logic                           job_done_i      ,
+    input   logic                           slot_req_ready_i,
+    input   hci_streamer_flags_t            stream_flags_i  ,
+    output  hci_streamer_ctrl_t             stream_ctrl_o   ,
+    output  logic                           active_o        ,
+    output  logic                           job_valid_o     ,
+    output  logic                           job_last_o      ,
+    output  job_params_t                    job_o           ,
+    output  logic                           next_valid_o    ,
+    output  job_params_t                    next_job_o      ,
+    output  logic                           slot_req_valid_o,
+    output  slot_req_op_t                   slot_req_op_o   ,
+    output  logic                           evt_o           ,
+
+    hwpe_stream_intf_stream.sink            stream_i
+);
+
+    /*  Descriptors are fetched from memory one at a time through a dedicated load channel of the streamer.    *
+     *  While a descriptor is being executed the next one is prefetched, so that its slot request can be        *
+     *  served in the background and the job can be dispatched as soon as the previous one is finished.        *
+     *  Each descriptor is DESC_WORDS words long:                                                               *
+     *      word 0: IN_ADDR                                                                                     *
+     *      word 1: OUT_ADDR                                                                                    *
+     *      word 2: TOT_LEN                                                                                     *
+     *      word 3: COMMANDS (slot id in the upper 16 bits)                                                     *
+     *      word 4: CAST_CTRL                                                                                   *
+     *      word 5: ROWS                                                                                        *
+     *      word 6: IN_ROW_STRIDE                                                                               *
+     *      word 7: OUT_ROW_STRIDE                                                                              */
+
+    localparam int unsigned DESC_WIDTH  = DESC_WORDS * 32;
+    localparam int unsigned BEAT_WIDTH  = DATA_WIDTH < DESC_WIDTH ? DATA_WIDTH : DESC_WIDTH;
+    localparam int unsigned DESC_BEATS  = DESC_WIDTH / BEAT_WIDTH;
+
+    typedef enum logic [1:0] {
+        IDLE,
+        FETCH,
+        SLOT_REQUEST,
+        READY
+    } fetch_state_t;
+
+    fetch_state_t   current_state,
+                    next_state;
+
+    logic [DESC_WIDTH - 1 : 0]  next_desc_q;
+    job_params_t                next_job,
+                                cur_job_q;
+
+    logic [31 : 0]  desc_addr_q,
+                    to_fetch_q,
+                    to_complete_q;
+
+    logic [$clog2(DESC_BEATS + 1) - 1 : 0]  beat_cnt_q;
+
+    logic   cur_busy_q,
+            cur_dispatched_q;
+
+    logic   start_fetch,
+            advance;
+
+    assign next_job.in_addr        = next_desc_q [32 * DESC_IN_ADDR        +: 32];
+    assign next_job.out_addr       = next_desc_q [32 * DESC_OUT_ADDR       +: 32];
+    assign next_job.tot_len        = next_desc_q [32 * DESC_TOT_LEN        +: 32];
+    assign next_job.commands       = next_desc_q [32 * DESC_COMMANDS       +: 32];
+    assign next_job.cast_ctrl      = next_desc_q [32 * DESC_CAST_CTRL      +: 32];
+    assign next_job.rows           = next_desc_q [32 * DESC_ROWS           +: 32];
+    assign next_job.in_row_stride  = next_desc_q [32 * DESC_IN_ROW_STRIDE  +: 32];
+    assign next_job.out_row_stride = next_desc_q [32 * DESC_OUT_ROW_STRIDE +: 32];
+
+    // The prefetched descriptor becomes the current one as soon as the previous job is over
+    assign advance  = (current_state == READY) & ~cur_busy_q;
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : state_register
+        if (~rst_ni) begin
+            current_state <= IDLE;
+        end else begin
+            if (clear_i | start_i) begin
+                current_state <= IDLE;
+            end else begin
+                current_state <= next_state;
+            end
+        end
+    end
+
+    always_comb begin : fetch_fsm
+        next_state          = current_state;
+        start_fetch         = '0;
+        slot_req_valid_o    = '0;
+
+        case (current_state)
+            IDLE: begin
+                if ((to_fetch_q != '0) & stream_flags_i.ready_start) begin
+                    start_fetch = '1;
+                    next_state  = FETCH;
+                end
+            end
+
+            FETCH: begin
+                if (stream_i.valid & (beat_cnt_q == DESC_BEATS - 1)) begin
+                    next_state  = SLOT_REQUEST;
+                end
+            end
+
+            SLOT_REQUEST: begin
+                // Same request the core pushes when writing the COMMANDS register
+                if ((next_job.commands [CMD_ACC_ONLY] | next_job.commands [CMD_DIV_ONLY]) & ~next_job.commands [CMD_NO_OP]) begin
+                    slot_req_valid_o = '1;
+
+                    if (slot_req_ready_i) begin
+                        next_state  = READY;
+                    end
+                end else begin
+                    next_state  = READY;
+                end
+            end
+
+            READY: begin
+                if (advance) begin
+                    next_state  = IDLE;
+                end
+            end
+        endcase
+    end
+
+    assign slot_req_op_o.addr   = next_job.commands [31 -: 16];
+    assign slot_req_op_o.op     = next_job.commands [CMD_ACQUIRE_SLOT] ? ALLOC : LOAD;
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : descriptor_register
+        if (~rst_ni) begin
+            next_desc_q <= '0;
+            beat_cnt_q  <= '0;
+        end else begin
+            if (clear_i | start_fetch) begin
+                beat_cnt_q  <= '0;
+            end else if (stream_i.valid & (current_state == FETCH)) begin
+                next_desc_q [BEAT_WIDTH * beat_cnt_q +: BEAT_WIDTH] <= stream_i.data [BEAT_WIDTH - 1 : 0];
+                beat_cnt_q                                          <= beat_cnt_q + 1;
+            end
+        end
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : ring_counters
+        if (~rst_ni) begin
+            desc_addr_q     <= '0;
+            to_fetch_q      <= '0;
+            to_complete_q   <= '0;
+        end else begin
+            if (clear_i) begin
+                desc_addr_q     <= '0;
+                to_fetch_q      <= '0;
+                to_complete_q   <= '0;
+            end else if (start_i) begin
+                desc_addr_q     <= base_addr_i;
+                to_fetch_q      <= count_i;
+                to_complete_q   <= count_i;
+            end else begin
+                if (start_fetch) begin
+                    desc_addr_q     <= desc_addr_q + DESC_WORDS * 4;
+                    to_fetch_q      <= to_fetch_q - 1;
+                end
+
+                if (job_done_i & cur_busy_q) begin
+                    to_complete_q   <= to_complete_q - 1;
+                end
+            end
+        end
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : current_job
+        if (~rst_ni) begin
+            cur_job_q           <= '0;
+            cur_busy_q          <= '0;
+            cur_dispatched_q    <= '0;
+        end else begin
+            if (clear_i | start_i) begin
+                cur_busy_q          <= '0;
+                cur_dispatched_q    <= '0;
+            end else if (advance) begin
+                cur_job_q           <= next_job;
+                cur_busy_q          <= '1;
+                cur_dispatched_q    <= '0;
+            end else if (job_done_i) begin
+                cur_busy_q          <= '0;
+                cur_dispatched_q    <= '0;
+            end else if (job_ack_i) begin
+                cur_dispatched_q    <= '1;
+            end
+        end
+    end
+
+    assign stream_i.ready   = current_state == FETCH;
+
+    assign stream_ctrl_o.req_start                      = start_fetch;
+    assign stream_ctrl_o.addressgen_ctrl.base_addr      = desc_addr_q;
+    assign stream_ctrl_o.addressgen_ctrl.tot_len        = DESC_BEATS;
+    assign stream_ctrl_o.addressgen_ctrl.d0_len         = '0;
+    assign stream_ctrl_o.addressgen_ctrl.d0_stride      = BEAT_WIDTH / 8;
+    assign stream_ctrl_o.addressgen_ctrl.d1_len         = '0;
+    assign stream_ctrl_o.addressgen_ctrl.d1_stride      = '0;
+    assign stream_ctrl_o.addressgen_ctrl.d2_stride      = '0;
+    assign stream_ctrl_o.addressgen_ctrl.dim_enable_1h  = '0;
+
+    assign active_o     = to_complete_q != '0;
+    assign job_valid_o  = cur_busy_q & ~cur_dispatched_q;
+    assign job_last_o   = to_complete_q == 1;
+    assign job_o        = cur_job_q;
+
+    // The prefetched descriptor, whose input the control may launch while the current job is normalising
+    assign next_valid_o = current_state == READY;
+    assign next_job_o   = next_job;
+
+    // The completion of the last descriptor is signalled by the regular end of job event
+    assign evt_o        = job_done_i & cur_busy_q & cur_job_q.commands [CMD_DESC_EVT] & ~job_last_o;
+
+endmodule
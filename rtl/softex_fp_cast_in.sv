@@ -0,0 +1,135 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+
+module softex_fp_cast_in
+import softex_pkg::*;
+import hwpe_stream_package::*;
+#(
+    parameter int unsigned              DATA_WIDTH  = DATA_W        ,
+    parameter fpnew_pkg::fp_format_e    FPFORMAT    = FPFORMAT_IN
+) (
+    input cast_ctrl_t               ctrl_i      ,
+
+    hwpe_stream_intf_stream.sink    stream_i    ,
+    hwpe_stream_intf_stream.source  stream_o
+);
+
+    /*  Converts FP16, FP8 E4M3 or FP8 E5M2 inputs to the datapath format. FP8 elements are read    *
+     *  from the lower half of the beat, like 8 bit integers. All the source formats have a         *
+     *  narrower exponent than FPFORMAT, so denormal inputs are normalised and no overflow occurs.  *
+     *  E4M3 follows the OCP convention: no infinities, S.1111.111 is NaN.                          */
+
+    localparam int unsigned MANTISSA_BITS   = fpnew_pkg::man_bits(FPFORMAT);
+    localparam int unsigned EXPONENT_BITS   = fpnew_pkg::exp_bits(FPFORMAT);
+    localparam int unsigned BIAS            = fpnew_pkg::bias(FPFORMAT);
+    localparam int unsigned FP_WIDTH        = fpnew_pkg::fp_width(FPFORMAT);
+
+    localparam int unsigned NUM_ROWS        = DATA_WIDTH / FP_WIDTH;
+    localparam int unsigned N_FMTS          = 3;
+
+    logic [N_FMTS - 1 : 0] [NUM_ROWS - 1 : 0] [FP_WIDTH - 1 : 0]      results;
+    logic [N_FMTS - 1 : 0] [NUM_ROWS - 1 : 0] [FP_WIDTH / 8 - 1 : 0]  strbs;
+
+    for (genvar f = 0; f < N_FMTS; f++) begin : gen_src_fmt
+        localparam fpnew_pkg::fp_format_e   SRC_FPFORMAT    = f == 0 ? fpnew_pkg::FP16 : (f == 1 ? fpnew_pkg::FP8ALT : fpnew_pkg::FP8);
+
+        localparam int unsigned SRC_MANTISSA_BITS   = fpnew_pkg::man_bits(SRC_FPFORMAT);
+        localparam int unsigned SRC_EXPONENT_BITS   = fpnew_pkg::exp_bits(SRC_FPFORMAT);
+        localparam int unsigned SRC_BIAS            = fpnew_pkg::bias(SRC_FPFORMAT);
+        localparam int unsigned SRC_WIDTH           = fpnew_pkg::fp_width(SRC_FPFORMAT);
+        localparam logic        SRC_HAS_INF         = f != 1;
+
+        for (genvar i = 0; i < NUM_ROWS; i++) begin : gen_lane
+            logic                                       sign;
+            logic [SRC_EXPONENT_BITS - 1 : 0]           exponent;
+            logic [SRC_MANTISSA_BITS - 1 : 0]           mantissa,
+                                                        norm_mantissa;
+            logic [$clog2(SRC_MANTISSA_BITS + 1) - 1 : 0]   leading_zeros;
+
+            logic [EXPONENT_BITS - 1 : 0]               new_exponent;
+            logic [EXPONENT_BITS + MANTISSA_BITS - 1 : 0]   converted;
+
+            assign sign     = stream_i.data [SRC_WIDTH * i + SRC_WIDTH - 1];
+            assign exponent = stream_i.data [SRC_WIDTH * i + SRC_MANTISSA_BITS +: SRC_EXPONENT_BITS];
+            assign mantissa = stream_i.data [SRC_WIDTH * i +: SRC_MANTISSA_BITS];
+
+            always_comb begin : leading_zero_count
+                leading_zeros = SRC_MANTISSA_BITS;
+
+                for (int k = 0; k < SRC_MANTISSA_BITS; k++) begin
+                    if (mantissa [k]) begin
+                        leading_zeros = SRC_MANTISSA_BITS - 1 - k;
+                    end
+                end
+            end
+
+            // Denormal inputs are normalised by shifting out the leading one
+            assign norm_mantissa    = exponent == '0 ? mantissa << (leading_zeros + 1) : mantissa;
+            assign new_exponent     = exponent == '0 ? BIAS - SRC_BIAS - leading_zeros : exponent - SRC_BIAS + BIAS;
+
+            if (SRC_MANTISSA_BITS > MANTISSA_BITS) begin : gen_round
+                localparam int unsigned DROPPED = SRC_MANTISSA_BITS - MANTISSA_BITS;
+
+                logic [DROPPED - 1 : 0] dropped_bits;
+                logic                   round;
+
+                assign dropped_bits = norm_mantissa [DROPPED - 1 : 0];
+                assign round        = dropped_bits [DROPPED - 1] & ((|(dropped_bits << 1)) | norm_mantissa [DROPPED]);
+
+                // A carry out of the mantissa correctly increments the exponent
+                assign converted    = {new_exponent, norm_mantissa [SRC_MANTISSA_BITS - 1 -: MANTISSA_BITS]} + round;
+            end else begin : gen_extend
+                logic [MANTISSA_BITS - 1 : 0]   wide_mantissa;
+
+                assign wide_mantissa    = norm_mantissa << (MANTISSA_BITS - SRC_MANTISSA_BITS);
+                assign converted        = {new_exponent, wide_mantissa};
+            end
+
+            always_comb begin : special_values
+                if ((exponent == '0) && (mantissa == '0)) begin
+                    results [f] [i] = {sign, {(FP_WIDTH - 1){1'b0}}};
+                end else if (SRC_HAS_INF ? (&exponent) : (&exponent & &mantissa)) begin
+                    results [f] [i] = {sign, {EXPONENT_BITS{1'b1}}, (SRC_HAS_INF & (mantissa == '0)) ? {MANTISSA_BITS{1'b0}} : {1'b1, {(MANTISSA_BITS - 1){1'b0}}}};
+                end else begin
+                    results [f] [i] = {sign, converted};
+                end
+            end
+
+            assign strbs [f] [i]    = {(FP_WIDTH / 8){&stream_i.strb [(SRC_WIDTH / 8) * i +: (SRC_WIDTH / 8)]}};
+        end
+    end
+
+    assign stream_i.ready   = stream_o.ready;
+
+    assign stream_o.valid   = stream_i.valid;
+
+    always_comb begin : output_mux
+        case (ctrl_i.fp_fmt)
+            FMT_FP16: begin
+                stream_o.data   = results [0];
+                stream_o.strb   = strbs [0];
+            end
+
+            FMT_FP8_E4M3: begin
+                stream_o.data   = results [1];
+                stream_o.strb   = strbs [1];
+            end
+
+            FMT_FP8_E5M2: begin
+                stream_o.data   = results [2];
+                stream_o.strb   = strbs [2];
+            end
+
+            default: begin
+                stream_o.data   = stream_i.data;
+                stream_o.strb   = stream_i.strb;
+            end
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,155 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+
+module softex_fp_cast_out
+import softex_pkg::*;
+import hwpe_stream_package::*;
+#(
+    parameter int unsigned              DATA_WIDTH  = DATA_W        ,
+    parameter fpnew_pkg::fp_format_e    FPFORMAT    = FPFORMAT_IN
+) (
+    input cast_ctrl_t               ctrl_i      ,
+
+    hwpe_stream_intf_stream.sink    stream_i    ,
+    hwpe_stream_intf_stream.source  stream_o
+);
+
+    /*  Converts the datapath output to FP16, FP8 E4M3 or FP8 E5M2 with round to nearest even.  *
+     *  FP8 results are packed in the lower half of the beat. Values too large for the          *
+     *  destination saturate to its largest finite number, small ones become denormals.         */
+
+    localparam int unsigned MANTISSA_BITS   = fpnew_pkg::man_bits(FPFORMAT);
+    localparam int unsigned EXPONENT_BITS   = fpnew_pkg::exp_bits(FPFORMAT);
+    localparam int unsigned BIAS            = fpnew_pkg::bias(FPFORMAT);
+    localparam int unsigned FP_WIDTH        = fpnew_pkg::fp_width(FPFORMAT);
+
+    localparam int unsigned NUM_ROWS        = DATA_WIDTH / FP_WIDTH;
+    localparam int unsigned N_FMTS          = 3;
+
+    logic [N_FMTS - 1 : 0] [DATA_WIDTH - 1 : 0]     results;
+    logic [N_FMTS - 1 : 0] [DATA_WIDTH / 8 - 1 : 0] strbs;
+
+    for (genvar f = 0; f < N_FMTS; f++) begin : gen_dst_fmt
+        localparam fpnew_pkg::fp_format_e   DST_FPFORMAT    = f == 0 ? fpnew_pkg::FP16 : (f == 1 ? fpnew_pkg::FP8ALT : fpnew_pkg::FP8);
+
+        localparam int unsigned DST_MANTISSA_BITS   = fpnew_pkg::man_bits(DST_FPFORMAT);
+        localparam int unsigned DST_EXPONENT_BITS   = fpnew_pkg::exp_bits(DST_FPFORMAT);
+        localparam int unsigned DST_BIAS            = fpnew_pkg::bias(DST_FPFORMAT);
+        localparam int unsigned DST_WIDTH           = fpnew_pkg::fp_width(DST_FPFORMAT);
+        localparam logic        DST_HAS_INF         = f != 1;
+
+        localparam logic [DST_WIDTH - 2 : 0]    MAX_FINITE  = DST_HAS_INF ? {{(DST_EXPONENT_BITS - 1){1'b1}}, 1'b0, {DST_MANTISSA_BITS{1'b1}}} : {{(DST_WIDTH - 2){1'b1}}, 1'b0};
+        localparam logic [DST_WIDTH - 2 : 0]    NAN         = DST_HAS_INF ? {{DST_EXPONENT_BITS{1'b1}}, 1'b1, {(DST_MANTISSA_BITS - 1){1'b0}}} : {(DST_WIDTH - 1){1'b1}};
+        localparam logic [DST_WIDTH - 2 : 0]    INF         = DST_HAS_INF ? {{DST_EXPONENT_BITS{1'b1}}, {DST_MANTISSA_BITS{1'b0}}} : MAX_FINITE;
+
+        // Hidden bit, mantissa and enough room for the guard bit of the smallest denormal
+        localparam int unsigned EXT_WIDTH   = MANTISSA_BITS + DST_MANTISSA_BITS + 3;
+
+        for (genvar i = 0; i < NUM_ROWS; i++) begin : gen_lane
+            logic                                   sign;
+            logic [EXPONENT_BITS - 1 : 0]           exponent;
+            logic [MANTISSA_BITS - 1 : 0]           mantissa;
+
+            logic signed [EXPONENT_BITS + 1 : 0]    new_exponent;
+
+            logic [EXT_WIDTH - 1 : 0]               ext_mantissa,
+                                                    shifted_mantissa,
+                                                    lost_mask;
+            logic [$clog2(EXT_WIDTH + 1) - 1 : 0]   shift;
+
+            logic [DST_MANTISSA_BITS - 1 : 0]       kept;
+            logic                                   guard,
+                                                    sticky,
+                                                    round,
+                                                    ovfr;
+
+            logic [DST_WIDTH - 1 : 0]               rounded;
+            logic [DST_WIDTH - 1 : 0]               result;
+
+            assign sign     = stream_i.data [FP_WIDTH * i + FP_WIDTH - 1];
+            assign exponent = stream_i.data [FP_WIDTH * i + MANTISSA_BITS +: EXPONENT_BITS];
+            assign mantissa = stream_i.data [FP_WIDTH * i +: MANTISSA_BITS];
+
+            assign new_exponent = $signed({2'b00, exponent}) - BIAS + DST_BIAS;
+
+            // Results below the normal range are shifted right to become denormals
+            always_comb begin : denormal_shift
+                if (new_exponent > 0) begin
+                    shift = '0;
+                end else if (1 - new_exponent > EXT_WIDTH) begin
+                    shift = EXT_WIDTH;
+                end else begin
+                    shift = 1 - new_exponent;
+                end
+            end
+
+            assign ext_mantissa     = {1'b1, mantissa, {(DST_MANTISSA_BITS + 2){1'b0}}};
+            assign shifted_mantissa = ext_mantissa >> shift;
+            assign lost_mask        = ~({EXT_WIDTH{1'b1}} << shift);
+
+            assign kept     = shifted_mantissa [EXT_WIDTH - 2 -: DST_MANTISSA_BITS];
+            assign guard    = shifted_mantissa [EXT_WIDTH - 2 - DST_MANTISSA_BITS];
+            assign sticky   = (|shifted_mantissa [EXT_WIDTH - 3 - DST_MANTISSA_BITS : 0]) | (|(ext_mantissa & lost_mask));
+            assign round    = guard & (sticky | kept [0]);
+
+            // A carry out of the mantissa correctly increments the exponent
+            assign rounded  = {1'b0, new_exponent > 0 ? new_exponent [DST_EXPONENT_BITS - 1 : 0] : {DST_EXPONENT_BITS{1'b0}}, kept} + round;
+
+            assign ovfr     = (new_exponent >= (1 << DST_EXPONENT_BITS)) || (rounded > {1'b0, MAX_FINITE});
+
+            always_comb begin : special_values
+                if (exponent == '0) begin
+                    result = {sign, {(DST_WIDTH - 1){1'b0}}};
+                end else if (&exponent) begin
+                    result = {sign, mantissa == '0 ? INF : NAN};
+                end else if (ovfr) begin
+                    result = {sign, MAX_FINITE};
+                end else begin
+                    result = {sign, rounded [DST_WIDTH - 2 : 0]};
+                end
+            end
+
+            assign results [f] [DST_WIDTH * i +: DST_WIDTH]         = result;
+            assign strbs [f] [(DST_WIDTH / 8) * i +: DST_WIDTH / 8] = {(DST_WIDTH / 8){&stream_i.strb [i * FP_WIDTH / 8 +: FP_WIDTH / 8]}};
+        end
+
+        if (DST_WIDTH < FP_WIDTH) begin : gen_pad
+            assign results [f] [DATA_WIDTH - 1 : NUM_ROWS * DST_WIDTH]          = '0;
+            assign strbs [f] [DATA_WIDTH / 8 - 1 : NUM_ROWS * DST_WIDTH / 8]    = '0;
+        end
+    end
+
+    assign stream_i.ready   = stream_o.ready;
+
+    assign stream_o.valid   = stream_i.valid;
+
+    always_comb begin : output_mux
+        case (ctrl_i.fp_fmt)
+            FMT_FP16: begin
+                stream_o.data   = results [0];
+                stream_o.strb   = strbs [0];
+            end
+
+            FMT_FP8_E4M3: begin
+                stream_o.data   = results [1];
+                stream_o.strb   = strbs [1];
+            end
+
+            FMT_FP8_E5M2: begin
+                stream_o.data   = results [2];
+                stream_o.strb   = strbs [2];
+            end
+
+            default: begin
+                stream_o.data   = stream_i.data;
+                stream_o.strb   = stream_i.strb;
+            end
+        endcase
+    end
+
+endmodule
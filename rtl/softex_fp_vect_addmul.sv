@@ -12,6 +12,7 @@ module softex_fp_vect_addmul import softex_pkg::*; #(
     parameter int unsigned              NUM_REGS    = 0                 ,
     parameter int unsigned              VECT_WIDTH  = 1                 ,
     parameter type                      TAG_TYPE    = logic             ,
+    parameter bit                       PARALLEL    = 0                 ,   // One FMA per channel, "operation_i" is ignored
 
     localparam int unsigned WIDTH   = fpnew_pkg::fp_width(FPFORMAT)
 ) (
@@ -23,6 +24,7 @@ module softex_fp_vect_addmul import softex_pkg::*; #(
     input   softex_pkg::operation_t                     operation_i         ,
     input   logic                                       op_mod_add_i        ,
     input   logic                                       op_mod_mul_i        ,
+    input   logic                                       mul_fma_i           ,
     output  logic                                       busy_o              ,
     
     input   logic                                       add_valid_i         ,
@@ -44,6 +46,7 @@ module softex_fp_vect_addmul import softex_pkg::*; #(
     input   logic [VECT_WIDTH - 1 : 0]                  mul_strb_i          ,
     input   logic [VECT_WIDTH - 1 : 0] [WIDTH - 1 : 0]  mul_vect_i          ,
     input   logic [WIDTH - 1 : 0]                       mul_scal_i          ,
+    input   logic [WIDTH - 1 : 0]                       mul_add_scal_i      ,
     input   TAG_TYPE                                    mul_tag_i           ,
     output  logic                                       mul_valid_o         ,
     output  logic                                       mul_ready_o         ,
@@ -55,6 +58,8 @@ module softex_fp_vect_addmul import softex_pkg::*; #(
     /*  A single FMA is used to compute both "add_vect_i [i] + add_scal_i" and  "mul_vect_i [i] * mul_scal_i".
      *  The user can select the operation to perform by changing the value of "operation_i".
      *  Note that the output channel is selected solely on the basis of the output operation ("o_operations [0]").
+     *  With "mul_fma_i" the MUL channel computes "mul_vect_i [i] * mul_scal_i + mul_add_scal_i" in a single rounding
+     *  ("op_mod_mul_i" turns the addition into a subtraction).
      *
      *      add_vect_i    mul_vect_i        
      *            ||        ||
@@ -74,96 +79,195 @@ module softex_fp_vect_addmul import softex_pkg::*; #(
      *         ADD ||      || MUL
      *             \/      \/
      *        add_res_o  mul_res_o
+     *
+     *  With PARALLEL each channel gets its own FMA and the two run concurrently, at twice the area.
      */
 
     localparam fpnew_pkg::pipe_config_t REG_POS_CVFPU   = softex_pkg::softex_to_cvfpu(REG_POS);
 
-    logic [VECT_WIDTH - 1 : 0] [WIDTH - 1 : 0]  fma_res;
-    logic [VECT_WIDTH - 1 : 0]                  fma_o_strb;
-    TAG_TYPE                                    fma_o_tag;
+    if (PARALLEL) begin : gen_parallel
+        logic [VECT_WIDTH - 1 : 0] [2 : 0] [WIDTH - 1 : 0]  add_operands,
+                                                            mul_operands;
+        logic [VECT_WIDTH - 1 : 0]                          add_valids,
+                                                            add_readies,
+                                                            add_busy,
+                                                            mul_valids,
+                                                            mul_readies,
+                                                            mul_busy;
+
+        TAG_TYPE [VECT_WIDTH - 1 : 0]   add_auxs,
+                                        mul_auxs;
+
+        for (genvar i = 0; i < VECT_WIDTH; i++) begin
+            assign add_operands [i][0] = '0;
+            assign add_operands [i][1] = add_vect_i [i];
+            assign add_operands [i][2] = add_scal_i;
+
+            assign mul_operands [i][0] = mul_scal_i;
+            assign mul_operands [i][1] = mul_vect_i [i];
+            assign mul_operands [i][2] = mul_add_scal_i;
+
+            fpnew_fma #(
+                .FpFormat       (   FPFORMAT        ),
+                .NumPipeRegs    (   NUM_REGS        ),
+                .PipeConfig     (   REG_POS_CVFPU   ),
+                .TagType        (   logic           ),
+                .AuxType        (   TAG_TYPE        )
+            ) i_add_fma (
+                .clk_i              (   clk_i                               ),
+                .rst_ni             (   rst_ni                              ),
+                .operands_i         (   add_operands [i]                    ),
+                .is_boxed_i         (   '1                                  ),
+                .rnd_mode_i         (   round_mode_i                        ),
+                .op_i               (   fpnew_pkg::ADD                      ),
+                .op_mod_i           (   op_mod_add_i                        ),
+                .tag_i              (   '0                                  ),
+                .mask_i             (   add_strb_i [i]                      ),
+                .aux_i              (   add_tag_i                           ),
+                .in_valid_i         (   add_valid_i & add_scal_valid_i      ),
+                .in_ready_o         (   add_readies [i]                     ),
+                .flush_i            (   clear_i                             ),
+                .result_o           (   add_res_o [i]                       ),
+                .status_o           (                                       ),
+                .extension_bit_o    (                                       ),
+                .tag_o              (                                       ),
+                .mask_o             (   add_strb_o [i]                      ),
+                .aux_o              (   add_auxs [i]                        ),
+                .out_valid_o        (   add_valids [i]                      ),
+                .out_ready_i        (   add_ready_i                         ),
+                .busy_o             (   add_busy [i]                        )
+            );
+
+            fpnew_fma #(
+                .FpFormat       (   FPFORMAT        ),
+                .NumPipeRegs    (   NUM_REGS        ),
+                .PipeConfig     (   REG_POS_CVFPU   ),
+                .TagType        (   logic           ),
+                .AuxType        (   TAG_TYPE        )
+            ) i_mul_fma (
+                .clk_i              (   clk_i                                               ),
+                .rst_ni             (   rst_ni                                              ),
+                .operands_i         (   mul_operands [i]                                    ),
+                .is_boxed_i         (   '1                                                  ),
+                .rnd_mode_i         (   round_mode_i                                        ),
+                .op_i               (   mul_fma_i ? fpnew_pkg::FMADD : fpnew_pkg::MUL       ),
+                .op_mod_i           (   op_mod_mul_i                                        ),
+                .tag_i              (   '0                                                  ),
+                .mask_i             (   mul_strb_i [i]                                      ),
+                .aux_i              (   mul_tag_i                                           ),
+                .in_valid_i         (   mul_valid_i & mul_scal_valid_i                      ),
+                .in_ready_o         (   mul_readies [i]                                     ),
+                .flush_i            (   clear_i                                             ),
+                .result_o           (   mul_res_o [i]                                       ),
+                .status_o           (                                                       ),
+                .extension_bit_o    (                                                       ),
+                .tag_o              (                                                       ),
+                .mask_o             (   mul_strb_o [i]                                      ),
+                .aux_o              (   mul_auxs [i]                                        ),
+                .out_valid_o        (   mul_valids [i]                                      ),
+                .out_ready_i        (   mul_ready_i                                         ),
+                .busy_o             (   mul_busy [i]                                        )
+            );
+        end
+
+        assign busy_o       = |{add_busy, mul_busy};
+
+        assign add_tag_o    = add_auxs [0];
+        assign mul_tag_o    = mul_auxs [0];
+
+        assign add_ready_o  = add_readies [0] & add_scal_valid_i;
+        assign mul_ready_o  = mul_readies [0] & mul_scal_valid_i;
 
-    logic [VECT_WIDTH - 1 : 0] [2 : 0] [WIDTH - 1 : 0]  fma_operands;
-    logic [VECT_WIDTH - 1 : 0]                          fma_valids,
-                                                        fma_readies;
+        assign add_valid_o  = add_valids [0];
+        assign mul_valid_o  = mul_valids [0];
+    end else begin : gen_time_mux
+        logic [VECT_WIDTH - 1 : 0] [WIDTH - 1 : 0]  fma_res;
+        logic [VECT_WIDTH - 1 : 0]                  fma_o_strb;
+        TAG_TYPE                                    fma_o_tag;
 
-    logic   fma_i_valid,
-            fma_i_ready;
+        logic [VECT_WIDTH - 1 : 0] [2 : 0] [WIDTH - 1 : 0]  fma_operands;
+        logic [VECT_WIDTH - 1 : 0]                          fma_valids,
+                                                            fma_readies;
 
-    TAG_TYPE    fma_i_aux;
+        logic   fma_i_valid,
+                fma_i_ready;
 
-    TAG_TYPE [VECT_WIDTH - 1 : 0] fma_o_auxs;
+        TAG_TYPE    fma_i_aux;
 
-    fpnew_pkg::operation_e  fpnew_op;
+        TAG_TYPE [VECT_WIDTH - 1 : 0] fma_o_auxs;
 
-    softex_pkg::operation_t [VECT_WIDTH - 1 : 0]   o_operations;
+        fpnew_pkg::operation_e  fpnew_op;
+
+        softex_pkg::operation_t [VECT_WIDTH - 1 : 0]   o_operations;
     
-    logic   op_mod;
-
-    logic   [VECT_WIDTH - 1 : 0]    strb,
-                                    busy;
-
-    assign fpnew_op     = operation_i == softex_pkg::MUL ? fpnew_pkg::MUL : fpnew_pkg::ADD;
-    assign op_mod       = operation_i == softex_pkg::MUL ? op_mod_mul_i : op_mod_add_i;
-    assign strb         = operation_i == softex_pkg::MUL ? mul_strb_i : add_strb_i;
-
-    assign fma_i_valid  = operation_i == softex_pkg::MUL ? mul_valid_i & mul_scal_valid_i : add_valid_i & add_scal_valid_i;
-    assign fma_i_ready  = o_operations [0] == softex_pkg::MUL ? mul_ready_i : add_ready_i;
-
-    assign fma_i_aux    = operation_i == softex_pkg::MUL ? mul_tag_i : add_tag_i;
-
-    for (genvar i = 0; i < VECT_WIDTH; i++) begin
-        assign fma_operands [i][0] = mul_scal_i;
-        assign fma_operands [i][1] = operation_i == softex_pkg::MUL ? mul_vect_i [i] : add_vect_i [i];
-        assign fma_operands [i][2] = add_scal_i;
-
-        fpnew_fma #(
-            .FpFormat       (   FPFORMAT                ),
-            .NumPipeRegs    (   NUM_REGS                ),
-            .PipeConfig     (   REG_POS_CVFPU           ),
-            .TagType        (   softex_pkg::operation_t ),
-            .AuxType        (   TAG_TYPE                )
-        ) i_addmul_fma (
-            .clk_i              (   clk_i               ),
-            .rst_ni             (   rst_ni              ),
-            .operands_i         (   fma_operands [i]    ),
-            .is_boxed_i         (   '1                  ),
-            .rnd_mode_i         (   round_mode_i        ),
-            .op_i               (   fpnew_op            ),
-            .op_mod_i           (   op_mod              ),
-            .tag_i              (   operation_i         ),
-            .mask_i             (   strb [i]            ),
-            .aux_i              (   fma_i_aux           ),
-            .in_valid_i         (   fma_i_valid         ),
-            .in_ready_o         (   fma_readies [i]     ),
-            .flush_i            (   clear_i             ),
-            .result_o           (   fma_res [i]         ),
-            .status_o           (                       ),
-            .extension_bit_o    (                       ),
-            .tag_o              (   o_operations [i]    ),
-            .mask_o             (   fma_o_strb [i]      ),
-            .aux_o              (   fma_o_auxs [i]      ),
-            .out_valid_o        (   fma_valids [i]      ),
-            .out_ready_i        (   fma_i_ready         ),
-            .busy_o             (   busy [i]            )
-        );
-    end
+        logic   op_mod;
+
+        logic   [VECT_WIDTH - 1 : 0]    strb,
+                                        busy;
+
+        assign fpnew_op     = operation_i == softex_pkg::MUL ? (mul_fma_i ? fpnew_pkg::FMADD : fpnew_pkg::MUL) : fpnew_pkg::ADD;
+        assign op_mod       = operation_i == softex_pkg::MUL ? op_mod_mul_i : op_mod_add_i;
+        assign strb         = operation_i == softex_pkg::MUL ? mul_strb_i : add_strb_i;
+
+        assign fma_i_valid  = operation_i == softex_pkg::MUL ? mul_valid_i & mul_scal_valid_i : add_valid_i & add_scal_valid_i;
+        assign fma_i_ready  = o_operations [0] == softex_pkg::MUL ? mul_ready_i : add_ready_i;
 
-    assign fma_o_tag    = fma_o_auxs [0];
+        assign fma_i_aux    = operation_i == softex_pkg::MUL ? mul_tag_i : add_tag_i;
 
-    assign busy_o       = |busy;
+        for (genvar i = 0; i < VECT_WIDTH; i++) begin
+            assign fma_operands [i][0] = mul_scal_i;
+            assign fma_operands [i][1] = operation_i == softex_pkg::MUL ? mul_vect_i [i] : add_vect_i [i];
+            assign fma_operands [i][2] = operation_i == softex_pkg::MUL ? mul_add_scal_i : add_scal_i;
 
-    assign add_res_o    = fma_res;
-    assign add_strb_o   = fma_o_strb;
-    assign add_tag_o    = fma_o_tag;
+            fpnew_fma #(
+                .FpFormat       (   FPFORMAT                ),
+                .NumPipeRegs    (   NUM_REGS                ),
+                .PipeConfig     (   REG_POS_CVFPU           ),
+                .TagType        (   softex_pkg::operation_t ),
+                .AuxType        (   TAG_TYPE                )
+            ) i_addmul_fma (
+                .clk_i              (   clk_i               ),
+                .rst_ni             (   rst_ni              ),
+                .operands_i         (   fma_operands [i]    ),
+                .is_boxed_i         (   '1                  ),
+                .rnd_mode_i         (   round_mode_i        ),
+                .op_i               (   fpnew_op            ),
+                .op_mod_i           (   op_mod              ),
+                .tag_i              (   operation_i         ),
+                .mask_i             (   strb [i]            ),
+                .aux_i              (   fma_i_aux           ),
+                .in_valid_i         (   fma_i_valid         ),
+                .in_ready_o         (   fma_readies [i]     ),
+                .flush_i            (   clear_i             ),
+                .result_o           (   fma_res [i]         ),
+                .status_o           (                       ),
+                .extension_bit_o    (                       ),
+                .tag_o              (   o_operations [i]    ),
+                .mask_o             (   fma_o_strb [i]      ),
+                .aux_o              (   fma_o_auxs [i]      ),
+                .out_valid_o        (   fma_valids [i]      ),
+                .out_ready_i        (   fma_i_ready         ),
+                .busy_o             (   busy [i]            )
+            );
+        end
 
-    assign mul_res_o    = fma_res;
-    assign mul_strb_o   = fma_o_strb;
-    assign mul_tag_o    = fma_o_tag;
+        assign fma_o_tag    = fma_o_auxs [0];
 
-    assign add_ready_o  = operation_i == softex_pkg::ADD ? fma_readies [0] & add_scal_valid_i : '0;
-    assign mul_ready_o  = operation_i == softex_pkg::MUL ? fma_readies [0] & mul_scal_valid_i : '0;
+        assign busy_o       = |busy;
 
-    assign add_valid_o  = o_operations [0] == softex_pkg::ADD ? fma_valids [0] : '0;
-    assign mul_valid_o  = o_operations [0] == softex_pkg::MUL ? fma_valids [0] : '0;
+        assign add_res_o    = fma_res;
+        assign add_strb_o   = fma_o_strb;
+        assign add_tag_o    = fma_o_tag;
+
+        assign mul_res_o    = fma_res;
+        assign mul_strb_o   = fma_o_strb;
+        assign mul_tag_o    = fma_o_tag;
+
+        assign add_ready_o  = operation_i == softex_pkg::ADD ? fma_readies [0] & add_scal_valid_i : '0;
+        assign mul_ready_o  = operation_i == softex_pkg::MUL ? fma_readies [0] & mul_scal_valid_i : '0;
+
+        assign add_valid_o  = o_operations [0] == softex_pkg::ADD ? fma_valids [0] : '0;
+        assign mul_valid_o  = o_operations [0] == softex_pkg::MUL ? fma_valids [0] : '0;
+    end
 
 endmodule
\ No newline at end of file
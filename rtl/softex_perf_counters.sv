@@ -0,0 +1,43 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+module softex_perf_counters
+import softex_pkg::*;
+#(
+    parameter int unsigned  N_COUNTERS  = N_PERF_CNT    ,
+    parameter int unsigned  CNT_WIDTH   = PERF_CNT_W
+) (
+    input   logic                                               clk_i       ,
+    input   logic                                               rst_ni      ,
+    input   logic                                               clear_i     ,
+    input   logic [N_COUNTERS - 1 : 0] [CNT_WIDTH - 1 : 0]      inc_i       ,
+    input   logic [$clog2(N_COUNTERS) - 1 : 0]                  idx_i       ,
+    output  logic [CNT_WIDTH - 1 : 0]                           cnt_o
+);
+
+    /*  Free running counters, each one incremented by the corresponding entry of "inc_i" every cycle. *
+     *  The counters wrap around and are only reset by the soft clear.                                  */
+
+    logic [N_COUNTERS - 1 : 0] [CNT_WIDTH - 1 : 0]  counters_q;
+
+    for (genvar i = 0; i < N_COUNTERS; i++) begin : gen_counters
+        always_ff @(posedge clk_i or negedge rst_ni) begin
+            if (~rst_ni) begin
+                counters_q [i] <= '0;
+            end else begin
+                if (clear_i) begin
+                    counters_q [i] <= '0;
+                end else if (inc_i [i] != '0) begin
+                    counters_q [i] <= counters_q [i] + inc_i [i];
+                end
+            end
+        end
+    end
+
+    assign cnt_o    = idx_i < N_COUNTERS ? counters_q [idx_i] : '0;
+
+endmodule
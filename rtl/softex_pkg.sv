@@ -8,16 +8,22 @@
 import fpnew_pkg::*;
 
 package softex_pkg;
-    parameter int unsigned  DATA_W  = 128 + 32;
+    parameter int unsigned  DATA_W      = 128 + 32;
+    parameter int unsigned  DATA_W_MAX  = 512 + 32; // Widest TCDM port supported by the streamer
 
     parameter int unsigned  ECC_CHUNK_SIZE = 32;
-    parameter int unsigned  ECC_N_CHUNK    = DATA_W / ECC_CHUNK_SIZE;
+    parameter int unsigned  ECC_N_CHUNK    = DATA_W_MAX / ECC_CHUNK_SIZE;
 
-    parameter int unsigned  N_CTRL_CNTX         = 2;
-    parameter int unsigned  N_CTRL_REGS         = 6;
-    parameter int unsigned  N_CTRL_STATE_SLOTS  = 2;
+    parameter int unsigned  N_CTRL_CNTX         = 4;    // Jobs that can be queued in the control slave, they still run one after the other
+    parameter int unsigned  N_CTRL_REGS         = 22;
+    parameter int unsigned  N_CTRL_STATE_SLOTS  = 16;   // State slots kept on chip, the others live in the TCDM cache area
     parameter int unsigned  CTRL_REGFILE_SCM    = 0;
 
+    parameter int unsigned  ROW_BUF_DEPTH       = 256;  // Beats of the on-chip row buffer, 0 to disable it
+    parameter bit           DUAL_ROW_LANE       = 0;    // Second normalisation lane and row buffer bank, lets CMD_DUAL_ROW overlap consecutive rows
+    parameter int unsigned  TOPK_MAX            = 8;    // Largest top-k list recorded by softex_topk
+    parameter bit           SPLIT_LDST_PORTS    = 0;    // Separate TCDM ports for the loads and the stores, see softex_streamer
+
     parameter fpnew_pkg::fp_format_e    FPFORMAT_IN     = fpnew_pkg::FP16ALT;
     parameter fpnew_pkg::fp_format_e    FPFORMAT_ACC    = fpnew_pkg::FP32;
     parameter int unsigned              N_NEWTON_ITERS  = 2;
@@ -57,6 +63,13 @@ package softex_pkg;
     parameter int unsigned  EXPU_GAMMA_1_FIXED          = int'(EXPU_GAMMA_1_REAL * 2 ** EXPU_CONSTANT_FRACTION);
     parameter int unsigned  EXPU_GAMMA_2_FIXED          = int'(EXPU_GAMMA_2_REAL * 2 ** EXPU_CONSTANT_FRACTION);
 
+    //Logarithm constants, FP32 (FPFORMAT_ACC). ln(1 + t) ~ t * (C0 + C1 * t + ... + C4 * t^4) for t in [sqrt(2)/2 - 1, sqrt(2) - 1)
+    parameter int unsigned  N_LOG_COEFFS                = 5;
+    parameter logic [31:0]  LOG_COEFFS [N_LOG_COEFFS]   = '{32'h3f7ffdd8, 32'hbeffb6bf, 32'h3eac32c2, 32'hbe8ace65, 32'h3e3577ca};
+    parameter logic [31:0]  LOG_LN2                     = 32'h3f317218;
+    parameter logic [31:0]  LOG_SQRT2_MANT              = 32'h003504f3; // Mantissa of sqrt(2), larger mantissas are halved
+    parameter int unsigned  LOG_EXP_OFFS                = 256;          // The exponent is extracted as 2^23 + LOG_EXP_OFFS + e
+
     //Register file indexes
     parameter int unsigned  IN_ADDR         = 0;
     parameter int unsigned  OUT_ADDR        = 1;
@@ -64,6 +77,22 @@ package softex_pkg;
     parameter int unsigned  COMMANDS        = 3;
     parameter int unsigned  CACHE_BASE_ADDR = 4;
     parameter int unsigned  CAST_CTRL       = 5;
+    parameter int unsigned  DESC_ADDR       = 6;
+    parameter int unsigned  DESC_COUNT      = 7;
+    parameter int unsigned  ROWS            = 8;
+    parameter int unsigned  IN_ROW_STRIDE   = 9;
+    parameter int unsigned  OUT_ROW_STRIDE  = 10;
+    parameter int unsigned  SCALE           = 11;
+    parameter int unsigned  VALID_LEN       = 12;
+    parameter int unsigned  STATS_ADDR      = 13;
+    parameter int unsigned  PREFETCH_SLOT   = 14;
+    parameter int unsigned  CPL_ADDR        = 15;
+    parameter int unsigned  CPL_COUNT       = 16;
+    parameter int unsigned  EVT_CTRL        = 17;
+    parameter int unsigned  ACCURACY_CTRL   = 18;
+    parameter int unsigned  OUT_CTRL        = 19;
+    parameter int unsigned  TOPK_ADDR       = 20;
+    parameter int unsigned  THRESHOLD       = 21;
 
     parameter int unsigned  CMD_ACC_ONLY        = 0;
     parameter int unsigned  CMD_DIV_ONLY        = 1;
@@ -73,6 +102,84 @@ package softex_pkg;
     parameter int unsigned  CMD_NO_OP           = 5;
     parameter int unsigned  CMD_INT_INPUT       = 6;
     parameter int unsigned  CMD_INT_OUTPUT      = 7;
+    parameter int unsigned  CMD_DESC_MODE       = 8;
+    parameter int unsigned  CMD_DESC_EVT        = 9;
+    parameter int unsigned  CMD_SCALE           = 10;
+    parameter int unsigned  CMD_MASK            = 11;
+    parameter int unsigned  CMD_CAUSAL          = 12;
+    parameter int unsigned  CMD_STATS_OUT       = 13;
+    parameter int unsigned  CMD_MERGE_STATS     = 14;
+    parameter int unsigned  CMD_DUAL_ROW        = 15;
+
+    //Row statistics: the maximum in the lower word, the denominator in the upper one
+    parameter int unsigned  STATS_BYTES         = 8;
+
+    //Completion records: job id, status and cycles, padded to four words
+    parameter int unsigned  CPL_BYTES           = 16;
+    parameter int unsigned  CPL_DONE            = 0;    // Status bits
+    parameter int unsigned  CPL_EVT             = 1;
+    parameter int unsigned  CPL_DESC            = 2;
+
+    //EVT_CTRL: per-job end of job event options, the period of the coalesced events is in bits [31:16]
+    parameter int unsigned  EVT_SKIP            = 0;    // No event for this job
+    parameter int unsigned  EVT_MARK            = 1;    // Always raise the event for this job
+
+    //ACCURACY_CTRL: per-job accuracy of the exponential and of the reciprocal, all zeros is the most accurate setting
+    parameter int unsigned  ACCURACY_EXP_RAW    = 0;    // Skip the mantissa correction of the exponential
+    parameter int unsigned  ACCURACY_EXP_TRUNC  = 1;    // Truncate instead of rounding in expu_schraudolph
+    parameter int unsigned  ACCURACY_NEWTON     = 4;    // Bits [5:4], Newton-Raphson iterations skipped out of N_NEWTON_ITERS
+
+    //OUT_CTRL: what the job writes back
+    parameter int unsigned  OUT_MODE            = 0;    // Bits [1:0]
+    parameter int unsigned  OUT_MODE_SOFTMAX    = 0;
+    parameter int unsigned  OUT_MODE_LOG        = 1;    // x - max - ln(denominator)
+    parameter int unsigned  OUT_MODE_LSE        = 2;    // Only max + ln(denominator) of each row, at STATS_ADDR
+    parameter int unsigned  OUT_TOPK            = 4;    // Bits [7:4], length of the top-k list of each row written to TOPK_ADDR, 0 disables it
+    parameter int unsigned  OUT_SPARSE          = 8;    // Only the outputs above THRESHOLD are written, as (index, value) entries
+    parameter int unsigned  OUT_ACT             = 12;   // Bits [14:12], elementwise activation instead of a softmax, see softex_act
+    parameter int unsigned  ACT_NONE            = 0;
+    parameter int unsigned  ACT_EXP             = 1;    // exp(x)
+    parameter int unsigned  ACT_SIGMOID         = 2;    // 1 / (1 + exp(-x))
+    parameter int unsigned  ACT_SILU            = 3;    // x * sigmoid(x)
+    parameter int unsigned  ACT_GELU            = 4;    // x * sigmoid(1.703125 * x)
+
+    //Top-k records: per entry the index in the lower word and the output value in the upper one, best first
+    parameter int unsigned  TOPK_ENTRY_BYTES    = 8;
+
+    //Sparse rows: the count of entries in the lower word of a header, then the entries in the top-k layout, by index
+    parameter int unsigned  SPARSE_HDR_BYTES    = 8;
+    parameter int unsigned  SPARSE_ENTRY_BYTES  = 8;
+
+    //Job descriptors, word indexes
+    parameter int unsigned  DESC_WORDS          = 8;
+    parameter int unsigned  DESC_IN_ADDR        = 0;
+    parameter int unsigned  DESC_OUT_ADDR       = 1;
+    parameter int unsigned  DESC_TOT_LEN        = 2;
+    parameter int unsigned  DESC_COMMANDS       = 3;
+    parameter int unsigned  DESC_CAST_CTRL      = 4;
+    parameter int unsigned  DESC_ROWS           = 5;
+    parameter int unsigned  DESC_IN_ROW_STRIDE  = 6;
+    parameter int unsigned  DESC_OUT_ROW_STRIDE = 7;
+
+    //Performance counters, read-only and mapped starting from PERF_CNT_OFFS
+    parameter int unsigned  PERF_CNT_OFFS       = 'h100;
+    parameter int unsigned  PERF_CNT_W          = 32;
+
+    parameter int unsigned  PERF_CYCLES         = 0;    // Cycles in which the accelerator is busy
+    parameter int unsigned  PERF_STATE          = 1;    // Cycles spent in each state of the controller FSM (8 counters)
+    parameter int unsigned  PERF_IN_STALL       = 9;    // Cycles in which the input stream waits for a TCDM grant
+    parameter int unsigned  PERF_OUT_STALL      = 10;   // Cycles in which the output stream waits for a TCDM grant
+    parameter int unsigned  PERF_SLOT_LOAD      = 11;   // Cycles spent loading state slots
+    parameter int unsigned  PERF_SLOT_STORE     = 12;   // Cycles spent storing state slots
+    parameter int unsigned  PERF_RESCALES       = 13;   // Rescaling factors computed after a change of the maximum
+    parameter int unsigned  PERF_ELEMENTS       = 14;   // Elements processed by the completed jobs
+    parameter int unsigned  PERF_IN_BEATS       = 15;   // Beats read by the input stream
+    parameter int unsigned  PERF_OUT_BEATS      = 16;   // Beats written by the output stream
+    parameter int unsigned  PERF_DESCRIPTORS    = 17;   // Descriptors executed
+    parameter int unsigned  PERF_RB_BEATS       = 18;   // Beats replayed from the row buffer
+    parameter int unsigned  PERF_SLOT_HITS      = 19;   // Slot requests served by the on-chip slots
+    parameter int unsigned  PERF_SLOT_MISSES    = 20;   // Slot requests that loaded the slot from memory
+    parameter int unsigned  N_PERF_CNT          = 21;
 
     typedef enum int unsigned   { BEFORE, AFTER, AROUND }   regs_config_t;
     typedef enum logic          { MIN, MAX }                min_max_mode_t;
@@ -89,16 +196,27 @@ package softex_pkg;
         logic [WIDTH_ACC - 1 : 0]   reciprocal;
     } accumulator_flags_t;
 
+    typedef struct packed {
+        logic                       correction;
+        logic                       rounding;
+    } expu_ctrl_t;
+
     typedef struct packed {
         logic                       acc_finished;
         logic                       acc_only;
         logic                       load_reciprocal;
 
+        logic [$clog2(N_NEWTON_ITERS + 1) - 1 : 0]  newton_iters;
+
+        logic                       logarithm;      // The result is ln(denominator) instead of its reciprocal
+        logic                       add_max;        // ... plus the maximum
+
         logic [WIDTH_ACC - 1 : 0]   reciprocal;
     } accumulator_ctrl_t;
 
     typedef struct packed {
         logic                       datapath_busy;
+        logic                       rescale;
 
         logic [WIDTH_IN - 1 : 0]    max;
 
@@ -115,6 +233,19 @@ package softex_pkg;
         logic [WIDTH_IN - 1 : 0]    max;
         logic [WIDTH_ACC - 1 : 0]   denominator;
 
+        logic                       scale_enable;
+        logic [WIDTH_IN - 1 : 0]    scale;
+
+        logic                       mask_enable;
+        logic                       mask_restart;
+        logic [31 : 0]              valid_len;
+
+        logic                       norm_load;
+
+        logic                       log_output;     // The normalisation emits x - max - ln(denominator)
+        logic [2 : 0]               act;            // Elementwise activation of the DIVIDING step, ACT_NONE for a softmax
+
+        expu_ctrl_t                 expu_ctrl;
         accumulator_ctrl_t          accumulator_ctrl;
     } datapath_ctrl_t;
 
@@ -143,12 +274,28 @@ package softex_pkg;
         logic                       fma_inv_valid;
         logic                       first_inv_iter;
 
+        logic                       logging;
+        logic                       fma_log_valid;
+        logic                       log_store;
+        logic [$clog2(N_LOG_COEFFS + 4) - 1 : 0]    log_step;
+
         logic                       load_reciprocal;
 
         logic [WIDTH_ACC - 1: 0]    reciprocal;
     } acc_datapath_ctrl_t;
 
-    typedef enum logic {ALLOC, LOAD} slot_req_op_e;
+    typedef struct packed {
+        logic [31 : 0]  in_addr;
+        logic [31 : 0]  out_addr;
+        logic [31 : 0]  tot_len;
+        logic [31 : 0]  commands;
+        logic [31 : 0]  cast_ctrl;
+        logic [31 : 0]  rows;
+        logic [31 : 0]  in_row_stride;
+        logic [31 : 0]  out_row_stride;
+    } job_params_t;
+
+    typedef enum logic [1:0] {ALLOC, LOAD, PREFETCH} slot_req_op_e;
     typedef enum logic {UPDATE, FREE} slot_update_op_e;
 
     typedef struct packed {
@@ -182,13 +329,83 @@ package softex_pkg;
         slot_update_op_t                update_op;
     } slot_regfile_ctrl_t;
 
+    typedef struct packed {
+        logic                           hit;
+        logic                           miss;
+        logic                           prefetch_room;
+    } slot_regfile_flags_t;
+
+    //Floating point formats selectable at run time for the input and the output, the datapath always works in FPFORMAT_IN
+    typedef enum logic [1:0] {
+        FMT_NATIVE,
+        FMT_FP16,
+        FMT_FP8_E4M3,
+        FMT_FP8_E5M2
+    } io_fmt_e;
+
     typedef struct packed {
         logic signed [6 : 0]    int_bits;
         logic                   is_signed;
 
         logic                   enable;
+
+        io_fmt_e                fp_fmt;
     } cast_ctrl_t;
 
+    typedef struct packed {
+        logic                           in_stall;
+        logic                           out_stall;
+        logic                           in_beat;
+        logic                           out_beat;
+    } streamer_perf_t;
+
+    typedef struct packed {
+        logic                           enable;
+        logic                           start;
+        logic                           load;
+        logic [WIDTH_IN - 1 : 0]        max;
+        logic [WIDTH_ACC - 1 : 0]       denominator;
+        expu_ctrl_t                     expu_ctrl;
+    } merge_ctrl_t;
+
+    typedef struct packed {
+        logic                           busy;
+        logic [WIDTH_IN - 1 : 0]        max;
+        logic [WIDTH_ACC - 1 : 0]       denominator;
+    } merge_flags_t;
+
+    typedef struct packed {
+        logic                           enable;
+        logic                           clear;
+        logic                           start;
+        logic [$clog2(TOPK_MAX + 1) - 1 : 0]    k;
+    } topk_ctrl_t;
+
+    typedef struct packed {
+        logic                           enable;
+        logic                           clear;
+        logic [31 : 0]                  base_addr;
+        logic [31 : 0]                  tot_len;    // Beats of the row
+        logic [WIDTH_IN - 1 : 0]        threshold;
+    } sparse_ctrl_t;
+
+    typedef struct packed {
+        logic                           done;
+        logic [31 : 0]                  count;
+    } sparse_flags_t;
+
+    typedef struct packed {
+        logic                           capture;
+        logic                           replay;
+        logic                           hold;
+        logic                           swap;
+    } row_buf_ctrl_t;
+
+    typedef struct packed {
+        logic                           valid;
+        logic                           beat;
+    } row_buf_flags_t;
+
     typedef struct packed {
         logic [ECC_N_CHUNK-1:0]         data_single_err;
         logic [ECC_N_CHUNK-1:0]         data_multi_err;
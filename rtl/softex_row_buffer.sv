@@ -0,0 +1,177 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+module softex_row_buffer
+import hwpe_stream_package::*;
+import softex_pkg::*;
+#(
+    parameter int unsigned  DATA_WIDTH  = DATA_W - 32   ,
+    parameter int unsigned  DEPTH       = ROW_BUF_DEPTH ,
+    parameter bit           DUAL_ROW    = DUAL_ROW_LANE
+) (
+    input   logic                       clk_i       ,
+    input   logic                       rst_ni      ,
+    input   logic                       clear_i     ,
+    input   row_buf_ctrl_t              ctrl_i      ,
+    output  row_buf_flags_t             flags_o     ,
+
+    hwpe_stream_intf_stream.sink        stream_i    ,
+    hwpe_stream_intf_stream.source      stream_o    ,
+    hwpe_stream_intf_stream.source      lane_o
+);
+
+    /*  The input beats of the accumulation step are stored while they are forwarded to the datapath, so that  *
+     *  the normalisation step can replay them instead of reading the vector from memory a second time.         *
+     *  "capture" restarts the recording, "replay" streams out the recorded beats in the same order.            *
+     *  The content is only valid if the whole vector fitted in the buffer.                                     *
+     *  "hold" stalls the input, keeping the beats of a row fetched ahead of time out of the datapath.          *
+     *  With DUAL_ROW there are two banks: "swap" replays the recorded row on "lane_o", towards the              *
+     *  normalisation lane, while the next row is recorded in the other bank. Without it "swap" is never issued  *
+     *  and only bank 0 is instantiated.                                                                         */
+
+    localparam int unsigned STRB_WIDTH  = DATA_WIDTH / 8;
+    localparam int unsigned ADDR_WIDTH  = DEPTH > 1 ? $clog2(DEPTH) : 1;
+
+    if (DEPTH == 0) begin : gen_no_row_buffer
+        assign stream_o.valid   = stream_i.valid & ~ctrl_i.hold;
+        assign stream_o.data    = stream_i.data;
+        assign stream_o.strb    = stream_i.strb;
+        assign stream_i.ready   = stream_o.ready & ~ctrl_i.hold;
+
+        assign lane_o.valid     = '0;
+        assign lane_o.data      = '0;
+        assign lane_o.strb      = '0;
+
+        assign flags_o.valid    = '0;
+        assign flags_o.beat     = '0;
+    end else begin : gen_row_buffer
+        logic [1 : 0] [$clog2(DEPTH + 1) - 1 : 0]   wr_cnt_q;
+        logic [$clog2(DEPTH + 1) - 1 : 0]           rd_cnt_q;
+
+        logic [1 : 0]   overflow_q;
+
+        logic   wr_bank_q,
+                rd_bank_q,
+                to_lane_q,
+                replaying_q,
+                rvalid_q;
+
+        logic   write,
+                read,
+                out_ready;
+
+        logic [1 : 0] [DATA_WIDTH + STRB_WIDTH - 1 : 0] rdata;
+
+        assign write        = stream_i.valid & stream_i.ready & (wr_cnt_q [wr_bank_q] < DEPTH);
+
+        assign out_ready    = to_lane_q ? lane_o.ready : stream_o.ready;
+
+        // A new word is read whenever the output register is empty or is being consumed
+        assign read         = replaying_q & (rd_cnt_q < wr_cnt_q [rd_bank_q]) & (~rvalid_q | out_ready);
+
+        always_ff @(posedge clk_i or negedge rst_ni) begin : counters
+            if (~rst_ni) begin
+                wr_cnt_q    <= '0;
+                rd_cnt_q    <= '0;
+                overflow_q  <= '0;
+                wr_bank_q   <= '0;
+                rd_bank_q   <= '0;
+                to_lane_q   <= '0;
+                replaying_q <= '0;
+                rvalid_q    <= '0;
+            end else begin
+                if (clear_i) begin
+                    wr_cnt_q    <= '0;
+                    rd_cnt_q    <= '0;
+                    overflow_q  <= '0;
+                    wr_bank_q   <= '0;
+                    rd_bank_q   <= '0;
+                    to_lane_q   <= '0;
+                    replaying_q <= '0;
+                    rvalid_q    <= '0;
+                end else if (ctrl_i.replay | ctrl_i.swap) begin
+                    rd_cnt_q    <= '0;
+                    rd_bank_q   <= wr_bank_q;
+                    to_lane_q   <= ctrl_i.swap;
+                    replaying_q <= '1;
+                    rvalid_q    <= '0;
+
+                    if (ctrl_i.swap) begin
+                        wr_bank_q   <= ~wr_bank_q;
+                    end
+                end else begin
+                    // The row replayed on the lane is not affected by the recording of the next one
+                    if (ctrl_i.capture) begin
+                        wr_cnt_q [wr_bank_q]    <= '0;
+                        overflow_q [wr_bank_q]  <= '0;
+                    end else if (write) begin
+                        wr_cnt_q [wr_bank_q]    <= wr_cnt_q [wr_bank_q] + 1;
+                    end
+
+                    if (~ctrl_i.capture & stream_i.valid & stream_i.ready & (wr_cnt_q [wr_bank_q] == DEPTH)) begin
+                        overflow_q [wr_bank_q]  <= '1;
+                    end
+
+                    if (read) begin
+                        rd_cnt_q    <= rd_cnt_q + 1;
+                        rvalid_q    <= '1;
+                    end else if (out_ready) begin
+                        rvalid_q    <= '0;
+                    end
+
+                    if (replaying_q & (rd_cnt_q == wr_cnt_q [rd_bank_q]) & (~rvalid_q | out_ready)) begin
+                        replaying_q <= '0;
+                    end
+                end
+            end
+        end
+
+        for (genvar b = 0; b < (DUAL_ROW ? 2 : 1); b++) begin : gen_bank
+            logic   bank_write,
+                    bank_read;
+
+            assign bank_write   = write & (wr_bank_q == b);
+            assign bank_read    = read & (rd_bank_q == b);
+
+            tc_sram #(
+                .NumWords   (   DEPTH                       ),
+                .DataWidth  (   DATA_WIDTH + STRB_WIDTH     ),
+                .ByteWidth  (   DATA_WIDTH + STRB_WIDTH     ),
+                .NumPorts   (   1                           ),
+                .Latency    (   1                           )
+            ) i_row_sram (
+                .clk_i      (   clk_i                                                   ),
+                .rst_ni     (   rst_ni                                                  ),
+                .req_i      (   bank_write | bank_read                                  ),
+                .we_i       (   bank_write                                              ),
+                .addr_i     (   bank_write ? wr_cnt_q [b] [ADDR_WIDTH - 1 : 0] : rd_cnt_q [ADDR_WIDTH - 1 : 0]  ),
+                .wdata_i    (   {stream_i.strb, stream_i.data}                          ),
+                .be_i       (   '1                                                      ),
+                .rdata_o    (   rdata [b]                                               )
+            );
+        end
+
+        if (~DUAL_ROW) begin : gen_no_lane_bank
+            assign rdata [1]    = '0;
+        end
+
+        // While replaying towards the datapath the input stream is stalled, it is not expected to carry any data
+        assign stream_i.ready   = ~(replaying_q & ~to_lane_q) & ~ctrl_i.hold & stream_o.ready;
+
+        assign stream_o.valid   = (replaying_q & ~to_lane_q) ? rvalid_q : stream_i.valid & ~ctrl_i.hold;
+        assign stream_o.data    = (replaying_q & ~to_lane_q) ? rdata [rd_bank_q] [DATA_WIDTH - 1 : 0] : stream_i.data;
+        assign stream_o.strb    = (replaying_q & ~to_lane_q) ? rdata [rd_bank_q] [DATA_WIDTH +: STRB_WIDTH] : stream_i.strb;
+
+        assign lane_o.valid     = replaying_q & to_lane_q & rvalid_q;
+        assign lane_o.data      = rdata [rd_bank_q] [DATA_WIDTH - 1 : 0];
+        assign lane_o.strb      = rdata [rd_bank_q] [DATA_WIDTH +: STRB_WIDTH];
+
+        assign flags_o.valid    = ~overflow_q [wr_bank_q] & ~(replaying_q & ~to_lane_q);
+        assign flags_o.beat     = replaying_q & rvalid_q & out_ready;
+    end
+
+endmodule
@@ -17,6 +17,7 @@ import hci_package::*;
     input   slot_regfile_ctrl_t         ctrl_i          ,
     
     output  slot_t                      slot_o          ,
+    output  slot_regfile_flags_t        flags_o         ,
     output  hci_streamer_ctrl_t         store_ctrl_o    ,
     output  hci_streamer_ctrl_t         load_ctrl_o     ,
 
@@ -34,9 +35,16 @@ import hci_package::*;
      *      - ALLOC, used to at the start of the operation to reserve a slot and mark it as valid                       *
      *      - LOAD, used before starting each partial operation to request a specific slot to be loaded if it is not    *
                     in the accelerator                                                                                  *
+     *      - PREFETCH, same as LOAD but the slot is not reserved, used to bring a slot in ahead of the job using it    *
      *  Updates, pushed at the end of each partial operation, divided into:                                             *
      *      - UPDATE, used at the end of each partial operation to update the current maximum and denominator           *
-     *      - FREE, used at the end of the operation to free the slot and make it available to other users              */
+     *      - FREE, used at the end of the operation to free the slot and make it available to other users              *
+     *  When no slot is free, the least recently used one among those not reserved by a pending job is replaced.        *
+     *  The requests of the jobs are never refused, so the request FIFO always keeps room for one per context and one   *
+     *  for the descriptor fetcher. Prefetches are only hints and are dropped by the control when that room is reached. */
+
+    localparam int unsigned REQ_FIFO_DEPTH  = 2 * (N_CONTEXT % 2 == 0 ? N_CONTEXT + 2 : N_CONTEXT + 1);  // Must be a multiple of 2
+    localparam int unsigned REQ_RESERVED    = N_CONTEXT + 1;
 
     typedef struct packed {
         logic [ACC_WIDTH - 1 : 0]       denominator;
@@ -57,13 +65,18 @@ import hci_package::*;
     flags_fifo_t    req_fifo_flags,
                     update_fifo_flags;
 
+    logic [$clog2(REQ_FIFO_DEPTH + 1) - 1 : 0]  req_cnt_q;
+
     reg_slot_t [N_STATE_SLOTS - 1 : 0] slots_q;
     reg_slot_t slot_d;
 
     logic [$clog2(N_STATE_SLOTS) - 1 : 0]   free_slot_ptr;
     logic   free_valid;
 
-    logic [$clog2(N_STATE_SLOTS) - 1 : 0]   zero_uses_slot_ptr;
+    logic [$clog2(N_STATE_SLOTS) - 1 : 0]   lru_slot_ptr;
+    logic   lru_valid;
+
+    logic [N_STATE_SLOTS - 1 : 0] [$clog2(N_STATE_SLOTS) - 1 : 0]  lru_age_q;
 
     logic [$clog2(N_STATE_SLOTS) - 1 : 0]   slot_out_ptr;
 
@@ -77,6 +90,8 @@ import hci_package::*;
 
     logic [$clog2(N_STATE_SLOTS) - 1 : 0]   target_slot_ptr;
 
+    logic [$clog2(N_STATE_SLOTS) - 1 : 0]   enabled_slot_ptr;
+
     logic [N_STATE_SLOTS - 1 : 0]   target_enable;
 
     slot_req_op_t       current_request;
@@ -105,8 +120,8 @@ import hci_package::*;
             update,
             slot_enable;
 
-    hwpe_stream_intf_stream #(.DATA_WIDTH(N_BITS_ADDR + 1))  slot_req_fifo_d  (.clk(clk_i));
-    hwpe_stream_intf_stream #(.DATA_WIDTH(N_BITS_ADDR + 1))  slot_req_fifo_q  (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH($bits(slot_req_op_t)))  slot_req_fifo_d  (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH($bits(slot_req_op_t)))  slot_req_fifo_q  (.clk(clk_i));
 
     hwpe_stream_intf_stream #(.DATA_WIDTH(N_BITS_ADDR + 1 +  IN_WIDTH + ACC_WIDTH))  slot_update_fifo_d  (.clk(clk_i));
     hwpe_stream_intf_stream #(.DATA_WIDTH(N_BITS_ADDR + 1 +  IN_WIDTH + ACC_WIDTH))  slot_update_fifo_q  (.clk(clk_i));
@@ -188,21 +203,22 @@ import hci_package::*;
     end
 
 
-    // 0 uses slot
+    // Least recently used slot among the ones with 0 uses
 
-    always_comb begin : zero_uses_slot_ptr_assignment
-        zero_uses_slot_ptr = '0;
+    always_comb begin : lru_slot_ptr_assignment
+        lru_slot_ptr    = '0;
+        lru_valid       = '0;
 
         for (int i = 0; i < N_STATE_SLOTS; i++) begin
-            if (slots_q[i].uses == '0) begin
-                zero_uses_slot_ptr = i;
-                break;
+            if ((slots_q[i].uses == '0) && (~lru_valid || (lru_age_q[i] > lru_age_q[lru_slot_ptr]))) begin
+                lru_slot_ptr    = i;
+                lru_valid       = '1;
             end
         end
     end
 
     // This is the index of the slot that will be replaced
-    assign slot_out_ptr = free_valid ? free_slot_ptr : zero_uses_slot_ptr;
+    assign slot_out_ptr = free_valid ? free_slot_ptr : lru_slot_ptr;
 
     assign current_request  = slot_req_op_t'(slot_req_fifo_q.data);
     assign current_update   = slot_update_op_t'(slot_update_fifo_q.data);
@@ -215,8 +231,8 @@ import hci_package::*;
     assign slot_req_fifo_d.strb     = '1;
 
     hwpe_stream_fifo #(
-        .DATA_WIDTH (   N_BITS_ADDR + 1                                     ),
-        .FIFO_DEPTH (   N_CONTEXT % 2 == 0 ? N_CONTEXT + 2 : N_CONTEXT + 1  )   //FIFO_DEPTH must be a multiple of 2
+        .DATA_WIDTH (   $bits(slot_req_op_t)    ),
+        .FIFO_DEPTH (   REQ_FIFO_DEPTH          )
     ) i_req_fifo (
         .clk_i      (   clk_i           ),
         .rst_ni     (   rst_ni          ),
@@ -228,6 +244,21 @@ import hci_package::*;
 
     assign slot_req_fifo_q.ready    = request_pop;
 
+    // Occupancy of the request FIFO, a prefetch is only accepted while the reserved entries are left free
+    always_ff @(posedge clk_i or negedge rst_ni) begin : req_counter
+        if (~rst_ni) begin
+            req_cnt_q   <= '0;
+        end else begin
+            if (clear_i) begin
+                req_cnt_q   <= '0;
+            end else begin
+                req_cnt_q   <= req_cnt_q + (slot_req_fifo_d.valid & slot_req_fifo_d.ready) - (slot_req_fifo_q.valid & slot_req_fifo_q.ready);
+            end
+        end
+    end
+
+    assign flags_o.prefetch_room    = req_cnt_q < (REQ_FIFO_DEPTH - REQ_RESERVED);
+
 
     assign slot_update_fifo_d.data  = {ctrl_i.update_op};
     assign slot_update_fifo_d.valid = ctrl_i.update_valid;
@@ -321,12 +352,12 @@ import hci_package::*;
                     slot_enable     = '1;
                     update_pop      = '1;
                 end else if (request_valid) begin
-                    if (target_present) begin   // This can only happen with LOAD operations
-                        inc_uses    = '1;
+                    if (target_present) begin   // This can only happen with LOAD and PREFETCH operations
+                        inc_uses    = current_request.op == LOAD;
                         slot_enable = '1;
                         request_pop = '1;
                     end else if (free_valid) begin  // The slot is not loaded but there is room for it
-                        if (current_request.op == LOAD) begin
+                        if (current_request.op != ALLOC) begin
                             start_load  = '1;
 
                             next_state  = WAIT_LOAD;
@@ -335,6 +366,8 @@ import hci_package::*;
                             slot_enable = '1;
                             request_pop = '1;
                         end
+                    end else if ((current_request.op == PREFETCH) & ~lru_valid) begin  // Every slot is reserved, the prefetch is dropped
+                        request_pop = '1;
                     end else begin  // A slot has to be stored before loading / acquiring the new one
                         start_store = '1;
                         store_valid = '1;
@@ -415,7 +448,7 @@ import hci_package::*;
         end else if (acquire) begin
             slot_d.uses = 1;
         end else if (load_i.valid) begin
-            slot_d.uses = 1;
+            slot_d.uses = current_request.op == PREFETCH ? 0 : 1;
         end else if (flush) begin
             slot_d.uses = '0;
         end
@@ -429,13 +462,11 @@ import hci_package::*;
         end
     end
 
+    // If the target is not present when we update this means that we are replacing a slot 
+    assign enabled_slot_ptr = target_present ? target_slot_ptr : slot_out_ptr;
+
     for (genvar i = 0; i < N_STATE_SLOTS; i++) begin : generate_state_slots
-        // If the target is not present when we update this means that we are replacing a slot 
-        assign target_enable [i]    = slot_enable && (
-                                        target_present  ?   target_slot_ptr     == i    :
-                                        free_valid      ?   free_slot_ptr       == i    :
-                                                            zero_uses_slot_ptr  == i
-                                    );
+        assign target_enable [i]    = slot_enable && (enabled_slot_ptr == i);
 
         always_ff @(posedge clk_i or negedge rst_ni) begin : slot_register
             if (~rst_ni) begin
@@ -450,4 +481,32 @@ import hci_package::*;
         end
     end
 
+    /*  Every slot has a distinct age, 0 being the most recently used. A slot is used every time it is written:   *
+     *  it becomes the youngest and the slots that were younger than it get one step older.                      */
+    always_ff @(posedge clk_i or negedge rst_ni) begin : lru_register
+        if (~rst_ni) begin
+            for (int i = 0; i < N_STATE_SLOTS; i++) begin
+                lru_age_q [i] <= i;
+            end
+        end else begin
+            if (clear_i) begin
+                for (int i = 0; i < N_STATE_SLOTS; i++) begin
+                    lru_age_q [i] <= i;
+                end
+            end else if (slot_enable) begin
+                for (int i = 0; i < N_STATE_SLOTS; i++) begin
+                    if (i == enabled_slot_ptr) begin
+                        lru_age_q [i] <= '0;
+                    end else if (lru_age_q [i] < lru_age_q [enabled_slot_ptr]) begin
+                        lru_age_q [i] <= lru_age_q [i] + 1;
+                    end
+                end
+            end
+        end
+    end
+
+    // Requests served without moving data hit in the slot store, every load is a miss
+    assign flags_o.hit  = request_pop & (current_state == IDLE) & target_present;
+    assign flags_o.miss = start_load;
+
 endmodule
\ No newline at end of file
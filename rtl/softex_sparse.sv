@@ -0,0 +1,191 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+`include "softex_macros.svh"
+
+module softex_sparse
+import hwpe_stream_package::*;
+import hci_package::*;
+import softex_pkg::*;
+#(
+    parameter int unsigned              DATA_WIDTH  = DATA_W - 32   ,
+    parameter fpnew_pkg::fp_format_e    IN_FPFORMAT = FPFORMAT_IN
+) (
+    input   logic                           clk_i           ,
+    input   logic                           rst_ni          ,
+    input   logic                           clear_i         ,
+    input   sparse_ctrl_t                   ctrl_i          ,
+    output  sparse_flags_t                  flags_o         ,
+    output  hci_streamer_ctrl_t             store_ctrl_o    ,
+    input   hci_streamer_flags_t            store_flags_i   ,
+
+    hwpe_stream_intf_stream.sink            stream_i        ,
+    hwpe_stream_intf_stream.source          store_o
+);
+
+    /*  Compresses the normalised beats of a row into (index, value) entries, keeping only the outputs above the   *
+     *  threshold. The surviving elements of a beat are taken one per cycle, so a beat with at most one of them    *
+     *  does not stall the datapath. The entries are packed into full beats, each stored with its own request      *
+     *  starting from "base_addr"; the last one is flushed with the strobes of the entries it holds. "done" is     *
+     *  raised once all the "tot_len" beats of the row are consumed and written, with the number of entries.       */
+
+    localparam int unsigned IN_WIDTH    = fpnew_pkg::fp_width(IN_FPFORMAT);
+    localparam int unsigned VECT_WIDTH  = DATA_WIDTH / IN_WIDTH;
+    localparam int unsigned N_SLOTS     = DATA_WIDTH / (SPARSE_ENTRY_BYTES * 8);
+
+    typedef enum logic [2:0] {
+        COLLECT,
+        STORE_REQ,
+        STORE_DATA,
+        STORE_WAIT,
+        DONE
+    } sparse_state_t;
+
+    sparse_state_t  current_state;
+
+    logic [VECT_WIDTH - 1 : 0]  keep,
+                                pend_q;
+
+    logic [DATA_WIDTH - 1 : 0]          beat_q;
+    logic [$clog2(VECT_WIDTH) - 1 : 0]  first;
+
+    logic [31 : 0]  beat_idx_q,
+                    in_beats_q,
+                    out_beats_q,
+                    count_q;
+
+    logic [N_SLOTS - 1 : 0] [SPARSE_ENTRY_BYTES * 8 - 1 : 0]    buf_q;
+    logic [$clog2(N_SLOTS + 1) - 1 : 0]                         fill_q;
+
+    logic   flush_q,
+            drain,
+            row_consumed;
+
+    for (genvar l = 0; l < VECT_WIDTH; l++) begin : gen_keep
+        assign keep [l] = stream_i.strb [IN_WIDTH / 8 * l] & `FP_GT(stream_i.data [IN_WIDTH * l +: IN_WIDTH], ctrl_i.threshold, IN_FPFORMAT);
+    end
+
+    always_comb begin : first_pending
+        first = '0;
+
+        for (int l = VECT_WIDTH - 1; l >= 0; l--) begin
+            if (pend_q [l]) begin
+                first = l;
+            end
+        end
+    end
+
+    assign drain        = (current_state == COLLECT) & (pend_q != '0);
+    assign row_consumed = (in_beats_q == ctrl_i.tot_len) & (pend_q == '0);
+
+    // A new beat is taken while the last pending element of the previous one is drained
+    assign stream_i.ready   = ctrl_i.enable & (current_state == COLLECT) & ((pend_q & (pend_q - 1)) == '0) & (in_beats_q != ctrl_i.tot_len);
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : sparse_entries
+        if (~rst_ni) begin
+            current_state   <= COLLECT;
+            pend_q          <= '0;
+            beat_q          <= '0;
+            beat_idx_q      <= '0;
+            in_beats_q      <= '0;
+            out_beats_q     <= '0;
+            count_q         <= '0;
+            buf_q           <= '0;
+            fill_q          <= '0;
+            flush_q         <= '0;
+        end else begin
+            if (clear_i | ctrl_i.clear) begin
+                current_state   <= COLLECT;
+                pend_q          <= '0;
+                beat_q          <= '0;
+                beat_idx_q      <= '0;
+                in_beats_q      <= '0;
+                out_beats_q     <= '0;
+                count_q         <= '0;
+                buf_q           <= '0;
+                fill_q          <= '0;
+                flush_q         <= '0;
+            end else begin
+                case (current_state)
+                    COLLECT: begin
+                        if (drain) begin
+                            buf_q [fill_q]  <= {32'(beat_q [IN_WIDTH * first +: IN_WIDTH]), 32'(beat_idx_q * VECT_WIDTH + first)};
+                            fill_q          <= fill_q + 1;
+                            count_q         <= count_q + 1;
+                            pend_q [first]  <= '0;
+
+                            if (fill_q + 1 == N_SLOTS) begin
+                                current_state   <= STORE_REQ;
+                            end
+                        end
+
+                        if (stream_i.valid & stream_i.ready) begin
+                            pend_q      <= keep;
+                            beat_q      <= stream_i.data;
+                            beat_idx_q  <= in_beats_q;
+                            in_beats_q  <= in_beats_q + 1;
+                        end else if (ctrl_i.enable & row_consumed) begin
+                            if (fill_q != '0) begin
+                                current_state   <= STORE_REQ;
+                                flush_q         <= '1;
+                            end else begin
+                                current_state   <= DONE;
+                            end
+                        end
+                    end
+
+                    STORE_REQ: begin
+                        if (store_flags_i.ready_start) begin
+                            current_state   <= STORE_DATA;
+                        end
+                    end
+
+                    STORE_DATA: begin
+                        if (store_o.ready) begin
+                            current_state   <= STORE_WAIT;
+                            out_beats_q     <= out_beats_q + 1;
+                        end
+                    end
+
+                    STORE_WAIT: begin
+                        if (store_flags_i.done) begin
+                            current_state   <= flush_q ? DONE : COLLECT;
+                            buf_q           <= '0;
+                            fill_q          <= '0;
+                        end
+                    end
+
+                    DONE: ;
+
+                    default: current_state <= COLLECT;
+                endcase
+            end
+        end
+    end
+
+    assign flags_o.done     = current_state == DONE;
+    assign flags_o.count    = count_q;
+
+    assign store_o.valid    = current_state == STORE_DATA;
+    assign store_o.data     = buf_q;
+
+    // Only the entries in the buffer are written, which matters for the last beat of the row
+    for (genvar b = 0; b < DATA_WIDTH / 8; b++) begin : gen_store_strb
+        assign store_o.strb [b] = b < fill_q * SPARSE_ENTRY_BYTES;
+    end
+
+    assign store_ctrl_o.req_start                       = (current_state == STORE_REQ) & store_flags_i.ready_start;
+    assign store_ctrl_o.addressgen_ctrl.base_addr       = ctrl_i.base_addr + out_beats_q * (DATA_WIDTH / 8);
+    assign store_ctrl_o.addressgen_ctrl.tot_len         = 1;
+    assign store_ctrl_o.addressgen_ctrl.d0_len          = '0;
+    assign store_ctrl_o.addressgen_ctrl.d0_stride       = '0;
+    assign store_ctrl_o.addressgen_ctrl.d1_len          = '0;
+    assign store_ctrl_o.addressgen_ctrl.d1_stride       = '0;
+    assign store_ctrl_o.addressgen_ctrl.d2_stride       = '0;
+    assign store_ctrl_o.addressgen_ctrl.dim_enable_1h   = '0;
+
+endmodule
@@ -0,0 +1,303 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+`include "softex_macros.svh"
+
+module softex_stats_merge
+import hwpe_stream_package::*;
+import softex_pkg::*;
+#(
+    parameter int unsigned              DATA_WIDTH      = DATA_W - 32       ,
+    parameter fpnew_pkg::fp_format_e    IN_FPFORMAT     = FPFORMAT_IN       ,
+    parameter fpnew_pkg::fp_format_e    ACC_FPFORMAT    = FPFORMAT_ACC      ,
+    parameter int unsigned              SUM_REGS_IN     = NUM_REGS_SUM_IN   ,
+    parameter int unsigned              EXP_REGS        = NUM_REGS_EXPU     ,
+    parameter int unsigned              FMA_REGS_ACC    = NUM_REGS_FMA_ACC
+) (
+    input   logic                       clk_i       ,
+    input   logic                       rst_ni      ,
+    input   logic                       clear_i     ,
+    input   merge_ctrl_t                ctrl_i      ,
+    output  merge_flags_t               flags_o     ,
+
+    hwpe_stream_intf_stream.sink        stream_i
+);
+
+    /*  Combines (max, denominator) pairs produced by the STATS_OUT option into a single pair.  *
+     *  Each pair occupies STATS_BYTES bytes: the maximum in the lower word and the             *
+     *  denominator in the upper one. Pairs are merged one at a time as                         *
+     *      M = max(m_a, m_b)                                                                   *
+     *      D = d_hi + d_lo * exp(m_lo - m_hi)                                                  */
+
+    localparam int unsigned IN_WIDTH    = fpnew_pkg::fp_width(IN_FPFORMAT);
+    localparam int unsigned ACC_WIDTH   = fpnew_pkg::fp_width(ACC_FPFORMAT);
+    localparam int unsigned N_PAIRS     = DATA_WIDTH / (8 * STATS_BYTES);
+
+    typedef enum logic {
+        IDLE,
+        MERGING
+    } merge_state_t;
+
+    merge_state_t   current_state,
+                    next_state;
+
+    logic [$clog2(N_PAIRS + 1) - 1 : 0] pair_idx_q;
+    logic [N_PAIRS - 1 : 0]             pair_strb;
+
+    logic [IN_WIDTH - 1 : 0]    acc_max_q,
+                                pair_max,
+                                hi_max,
+                                lo_max,
+                                max_diff,
+                                exp_res;
+
+    logic [ACC_WIDTH - 1 : 0]   acc_den_q,
+                                pair_den,
+                                hi_den_q,
+                                lo_den_q,
+                                exp_cast,
+                                merge_res;
+
+    logic [IN_WIDTH - 1 : 0]    new_max_q;
+
+    logic   first_q,
+            pair_valid,
+            pair_last,
+            pair_pop;
+
+    logic   launch,
+            diff_valid,
+            exp_ready,
+            exp_valid,
+            cast_valid,
+            merge_valid;
+
+    for (genvar i = 0; i < N_PAIRS; i++) begin : gen_pair_strb
+        assign pair_strb [i]    = stream_i.strb [STATS_BYTES * i];
+    end
+
+    assign pair_max     = stream_i.data [8 * STATS_BYTES * pair_idx_q +: IN_WIDTH];
+    assign pair_den     = stream_i.data [8 * STATS_BYTES * pair_idx_q + 32 +: ACC_WIDTH];
+
+    assign pair_valid   = ctrl_i.enable & stream_i.valid & pair_strb [pair_idx_q];
+    assign pair_last    = ~|(pair_strb >> (pair_idx_q + 1));
+
+    //The first pair is taken as it is, the others go through the merge chain
+    assign launch       = (current_state == IDLE) & pair_valid & ~first_q;
+    assign pair_pop     = ((current_state == IDLE) & pair_valid & first_q) | merge_valid;
+
+    assign stream_i.ready   = ~ctrl_i.enable | (pair_pop & pair_last);
+
+    assign hi_max   = `FP_GT(pair_max, acc_max_q, IN_FPFORMAT) ? pair_max  : acc_max_q;
+    assign lo_max   = `FP_GT(pair_max, acc_max_q, IN_FPFORMAT) ? acc_max_q : pair_max;
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : state_register
+        if (~rst_ni) begin
+            current_state <= IDLE;
+        end else begin
+            if (clear_i)
+                current_state <= IDLE;
+            else
+                current_state <= next_state;
+        end
+    end
+
+    always_comb begin : fsm
+        next_state  = current_state;
+
+        case (current_state)
+            IDLE:       if (launch)         next_state = MERGING;
+            MERGING:    if (merge_valid)    next_state = IDLE;
+        endcase
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : pair_counter
+        if (~rst_ni) begin
+            pair_idx_q <= '0;
+        end else begin
+            if (clear_i | ctrl_i.start)
+                pair_idx_q <= '0;
+            else if (pair_pop)
+                pair_idx_q <= pair_last ? '0 : pair_idx_q + 1;
+        end
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : accumulator
+        if (~rst_ni) begin
+            acc_max_q   <= '0;
+            acc_den_q   <= '0;
+            first_q     <= '1;
+        end else begin
+            if (clear_i) begin
+                acc_max_q   <= '0;
+                acc_den_q   <= '0;
+                first_q     <= '1;
+            end else if (ctrl_i.start) begin
+                acc_max_q   <= ctrl_i.load ? ctrl_i.max         : `NEG_INFTY(IN_FPFORMAT);
+                acc_den_q   <= ctrl_i.load ? ctrl_i.denominator : '0;
+                first_q     <= ~ctrl_i.load;
+            end else if ((current_state == IDLE) & pair_valid & first_q) begin
+                acc_max_q   <= pair_max;
+                acc_den_q   <= pair_den;
+                first_q     <= '0;
+            end else if (merge_valid) begin
+                acc_max_q   <= new_max_q;
+                acc_den_q   <= merge_res;
+            end
+        end
+    end
+
+    //The operands of the pair being merged are held until the end of the chain
+    always_ff @(posedge clk_i or negedge rst_ni) begin : pair_register
+        if (~rst_ni) begin
+            new_max_q   <= '0;
+            hi_den_q    <= '0;
+            lo_den_q    <= '0;
+        end else begin
+            if (clear_i) begin
+                new_max_q   <= '0;
+                hi_den_q    <= '0;
+                lo_den_q    <= '0;
+            end else if (launch) begin
+                new_max_q   <= hi_max;
+                hi_den_q    <= `FP_GT(pair_max, acc_max_q, IN_FPFORMAT) ? pair_den  : acc_den_q;
+                lo_den_q    <= `FP_GT(pair_max, acc_max_q, IN_FPFORMAT) ? acc_den_q : pair_den;
+            end
+        end
+    end
+
+    fpnew_fma #(
+        .FpFormat       (   IN_FPFORMAT             ),
+        .NumPipeRegs    (   SUM_REGS_IN             ),
+        .PipeConfig     (   fpnew_pkg::DISTRIBUTED  ),
+        .TagType        (   logic                   ),
+        .AuxType        (   logic                   )
+    ) i_max_diff (
+        .clk_i              (   clk_i                                   ),
+        .rst_ni             (   rst_ni                                  ),
+        .operands_i         (   {hi_max, lo_max, {(IN_WIDTH){1'b0}}}    ),
+        .is_boxed_i         (   '1                                      ),
+        .rnd_mode_i         (   fpnew_pkg::RNE                          ),
+        .op_i               (   fpnew_pkg::ADD                          ),
+        .op_mod_i           (   '1                                      ),
+        .tag_i              (   '0                                      ),
+        .mask_i             (   '1                                      ),
+        .aux_i              (   '0                                      ),
+        .in_valid_i         (   launch                                  ),
+        .in_ready_o         (                                           ),
+        .flush_i            (   clear_i                                 ),
+        .result_o           (   max_diff                                ),
+        .status_o           (                                           ),
+        .extension_bit_o    (                                           ),
+        .tag_o              (                                           ),
+        .mask_o             (                                           ),
+        .aux_o              (                                           ),
+        .out_valid_o        (   diff_valid                              ),
+        .out_ready_i        (   exp_ready                               ),
+        .busy_o             (                                           )
+    );
+
+    expu_top #(
+        .FPFORMAT   (   IN_FPFORMAT         ),
+        .REG_POS    (   softex_pkg::BEFORE  ),
+        .NUM_REGS   (   EXP_REGS            ),
+        .N_ROWS     (   1                   )
+    ) i_merge_exp (
+        .clk_i      (   clk_i               ),
+        .rst_ni     (   rst_ni              ),
+        .clear_i    (   clear_i             ),
+        .enable_i   (   '1                  ),
+        .ctrl_i     (   ctrl_i.expu_ctrl    ),
+        .valid_i    (   diff_valid          ),
+        .ready_i    (   '1                  ),
+        .strb_i     (   '1                  ),
+        .op_i       (   max_diff            ),
+        .tag_i      (   '0                  ),
+        .res_o      (   exp_res             ),
+        .valid_o    (   exp_valid           ),
+        .ready_o    (   exp_ready           ),
+        .strb_o     (                       ),
+        .tag_o      (                       ),
+        .busy_o     (                       )
+    );
+
+    if (ACC_FPFORMAT != IN_FPFORMAT) begin : gen_exp_cast
+        fpnew_cast_multi #(
+            .FpFmtConfig    (   softex_pkg::fmt_to_conf(ACC_FPFORMAT, IN_FPFORMAT)  ),
+            .IntFmtConfig   (   '0                                                  ),
+            .NumPipeRegs    (   0                                                   ),
+            .PipeConfig     (   fpnew_pkg::BEFORE                                   ),
+            .TagType        (   logic                                               ),
+            .AuxType        (   logic                                               )
+        ) i_exp_cast (
+            .clk_i              (   clk_i                       ),
+            .rst_ni             (   rst_ni                      ),
+            .operands_i         (   {{(ACC_WIDTH - IN_WIDTH){1'b1}}, exp_res}   ),
+            .is_boxed_i         (   '1                          ),
+            .rnd_mode_i         (   fpnew_pkg::RNE              ),
+            .op_i               (   fpnew_pkg::F2F              ),
+            .op_mod_i           (   '0                          ),
+            .src_fmt_i          (   IN_FPFORMAT                 ),
+            .dst_fmt_i          (   ACC_FPFORMAT                ),
+            .int_fmt_i          (   fpnew_pkg::INT8             ),
+            .tag_i              (   '0                          ),
+            .mask_i             (   '0                          ),
+            .aux_i              (   '0                          ),
+            .in_valid_i         (   exp_valid                   ),
+            .in_ready_o         (                               ),
+            .flush_i            (   clear_i                     ),
+            .result_o           (   exp_cast                    ),
+            .status_o           (                               ),
+            .extension_bit_o    (                               ),
+            .tag_o              (                               ),
+            .mask_o             (                               ),
+            .aux_o              (                               ),
+            .out_valid_o        (   cast_valid                  ),
+            .out_ready_i        (   '1                          ),
+            .busy_o             (                               )
+        );
+    end else begin : assign_exp_cast
+        assign exp_cast     = exp_res;
+        assign cast_valid   = exp_valid;
+    end
+
+    fpnew_fma #(
+        .FpFormat       (   ACC_FPFORMAT            ),
+        .NumPipeRegs    (   FMA_REGS_ACC            ),
+        .PipeConfig     (   fpnew_pkg::DISTRIBUTED  ),
+        .TagType        (   logic                   ),
+        .AuxType        (   logic                   )
+    ) i_den_fma (
+        .clk_i              (   clk_i                               ),
+        .rst_ni             (   rst_ni                              ),
+        .operands_i         (   {hi_den_q, exp_cast, lo_den_q}      ),
+        .is_boxed_i         (   '1                                  ),
+        .rnd_mode_i         (   fpnew_pkg::RNE                      ),
+        .op_i               (   fpnew_pkg::FMADD                    ),
+        .op_mod_i           (   '0                                  ),
+        .tag_i              (   '0                                  ),
+        .mask_i             (   '1                                  ),
+        .aux_i              (   '0                                  ),
+        .in_valid_i         (   cast_valid                          ),
+        .in_ready_o         (                                       ),
+        .flush_i            (   clear_i                             ),
+        .result_o           (   merge_res                           ),
+        .status_o           (                                       ),
+        .extension_bit_o    (                                       ),
+        .tag_o              (                                       ),
+        .mask_o             (                                       ),
+        .aux_o              (                                       ),
+        .out_valid_o        (   merge_valid                         ),
+        .out_ready_i        (   '1                                  ),
+        .busy_o             (                                       )
+    );
+
+    assign flags_o.busy         = (current_state != IDLE) | (ctrl_i.enable & stream_i.valid);
+    assign flags_o.max          = acc_max_q;
+    assign flags_o.denominator  = acc_den_q;
+
+endmodule
@@ -15,7 +15,8 @@ import hci_package::*;
 import softex_pkg::*;
 #(
     parameter hci_size_parameter_t `HCI_SIZE_PARAM(Tcdm) = '0,
-    parameter int unsigned ACTUAL_DW = 0
+    parameter int unsigned ACTUAL_DW = 0,
+    parameter bit SPLIT_LDST = SPLIT_LDST_PORTS
 ) (
     input   logic                   clk_i               ,
     input   logic                   rst_ni              ,
@@ -27,17 +28,28 @@ import softex_pkg::*;
     input   hci_streamer_ctrl_t     out_stream_ctrl_i   ,
     input   hci_streamer_ctrl_t     slot_in_ctrl_i      ,
     input   hci_streamer_ctrl_t     slot_out_ctrl_i     ,
+    input   hci_streamer_ctrl_t     desc_ctrl_i         ,
+    input   hci_streamer_ctrl_t     stats_ctrl_i        ,
+    input   hci_streamer_ctrl_t     sparse_ctrl_i       ,
     output  hci_streamer_flags_t    in_stream_flags_o   ,
     output  hci_streamer_flags_t    out_stream_flags_o  ,
     output  hci_streamer_flags_t    slot_in_flags_o     ,
     output  hci_streamer_flags_t    slot_out_flags_o    ,
+    output  hci_streamer_flags_t    desc_flags_o        ,
+    output  hci_streamer_flags_t    stats_flags_o       ,
+    output  hci_streamer_flags_t    sparse_flags_o      ,
+    output  streamer_perf_t         perf_o              ,
 
     hwpe_stream_intf_stream.source  in_stream_o         ,
     hwpe_stream_intf_stream.sink    out_stream_i        ,
     hwpe_stream_intf_stream.source  slot_in_stream_o    ,
     hwpe_stream_intf_stream.sink    slot_out_stream_i   ,
+    hwpe_stream_intf_stream.source  desc_stream_o       ,
+    hwpe_stream_intf_stream.sink    stats_stream_i      ,
+    hwpe_stream_intf_stream.sink    sparse_stream_i     ,
 
-    hci_core_intf.initiator         tcdm
+    hci_core_intf.initiator         tcdm                ,
+    hci_core_intf.initiator         tcdm_st
 );
 
     localparam int unsigned DW = `HCI_SIZE_GET_DW(Tcdm);
@@ -78,15 +90,21 @@ import softex_pkg::*;
         .clk(   clk_i   )
     );
 
-    hci_core_intf #(
-        .DW ( DW )
-    ) tcdm_no_ecc (
-        .clk    (   clk_i   )
+    hwpe_stream_intf_stream #(
+        .DATA_WIDTH ( ACTUAL_DW )
+    ) in_stream_int_cast (
+        .clk(   clk_i   )
+    );
+
+    hwpe_stream_intf_stream #(
+        .DATA_WIDTH ( ACTUAL_DW )
+    ) out_stream_fp_cast (
+        .clk(   clk_i   )
     );
 
     hci_core_intf #(
         .DW ( DW )
-    ) ldst_tcdm [0:0] (
+    ) tcdm_no_ecc (
         .clk    (   clk_i   )
     );
 
@@ -126,36 +144,106 @@ import softex_pkg::*;
             .tcdm_initiator      ( tcdm            )
         );
 
-        assign ecc_errors.data_single_err = data_single_err & {ECC_N_CHUNK{tcdm.r_valid}};
-        assign ecc_errors.data_multi_err  = data_multi_err  & {ECC_N_CHUNK{tcdm.r_valid}};
+        assign ecc_errors.data_single_err = ECC_N_CHUNK'(data_single_err & {(DW/ECC_CHUNK_SIZE){tcdm.r_valid}});
+        assign ecc_errors.data_multi_err  = ECC_N_CHUNK'(data_multi_err  & {(DW/ECC_CHUNK_SIZE){tcdm.r_valid}});
         assign ecc_errors.meta_single_err = meta_single_err & (tcdm.req & tcdm.gnt);
         assign ecc_errors.meta_multi_err  = meta_multi_err  & (tcdm.req & tcdm.gnt);
     end else begin : gen_no_ecc_assign
         hci_core_assign i_no_ecc_assign ( .tcdm_target (tcdm_no_ecc), .tcdm_initiator (tcdm) );
     end
 
-    hci_core_mux_dynamic #(
-        .NB_IN_CHAN             ( 2                            ),
-        .NB_OUT_CHAN            ( 1                            ),
-        .`HCI_SIZE_PARAM(in)    ( `HCI_SIZE_PARAM(Tcdm_no_ecc) )
-    ) i_ldst_mux (
-        .clk_i              (   clk_i       ),
-        .rst_ni             (   rst_ni      ),
-        .clear_i            (   clear_i     ),
-        .in                 (   mux_i_tcdm  ),
-        .out                (   ldst_tcdm   )
-    );
-
-    hci_core_r_valid_filter #(
-        .`HCI_SIZE_PARAM(tcdm_target)   ( `HCI_SIZE_PARAM(Tcdm_no_ecc) )
-    ) i_tcdm_r_valid_filter (
-        .clk_i          (  clk_i            ),
-        .rst_ni         (  rst_ni           ),
-        .clear_i        (  clear_i          ),
-        .enable_i       (  1'b1             ),
-        .tcdm_target    (  ldst_tcdm [0]    ),
-        .tcdm_initiator (  tcdm_no_ecc      )
-    );
+    /*  The load and store channels share "tcdm" through "i_ldst_mux", so that a normalisation alternates the   *
+     *  loads of its inputs and the stores of its outputs. With SPLIT_LDST the store channel gets its own port, *
+     *  "tcdm_st", and the two run concurrently; "tcdm_st" is tied off otherwise.                               */
+
+    if (SPLIT_LDST) begin : gen_split_ldst
+        hci_core_intf #(
+            .DW ( DW )
+        ) tcdm_st_no_ecc (
+            .clk    (   clk_i   )
+        );
+
+        if (EW > 1) begin : gen_st_ecc_encoder
+            logic [DW/ECC_CHUNK_SIZE-1:0] data_single_err, data_multi_err;
+            logic                         meta_single_err, meta_multi_err;
+
+            hci_ecc_enc #(
+                .DW ( DW ),
+                .`HCI_SIZE_PARAM(tcdm_target)    ( `HCI_SIZE_PARAM(Tcdm_no_ecc) ),
+                .`HCI_SIZE_PARAM(tcdm_initiator) ( `HCI_SIZE_PARAM(Tcdm)        )
+            ) i_hci_st_ecc_enc (
+                .r_data_single_err_o ( data_single_err ),
+                .r_data_multi_err_o  ( data_multi_err  ),
+                .r_meta_single_err_o ( meta_single_err ),
+                .r_meta_multi_err_o  ( meta_multi_err  ),
+                .tcdm_target         ( tcdm_st_no_ecc  ),
+                .tcdm_initiator      ( tcdm_st         )
+            );
+        end else begin : gen_st_no_ecc_assign
+            hci_core_assign i_st_no_ecc_assign ( .tcdm_target (tcdm_st_no_ecc), .tcdm_initiator (tcdm_st) );
+        end
+
+        hci_core_r_valid_filter #(
+            .`HCI_SIZE_PARAM(tcdm_target)   ( `HCI_SIZE_PARAM(Tcdm_no_ecc) )
+        ) i_load_r_valid_filter (
+            .clk_i          (  clk_i            ),
+            .rst_ni         (  rst_ni           ),
+            .clear_i        (  clear_i          ),
+            .enable_i       (  1'b1             ),
+            .tcdm_target    (  mux_i_tcdm [0]   ),
+            .tcdm_initiator (  tcdm_no_ecc      )
+        );
+
+        hci_core_r_valid_filter #(
+            .`HCI_SIZE_PARAM(tcdm_target)   ( `HCI_SIZE_PARAM(Tcdm_no_ecc) )
+        ) i_store_r_valid_filter (
+            .clk_i          (  clk_i            ),
+            .rst_ni         (  rst_ni           ),
+            .clear_i        (  clear_i          ),
+            .enable_i       (  1'b1             ),
+            .tcdm_target    (  mux_i_tcdm [1]   ),
+            .tcdm_initiator (  tcdm_st_no_ecc   )
+        );
+    end else begin : gen_shared_ldst
+        hci_core_intf #(
+            .DW ( DW )
+        ) ldst_tcdm [0:0] (
+            .clk    (   clk_i   )
+        );
+
+        hci_core_mux_dynamic #(
+            .NB_IN_CHAN             ( 2                            ),
+            .NB_OUT_CHAN            ( 1                            ),
+            .`HCI_SIZE_PARAM(in)    ( `HCI_SIZE_PARAM(Tcdm_no_ecc) )
+        ) i_ldst_mux (
+            .clk_i              (   clk_i       ),
+            .rst_ni             (   rst_ni      ),
+            .clear_i            (   clear_i     ),
+            .in                 (   mux_i_tcdm  ),
+            .out                (   ldst_tcdm   )
+        );
+
+        hci_core_r_valid_filter #(
+            .`HCI_SIZE_PARAM(tcdm_target)   ( `HCI_SIZE_PARAM(Tcdm_no_ecc) )
+        ) i_tcdm_r_valid_filter (
+            .clk_i          (  clk_i            ),
+            .rst_ni         (  rst_ni           ),
+            .clear_i        (  clear_i          ),
+            .enable_i       (  1'b1             ),
+            .tcdm_target    (  ldst_tcdm [0]    ),
+            .tcdm_initiator (  tcdm_no_ecc      )
+        );
+
+        assign tcdm_st.req      = '0;
+        assign tcdm_st.add      = '0;
+        assign tcdm_st.wen      = '1;
+        assign tcdm_st.data     = '0;
+        assign tcdm_st.be       = '0;
+        assign tcdm_st.r_ready  = '1;
+        assign tcdm_st.user     = '0;
+        assign tcdm_st.id       = '0;
+        assign tcdm_st.ecc      = '0;
+    end
 
     /*      LOAD CHANNEL      */
 
@@ -164,6 +252,14 @@ import softex_pkg::*;
     ) i_cast_in (
         .ctrl_i     (   in_cast_i           ),
         .stream_i   (   in_stream_pre_cast  ),
+        .stream_o   (   in_stream_int_cast  )
+    );
+
+    softex_fp_cast_in #(
+        .DATA_WIDTH (   ACTUAL_DW  )
+    ) i_fp_cast_in (
+        .ctrl_i     (   in_cast_i           ),
+        .stream_i   (   in_stream_int_cast  ),
         .stream_o   (   in_stream_o         )
     );
 
@@ -180,7 +276,7 @@ import softex_pkg::*;
 
     hci_core_intf #(
         .DW ( DW )
-    ) load_mux_i_tcdm [1:0] (
+    ) load_mux_i_tcdm [2:0] (
         .clk    (   clk_i   )
     );
 
@@ -214,6 +310,21 @@ import softex_pkg::*;
         .flags_o        (   slot_in_flags_o     )
     );
 
+    hci_core_source #(
+        .MISALIGNED_ACCESSES    (   1                            ),
+        .`HCI_SIZE_PARAM(tcdm)  (   `HCI_SIZE_PARAM(Tcdm_no_ecc) )
+    ) i_desc_in (
+        .clk_i          (   clk_i               ),
+        .rst_ni         (   rst_ni              ),
+        .test_mode_i    (   '0                  ),
+        .clear_i        (   clear_i             ),
+        .enable_i       (   enable_i            ),
+        .tcdm           (   load_mux_i_tcdm [2] ),
+        .stream         (   desc_stream_o       ),
+        .ctrl_i         (   desc_ctrl_i         ),
+        .flags_o        (   desc_flags_o        )
+    );
+
     hci_core_intf #(
         .DW ( DW )
     ) load_fifo (
@@ -221,7 +332,7 @@ import softex_pkg::*;
     );
 
     hci_core_mux_ooo #(
-        .NB_CHAN                (   2                            ),
+        .NB_CHAN                (   3                            ),
         .`HCI_SIZE_PARAM(out)   (   `HCI_SIZE_PARAM(Tcdm_no_ecc) )
     ) i_load_mux (
         .clk_i              (   clk_i           ),
@@ -258,11 +369,19 @@ import softex_pkg::*;
 
     /*      STORE CHANNEL      */
 
+    softex_fp_cast_out #(
+        .DATA_WIDTH (   ACTUAL_DW  )
+    ) i_fp_cast_out (
+        .ctrl_i     (   out_cast_i              ),
+        .stream_i   (   out_stream_i            ),
+        .stream_o   (   out_stream_fp_cast      )
+    );
+
     softex_cast_out #(
         .DATA_WIDTH (   ACTUAL_DW  )
     ) i_cast_out (
         .ctrl_i     (   out_cast_i              ),
-        .stream_i   (   out_stream_i            ),
+        .stream_i   (   out_stream_fp_cast      ),
         .stream_o   (   out_stream_post_cast    )
     );
 
@@ -279,7 +398,7 @@ import softex_pkg::*;
 
     hci_core_intf #(
         .DW ( DW )
-    ) store_mux_i_tcdm [1:0] (
+    ) store_mux_i_tcdm [3:0] (
         .clk    (   clk_i   )
     );
 
@@ -313,6 +432,37 @@ import softex_pkg::*;
         .flags_o        (   slot_out_flags_o        )
     );
 
+    hci_core_sink #(
+        .MISALIGNED_ACCESSES    (   1                            ),
+        .`HCI_SIZE_PARAM(tcdm)  (   `HCI_SIZE_PARAM(Tcdm_no_ecc) )
+    ) i_stats_out (
+        .clk_i          (   clk_i                   ),
+        .rst_ni         (   rst_ni                  ),
+        .test_mode_i    (   '0                      ),
+        .clear_i        (   clear_i                 ),
+        .enable_i       (   enable_i                ),
+        .tcdm           (   store_mux_i_tcdm [2]    ),
+        .stream         (   stats_stream_i          ),
+        .ctrl_i         (   stats_ctrl_i            ),
+        .flags_o        (   stats_flags_o           )
+    );
+
+    // Entries of the sparse output mode, see softex_sparse
+    hci_core_sink #(
+        .MISALIGNED_ACCESSES    (   1                            ),
+        .`HCI_SIZE_PARAM(tcdm)  (   `HCI_SIZE_PARAM(Tcdm_no_ecc) )
+    ) i_sparse_out (
+        .clk_i          (   clk_i                   ),
+        .rst_ni         (   rst_ni                  ),
+        .test_mode_i    (   '0                      ),
+        .clear_i        (   clear_i                 ),
+        .enable_i       (   enable_i                ),
+        .tcdm           (   store_mux_i_tcdm [3]    ),
+        .stream         (   sparse_stream_i         ),
+        .ctrl_i         (   sparse_ctrl_i           ),
+        .flags_o        (   sparse_flags_o          )
+    );
+
     hci_core_intf #(
         .DW ( DW )
     ) store_fifo (
@@ -320,7 +470,7 @@ import softex_pkg::*;
     );
 
     hci_core_mux_ooo #(
-        .NB_CHAN                (   2                            ),
+        .NB_CHAN                (   4                            ),
         .`HCI_SIZE_PARAM(out)   (   `HCI_SIZE_PARAM(Tcdm_no_ecc) )
     ) i_store_mux (
         .clk_i              (   clk_i               ),
@@ -355,4 +505,11 @@ import softex_pkg::*;
         .tcdm_initiator (   mux_i_tcdm [1]  )
     );
 
+    /*      PERFORMANCE EVENTS      */
+
+    assign perf_o.in_stall  = load_mux_i_tcdm [0].req & ~load_mux_i_tcdm [0].gnt;
+    assign perf_o.out_stall = store_mux_i_tcdm [0].req & ~store_mux_i_tcdm [0].gnt;
+    assign perf_o.in_beat   = in_stream_o.valid & in_stream_o.ready;
+    assign perf_o.out_beat  = out_stream_i.valid & out_stream_i.ready;
+
 endmodule
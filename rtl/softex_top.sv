@@ -16,6 +16,8 @@ import softex_pkg::*;
     parameter fpnew_pkg::fp_format_e    FPFORMAT    = FPFORMAT_IN   ,
     parameter int unsigned              INT_WIDTH   = INT_W         ,
     parameter int unsigned              N_CORES     = 8,
+    parameter bit                       SPLIT_LDST  = SPLIT_LDST_PORTS,
+    parameter bit                       DUAL_ROW    = DUAL_ROW_LANE ,
     parameter hci_size_parameter_t `HCI_SIZE_PARAM(Tcdm) = '0
 ) (
     input   logic                           clk_i   ,
@@ -25,6 +27,7 @@ import softex_pkg::*;
     output  logic [N_CORES - 1 : 0] [1 : 0] evt_o   ,
 
     hci_core_intf.initiator                 tcdm    ,
+    hci_core_intf.initiator                 tcdm_st ,   // Stores with SPLIT_LDST, tied off otherwise
     hwpe_ctrl_intf_periph.slave             periph  
 );
 
@@ -35,11 +38,19 @@ import softex_pkg::*;
     hci_streamer_flags_t    stream_out_flgs;
     hci_streamer_flags_t    slot_in_flgs;
     hci_streamer_flags_t    slot_out_flgs;
+    hci_streamer_flags_t    desc_flgs;
+    hci_streamer_flags_t    stats_flgs;
+    hci_streamer_flags_t    sparse_out_flgs;
+
+    streamer_perf_t         streamer_perf;
 
     hci_streamer_ctrl_t     stream_in_ctrl;
     hci_streamer_ctrl_t     stream_out_ctrl;
     hci_streamer_ctrl_t     slot_in_ctrl;
     hci_streamer_ctrl_t     slot_out_ctrl;
+    hci_streamer_ctrl_t     desc_ctrl;
+    hci_streamer_ctrl_t     stats_ctrl;
+    hci_streamer_ctrl_t     sparse_out_ctrl;
 
     cast_ctrl_t             in_cast_ctrl;
     cast_ctrl_t             out_cast_ctrl;
@@ -50,37 +61,78 @@ import softex_pkg::*;
     slot_regfile_ctrl_t     slot_regfile_ctrl;
 
     slot_t                  state_slot;
+    slot_regfile_flags_t    slot_regfile_flgs;
+
+    row_buf_ctrl_t          row_buf_ctrl;
+    row_buf_flags_t         row_buf_flgs;
+
+    merge_ctrl_t            merge_ctrl;
+    merge_flags_t           merge_flgs;
+
+    topk_ctrl_t             topk_ctrl;
+
+    sparse_ctrl_t           sparse_ctrl;
+    sparse_flags_t          sparse_flgs;
 
     hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) in_stream        (.clk(clk_i));
     hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) out_stream       (.clk(clk_i));
     hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) slot_in_stream   (.clk(clk_i));
     hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) slot_out_stream  (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) desc_stream      (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) stats_stream     (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) topk_stream      (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) sparse_stream    (.clk(clk_i));
 
+    hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) datapath_out (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) sparse_in (.clk(clk_i));
     hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) out_fifo_d (.clk(clk_i));
     hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) in_fifo_q (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) in_fifo_d (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) datapath_in (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) merge_in (.clk(clk_i));
+    hwpe_stream_intf_stream #(.DATA_WIDTH(ACTUAL_DW)) norm_in (.clk(clk_i));
 
     logic   clear;
 
     softex_ctrl #(
         .N_CORES    (   N_CORES     ),
-        .DATA_WIDTH (   ACTUAL_DW   )
+        .DATA_WIDTH (   ACTUAL_DW   ),
+        .DUAL_ROW   (   DUAL_ROW    )
     ) i_ctrl (
         .clk_i              (   clk_i               ),
         .rst_ni             (   rst_ni              ),
         .enable_i           (   '1                  ),
         .in_stream_flags_i  (   stream_in_flgs      ),
         .out_stream_flags_i (   stream_out_flgs     ),
+        .slot_in_flags_i    (   slot_in_flgs        ),
+        .slot_out_flags_i   (   slot_out_flgs       ),
+        .desc_flags_i       (   desc_flgs           ),
+        .stats_flags_i      (   stats_flgs          ),
+        .streamer_perf_i    (   streamer_perf       ),
         .datapath_flgs_i    (   datapath_flgs       ),
         .state_slot_i       (   state_slot          ),
+        .slot_flags_i       (   slot_regfile_flgs   ),
+        .row_buf_flags_i    (   row_buf_flgs        ),
+        .merge_flags_i      (   merge_flgs          ),
+        .sparse_flags_i     (   sparse_flgs         ),
         .clear_o            (   clear               ),
         .busy_o             (   busy_o              ),
         .evt_o              (   evt_o               ),
         .in_stream_ctrl_o   (   stream_in_ctrl      ),
         .out_stream_ctrl_o  (   stream_out_ctrl     ),
+        .desc_ctrl_o        (   desc_ctrl           ),
+        .stats_ctrl_o       (   stats_ctrl          ),
         .datapath_ctrl_o    (   datapath_ctrl       ),
         .slot_ctrl_o        (   slot_regfile_ctrl   ),
+        .row_buf_ctrl_o     (   row_buf_ctrl        ),
+        .merge_ctrl_o       (   merge_ctrl          ),
+        .topk_ctrl_o        (   topk_ctrl           ),
+        .sparse_ctrl_o      (   sparse_ctrl         ),
         .in_cast_ctrl_o     (   in_cast_ctrl        ),
         .out_cast_ctrl_o    (   out_cast_ctrl       ),
+        .desc_i             (   desc_stream         ),
+        .stats_o            (   stats_stream        ),
+        .topk_i             (   topk_stream         ),
         .periph             (   periph              )
     );
 
@@ -92,12 +144,28 @@ import softex_pkg::*;
         .clear_i        (   clear               ),
         .ctrl_i         (   slot_regfile_ctrl   ),
         .slot_o         (   state_slot          ),
+        .flags_o        (   slot_regfile_flgs   ),
         .store_ctrl_o   (   slot_out_ctrl       ),
         .load_ctrl_o    (   slot_in_ctrl        ),
         .store_o        (   slot_out_stream     ),
         .load_i         (   slot_in_stream      )
     );
 
+    softex_row_buffer #(
+        .DATA_WIDTH (   ACTUAL_DW       ),
+        .DEPTH      (   ROW_BUF_DEPTH   ),
+        .DUAL_ROW   (   DUAL_ROW        )
+    ) i_row_buffer (
+        .clk_i      (   clk_i           ),
+        .rst_ni     (   rst_ni          ),
+        .clear_i    (   clear           ),
+        .ctrl_i     (   row_buf_ctrl    ),
+        .flags_o    (   row_buf_flgs    ),
+        .stream_i   (   in_stream       ),
+        .stream_o   (   in_fifo_d       ),
+        .lane_o     (   norm_in         )
+    );
+
     hwpe_stream_fifo #(
         .DATA_WIDTH (   ACTUAL_DW  ),
         .FIFO_DEPTH (   2          )
@@ -106,22 +174,89 @@ import softex_pkg::*;
         .rst_ni     (   rst_ni      ),
         .clear_i    (   clear       ),
         .flags_o    (               ),
-        .push_i     (   in_stream   ),
+        .push_i     (   in_fifo_d   ),
         .pop_o      (   in_fifo_q   )
     );
 
+    // Saved row statistics are routed to the merge unit instead of the datapath
+    assign datapath_in.valid    = in_fifo_q.valid & ~merge_ctrl.enable;
+    assign datapath_in.data     = in_fifo_q.data;
+    assign datapath_in.strb     = in_fifo_q.strb;
+
+    assign merge_in.valid       = in_fifo_q.valid & merge_ctrl.enable;
+    assign merge_in.data        = in_fifo_q.data;
+    assign merge_in.strb        = in_fifo_q.strb;
+
+    assign in_fifo_q.ready      = merge_ctrl.enable ? merge_in.ready : datapath_in.ready;
+
+    softex_stats_merge #(
+        .DATA_WIDTH     (   ACTUAL_DW   ),
+        .IN_FPFORMAT    (   FPFORMAT    )
+    ) i_stats_merge (
+        .clk_i      (   clk_i       ),
+        .rst_ni     (   rst_ni      ),
+        .clear_i    (   clear       ),
+        .ctrl_i     (   merge_ctrl  ),
+        .flags_o    (   merge_flgs  ),
+        .stream_i   (   merge_in    )
+    );
+
     softex_datapath #(
         .DATA_WIDTH     (   ACTUAL_DW           ),
         .IN_FPFORMAT    (   FPFORMAT            ),
-        .VECT_WIDTH     (   ACTUAL_DW / WIDTH   )
+        .VECT_WIDTH     (   ACTUAL_DW / WIDTH   ),
+        .DUAL_ROW       (   DUAL_ROW            ),
+        .SPLIT_LDST     (   SPLIT_LDST          )
     ) i_datapath (
         .clk_i      (   clk_i                                   ),
         .rst_ni     (   rst_ni                                  ),
         .clear_i    (   clear                                   ),
         .ctrl_i     (   datapath_ctrl                           ),
         .flags_o    (   datapath_flgs                           ),
-        .stream_i   (   in_fifo_q                               ),
-        .stream_o   (   out_fifo_d                              )   
+        .stream_i   (   datapath_in                             ),
+        .norm_i     (   norm_in                                 ),
+        .stream_o   (   datapath_out                            )   
+    );
+
+    // In the sparse output mode the normalised beats are compressed instead of going to the output stream
+    assign out_fifo_d.valid     = datapath_out.valid & ~sparse_ctrl.enable;
+    assign out_fifo_d.data      = datapath_out.data;
+    assign out_fifo_d.strb      = datapath_out.strb;
+
+    assign sparse_in.valid      = datapath_out.valid & sparse_ctrl.enable;
+    assign sparse_in.data       = datapath_out.data;
+    assign sparse_in.strb       = datapath_out.strb;
+
+    assign datapath_out.ready   = sparse_ctrl.enable ? sparse_in.ready : out_fifo_d.ready;
+
+    softex_sparse #(
+        .DATA_WIDTH     (   ACTUAL_DW   ),
+        .IN_FPFORMAT    (   FPFORMAT    )
+    ) i_sparse (
+        .clk_i          (   clk_i               ),
+        .rst_ni         (   rst_ni              ),
+        .clear_i        (   clear               ),
+        .ctrl_i         (   sparse_ctrl         ),
+        .flags_o        (   sparse_flgs         ),
+        .store_ctrl_o   (   sparse_out_ctrl     ),
+        .store_flags_i  (   sparse_out_flgs     ),
+        .stream_i       (   sparse_in           ),
+        .store_o        (   sparse_stream       )
+    );
+
+    // The top-k of each row is taken from the normalised beats, before the output cast
+    softex_topk #(
+        .DATA_WIDTH     (   ACTUAL_DW   ),
+        .IN_FPFORMAT    (   FPFORMAT    )
+    ) i_topk (
+        .clk_i      (   clk_i                                   ),
+        .rst_ni     (   rst_ni                                  ),
+        .clear_i    (   clear                                   ),
+        .ctrl_i     (   topk_ctrl                               ),
+        .valid_i    (   datapath_out.valid & datapath_out.ready ),
+        .data_i     (   datapath_out.data                       ),
+        .strb_i     (   datapath_out.strb                       ),
+        .stream_o   (   topk_stream                             )
     );
 
     hwpe_stream_fifo #(
@@ -138,7 +273,8 @@ import softex_pkg::*;
 
     softex_streamer #(
         .`HCI_SIZE_PARAM(Tcdm) ( `HCI_SIZE_PARAM(Tcdm)),
-        .ACTUAL_DW ( ACTUAL_DW )
+        .ACTUAL_DW ( ACTUAL_DW ),
+        .SPLIT_LDST ( SPLIT_LDST )
     ) i_streamer (
         .clk_i              (   clk_i           ),
         .rst_ni             (   rst_ni          ),
@@ -148,17 +284,28 @@ import softex_pkg::*;
         .out_stream_ctrl_i  (   stream_out_ctrl ),
         .slot_in_ctrl_i     (   slot_in_ctrl    ), 
         .slot_out_ctrl_i    (   slot_out_ctrl   ),
+        .desc_ctrl_i        (   desc_ctrl       ),
+        .stats_ctrl_i       (   stats_ctrl      ),
+        .sparse_ctrl_i      (   sparse_out_ctrl ),
         .in_cast_i          (   in_cast_ctrl    ),
         .out_cast_i         (   out_cast_ctrl   ),
         .in_stream_flags_o  (   stream_in_flgs  ),
         .out_stream_flags_o (   stream_out_flgs ),
         .slot_in_flags_o    (   slot_in_flgs    ),
         .slot_out_flags_o   (   slot_out_flgs   ),
+        .desc_flags_o       (   desc_flgs       ),
+        .stats_flags_o      (   stats_flgs      ),
+        .sparse_flags_o     (   sparse_out_flgs ),
+        .perf_o             (   streamer_perf   ),
         .in_stream_o        (   in_stream       ),  
         .out_stream_i       (   out_stream      ),
         .slot_in_stream_o   (   slot_in_stream  ),  
         .slot_out_stream_i  (   slot_out_stream ), 
-        .tcdm               (   tcdm            ) 
+        .desc_stream_o      (   desc_stream     ),
+        .stats_stream_i     (   stats_stream    ),
+        .sparse_stream_i    (   sparse_stream   ),
+        .tcdm               (   tcdm            ),
+        .tcdm_st            (   tcdm_st         )
     );
 
 endmodule
@@ -0,0 +1,177 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+`include "softex_macros.svh"
+
+module softex_topk
+import hwpe_stream_package::*;
+import softex_pkg::*;
+#(
+    parameter int unsigned              DATA_WIDTH  = DATA_W - 32   ,
+    parameter fpnew_pkg::fp_format_e    IN_FPFORMAT = FPFORMAT_IN   ,
+    parameter int unsigned              K_MAX       = TOPK_MAX
+) (
+    input   logic                           clk_i       ,
+    input   logic                           rst_ni      ,
+    input   logic                           clear_i     ,
+    input   topk_ctrl_t                     ctrl_i      ,
+
+    input   logic                           valid_i     ,
+    input   logic [DATA_WIDTH - 1 : 0]      data_i      ,
+    input   logic [DATA_WIDTH / 8 - 1 : 0]  strb_i      ,
+
+    hwpe_stream_intf_stream.source          stream_o
+);
+
+    /*  Records the "k" largest outputs of a row, with their position, while the normalised beats flow to the     *
+     *  output stream. It only observes the beats ("valid_i" is a handshake) and never stalls them.               *
+     *  Each lane of the datapath keeps its own sorted list, so one element per lane is inserted every beat.      *
+     *  On "start" the lists are merged in "k" cycles by repeatedly taking the best head, then the record is      *
+     *  streamed out: per entry the index in the lower word and the value in the upper one, best first. Ties go   *
+     *  to the lowest index, entries past the end of a short row have an index of all ones.                       */
+
+    localparam int unsigned IN_WIDTH    = fpnew_pkg::fp_width(IN_FPFORMAT);
+    localparam int unsigned VECT_WIDTH  = DATA_WIDTH / IN_WIDTH;
+    localparam int unsigned REC_BEATS   = (K_MAX * TOPK_ENTRY_BYTES * 8 + DATA_WIDTH - 1) / DATA_WIDTH;
+    localparam int unsigned CNT_WIDTH   = $clog2(K_MAX + 1);
+
+    typedef struct packed {
+        logic                       valid;
+        logic [31 : 0]              index;
+        logic [IN_WIDTH - 1 : 0]    value;
+    } entry_t;
+
+    typedef enum logic [1:0] {
+        COLLECT,
+        MERGE,
+        WRITE
+    } topk_state_t;
+
+    topk_state_t    current_state;
+
+    entry_t [VECT_WIDTH - 1 : 0] [K_MAX - 1 : 0]    lists_q;
+    entry_t [K_MAX - 1 : 0]                         res_q;
+
+    logic [31 : 0]              beat_cnt_q;
+    logic [CNT_WIDTH - 1 : 0]   cnt_q;
+
+    logic [$clog2(VECT_WIDTH) - 1 : 0]  best_lane;
+
+    logic [REC_BEATS * DATA_WIDTH - 1 : 0]  record;
+
+    logic [CNT_WIDTH - 1 : 0]   n_beats;
+
+    // Higher value first, then lower index. Invalid entries lose against everything
+    function automatic logic beats (entry_t a, entry_t b);
+        return a.valid & (~b.valid | `FP_GT(a.value, b.value, IN_FPFORMAT) | ((a.value == b.value) & (a.index < b.index)));
+    endfunction
+
+    always_comb begin : best_head
+        best_lane = '0;
+
+        for (int l = 1; l < VECT_WIDTH; l++) begin
+            if (beats(lists_q [l] [0], lists_q [best_lane] [0])) begin
+                best_lane = l;
+            end
+        end
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin : topk_lists
+        if (~rst_ni) begin
+            current_state   <= COLLECT;
+            lists_q         <= '0;
+            res_q           <= '0;
+            beat_cnt_q      <= '0;
+            cnt_q           <= '0;
+        end else begin
+            if (clear_i | ctrl_i.clear) begin
+                current_state   <= COLLECT;
+                lists_q         <= '0;
+                res_q           <= '0;
+                beat_cnt_q      <= '0;
+                cnt_q           <= '0;
+            end else begin
+                case (current_state)
+                    COLLECT: begin
+                        if (ctrl_i.start) begin
+                            current_state   <= MERGE;
+                            cnt_q           <= '0;
+                        end else if (ctrl_i.enable & valid_i) begin
+                            beat_cnt_q  <= beat_cnt_q + 1;
+
+                            // The element of a lane is newer than the ones in its list, so it goes after the equal ones
+                            for (int l = 0; l < VECT_WIDTH; l++) begin
+                                entry_t cand;
+
+                                cand.valid  = '1;
+                                cand.index  = beat_cnt_q * VECT_WIDTH + l;
+                                cand.value  = data_i [IN_WIDTH * l +: IN_WIDTH];
+
+                                if (strb_i [IN_WIDTH / 8 * l]) begin
+                                    for (int e = 0; e < K_MAX; e++) begin
+                                        if (beats(cand, lists_q [l] [e])) begin
+                                            lists_q [l] [e] <= (e == 0 || !beats(cand, lists_q [l] [e - 1])) ? cand : lists_q [l] [e - 1];
+                                        end
+                                    end
+                                end
+                            end
+                        end
+                    end
+
+                    MERGE: begin
+                        res_q [cnt_q]   <= lists_q [best_lane] [0];
+
+                        for (int e = 0; e < K_MAX - 1; e++) begin
+                            lists_q [best_lane] [e] <= lists_q [best_lane] [e + 1];
+                        end
+
+                        lists_q [best_lane] [K_MAX - 1] <= '0;
+
+                        if (cnt_q + 1 >= ctrl_i.k) begin
+                            current_state   <= WRITE;
+                            cnt_q           <= '0;
+                        end else begin
+                            cnt_q           <= cnt_q + 1;
+                        end
+                    end
+
+                    WRITE: begin
+                        if (stream_o.valid & stream_o.ready) begin
+                            if (cnt_q + 1 >= n_beats) begin
+                                current_state   <= COLLECT;
+                            end
+
+                            cnt_q   <= cnt_q + 1;
+                        end
+                    end
+
+                    default: current_state <= COLLECT;
+                endcase
+            end
+        end
+    end
+
+    always_comb begin : record_layout
+        record = '0;
+
+        for (int e = 0; e < K_MAX; e++) begin
+            record [8 * TOPK_ENTRY_BYTES * e +: 32]         = res_q [e].valid ? res_q [e].index : '1;
+            record [8 * TOPK_ENTRY_BYTES * e + 32 +: 32]    = res_q [e].valid ? 32'(res_q [e].value) : '0;
+        end
+    end
+
+    assign n_beats  = CNT_WIDTH'((ctrl_i.k * TOPK_ENTRY_BYTES * 8 + DATA_WIDTH - 1) / DATA_WIDTH);
+
+    assign stream_o.valid   = current_state == WRITE;
+    assign stream_o.data    = record [DATA_WIDTH * cnt_q +: DATA_WIDTH];
+
+    // Only the "k" entries of the record are written
+    for (genvar b = 0; b < DATA_WIDTH / 8; b++) begin : gen_record_strb
+        assign stream_o.strb [b] = (cnt_q * DATA_WIDTH / 8 + b) < ctrl_i.k * TOPK_ENTRY_BYTES;
+    end
+
+endmodule
@@ -19,6 +19,8 @@ import softex_pkg::*;
     parameter int unsigned              DW          = DATA_W        ,
     parameter  int unsigned             EW          = 0             ,
     parameter int unsigned              MP          = DW / 32       ,
+    parameter bit                       SPLIT_LDST  = SPLIT_LDST_PORTS,
+    parameter bit                       DUAL_ROW    = DUAL_ROW_LANE ,
     parameter fpnew_pkg::fp_format_e    FPFORMAT    = FPFORMAT_IN   
 ) (
     // global signals
@@ -44,6 +46,22 @@ import softex_pkg::*;
     input  logic                      tcdm_r_user_i       ,
     input  logic               [ 7:0] tcdm_r_id_i         ,
     input  logic [      EW-1:0]       tcdm_r_ecc_i        ,
+    // tcdm store master ports, only used with SPLIT_LDST
+    output logic [      MP-1:0]       tcdm_st_req_o       ,
+    input  logic [      MP-1:0]       tcdm_st_gnt_i       ,
+    output logic [      MP-1:0][31:0] tcdm_st_add_o       ,
+    output logic [      MP-1:0]       tcdm_st_wen_o       ,
+    output logic [      MP-1:0][ 3:0] tcdm_st_be_o        ,
+    output logic [      MP-1:0][31:0] tcdm_st_data_o      ,
+    output logic [      MP-1:0]       tcdm_st_r_ready_o   ,
+    output logic [      MP-1:0][ 7:0] tcdm_st_id_o        ,
+    output logic [      EW-1:0]       tcdm_st_ecc_o       ,
+    input  logic [      MP-1:0][31:0] tcdm_st_r_data_i    ,
+    input  logic [      MP-1:0]       tcdm_st_r_valid_i   ,
+    input  logic                      tcdm_st_r_opc_i     ,
+    input  logic                      tcdm_st_r_user_i    ,
+    input  logic               [ 7:0] tcdm_st_r_id_i      ,
+    input  logic [      EW-1:0]       tcdm_st_r_ecc_i     ,
     // periph slave port
     input  logic                      periph_req_i        ,
     output logic                      periph_gnt_o        ,
@@ -70,6 +88,9 @@ import softex_pkg::*;
     };
     `HCI_INTF(tcdm, clk_i);
 
+    localparam hci_package::hci_size_parameter_t `HCI_SIZE_PARAM(tcdm_st) = `HCI_SIZE_PARAM(tcdm);
+    `HCI_INTF(tcdm_st, clk_i);
+
     hwpe_ctrl_intf_periph #(.ID_WIDTH(ID_WIDTH)) periph (.clk(clk_i));
 
     logic busy;
@@ -95,6 +116,25 @@ import softex_pkg::*;
         assign tcdm.r_id    = tcdm_r_id_i;
         assign tcdm.r_ecc   = tcdm_r_ecc_i;
 
+        for(genvar ii=0; ii<MP; ii++) begin: gen_tcdm_st_binding
+            assign tcdm_st_req_o     [ii] = tcdm_st.req;
+            assign tcdm_st_add_o     [ii] = tcdm_st.add + ii*4;
+            assign tcdm_st_wen_o     [ii] = tcdm_st.wen;
+            assign tcdm_st_be_o      [ii] = tcdm_st.be[(ii+1)*4-1:ii*4];
+            assign tcdm_st_data_o    [ii] = tcdm_st.data[(ii+1)*32-1:ii*32];
+            assign tcdm_st_r_ready_o [ii] = tcdm_st.r_ready;
+            assign tcdm_st_id_o      [ii] = tcdm_st.id;
+        end
+        assign tcdm_st_ecc_o   = tcdm_st.ecc;
+
+        assign tcdm_st.gnt     = &(tcdm_st_gnt_i);
+        assign tcdm_st.r_valid = &(tcdm_st_r_valid_i);
+        assign tcdm_st.r_data  = { >> {tcdm_st_r_data_i} };
+        assign tcdm_st.r_opc   = tcdm_st_r_opc_i;
+        assign tcdm_st.r_user  = tcdm_st_r_user_i;
+        assign tcdm_st.r_id    = tcdm_st_r_id_i;
+        assign tcdm_st.r_ecc   = tcdm_st_r_ecc_i;
+
         assign periph.req       = periph_req_i;
         assign periph.add       = periph_add_i;
         assign periph.wen       = periph_wen_i;
@@ -131,6 +171,26 @@ import softex_pkg::*;
                 tcdm.r_id    <= '0;
                 tcdm.r_ecc   <= '0;
 
+                // TCDM store port
+                for (int ii = 0; ii < MP; ii++) begin
+                    tcdm_st_req_o      [ii] <= '0;
+                    tcdm_st_add_o      [ii] <= '0;
+                    tcdm_st_wen_o      [ii] <= '0;
+                    tcdm_st_be_o       [ii] <= '0;
+                    tcdm_st_data_o     [ii] <= '0;
+                    tcdm_st_r_ready_o  [ii] <= '0;
+                    tcdm_st_id_o       [ii] <= '0;
+                end
+                tcdm_st_ecc_o   <= '0;
+
+                tcdm_st.gnt     <= '0;
+                tcdm_st.r_valid <= '0;
+                tcdm_st.r_data  <= '0;
+                tcdm_st.r_opc   <= '0;
+                tcdm_st.r_user  <= '0;
+                tcdm_st.r_id    <= '0;
+                tcdm_st.r_ecc   <= '0;
+
                 // Control port
                 periph.req     <= '0;
                 periph.add     <= '0;
@@ -167,6 +227,26 @@ import softex_pkg::*;
                 tcdm.r_id    <= tcdm_r_id_i;
                 tcdm.r_ecc   <= tcdm_r_ecc_i;
 
+                // TCDM store port
+                for (int ii = 0; ii < MP; ii++) begin
+                    tcdm_st_req_o       [ii] <= tcdm_st.req;
+                    tcdm_st_add_o       [ii] <= tcdm_st.add + ii*4;
+                    tcdm_st_wen_o       [ii] <= tcdm_st.wen;
+                    tcdm_st_be_o        [ii] <= tcdm_st.be[ii*4+:4];
+                    tcdm_st_data_o      [ii] <= tcdm_st.data[ii*32+:32];
+                    tcdm_st_r_ready_o   [ii] <= tcdm_st.r_ready;
+                    tcdm_st_id_o        [ii] <= tcdm_st.id;
+                end
+                tcdm_st_ecc_o   <= tcdm_st.ecc;
+
+                tcdm_st.gnt     <= &(tcdm_st_gnt_i);
+                tcdm_st.r_valid <= &(tcdm_st_r_valid_i);
+                tcdm_st.r_data  <= { >> {tcdm_st_r_data_i} };
+                tcdm_st.r_opc   <= tcdm_st_r_opc_i;
+                tcdm_st.r_user  <= tcdm_st_r_user_i;
+                tcdm_st.r_id    <= tcdm_st_r_id_i;
+                tcdm_st.r_ecc   <= tcdm_st_r_ecc_i;
+
                 // Control port
                 periph.req     <= periph_req_i;
                 periph.add     <= periph_add_i;
@@ -189,6 +269,8 @@ import softex_pkg::*;
     softex_top #(
         .FPFORMAT   (   FPFORMAT    ),
         .N_CORES    (   N_CORES     ),
+        .SPLIT_LDST (   SPLIT_LDST  ),
+        .DUAL_ROW   (   DUAL_ROW    ),
         .`HCI_SIZE_PARAM(Tcdm) ( HCI_SIZE_tcdm )
     ) i_top (
         .clk_i  (   clk_i   ),
@@ -196,6 +278,7 @@ import softex_pkg::*;
         .busy_o (   busy    ),
         .evt_o  (   evt     ),
         .tcdm   (   tcdm    ),
+        .tcdm_st(   tcdm_st ),
         .periph (   periph  ) 
     );
 
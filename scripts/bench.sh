@@ -0,0 +1,74 @@
+#!/bin/bash
+
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+#
+# Andrea Belano <andrea.belano@studio.unibo.it>
+#
+
+# Runs the sw/bench programs over lengths, vector counts, split points and
+# stall probabilities, with inputs from the golden generator. The CSV records
+# they print are collected into BENCH_CSV, one line per phase. Every point runs
+# in its own directory under BENCH_DIR, where the full simulation log is kept
+
+SIM=${SIM:-verilator}
+BANDWIDTH=${BANDWIDTH:-128}
+STALLS=${STALLS:-"0.00 0.01 0.10"}
+LENGTHS=${LENGTHS:-"64 256 1024 4096 32768"}
+VECTORS=${VECTORS:-"1 4 16"}
+VECTORS_LENGTH=${VECTORS_LENGTH:-1024}
+SPLITS=${SPLITS:-"512 1024 2048 3072"}
+SPLIT_LENGTH=${SPLIT_LENGTH:-4096}
+BENCH_DIR=${BENCH_DIR:-$(pwd)/work/bench}
+BENCH_CSV=${BENCH_CSV:-${BENCH_DIR}/bench.csv}
+
+mkdir -p ${BENCH_DIR}
+
+if [ "${SIM}" = "verilator" ]; then
+    make verilate bandwidth=${BANDWIDTH} > /dev/null
+    if test $? -ne 0; then
+        echo "Error building the model for bandwidth=${BANDWIDTH}"
+        exit 1
+    fi
+fi
+
+echo "program,bandwidth,stall,length,vectors,split,phase,elements,cycles,instret,cycles/element" > ${BENCH_CSV}
+
+# bench_point <program> <stall> <length> <vectors> <split>
+bench_point() {
+    local run_dir=${BENCH_DIR}/$1-stall$2-len$3-vec$4-split$5
+    local flags=""
+
+    if [ "$5" != "-" ]; then
+        flags="-DSPLIT=$5"
+    fi
+
+    mkdir -p ${run_dir}
+
+    make golden sw-all run length=$3 vectors=$4 range=32 bandwidth=${BANDWIDTH} PROB_STALL=$2 \
+        TEST=bench/$1.c FLAGS="${flags}" SIM=${SIM} RUN_DIR=${run_dir} > ${run_dir}/bench.log 2>&1
+    if test $? -ne 0; then
+        echo "Error in $1 PROB_STALL=$2 length=$3 vectors=$4 split=$5, see ${run_dir}/bench.log"
+        exit 1
+    fi
+
+    grep -E "^CSV," ${run_dir}/bench.log | grep -v "^CSV,phase" | \
+        sed "s/^CSV,/$1,${BANDWIDTH},$2,$3,$4,$5,/" | tee -a ${BENCH_CSV}
+}
+
+for stall in ${STALLS}; do
+    for len in ${LENGTHS}; do
+        bench_point bench_length ${stall} ${len} 1 -
+    done
+
+    for vec in ${VECTORS}; do
+        bench_point bench_vectors ${stall} ${VECTORS_LENGTH} ${vec} -
+    done
+
+    for split in ${SPLITS}; do
+        bench_point bench_split ${stall} ${SPLIT_LENGTH} 1 ${split}
+    done
+done
+
+echo "Results in ${BENCH_CSV}"
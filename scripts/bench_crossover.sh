@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+#
+# Andrea Belano <andrea.belano@studio.unibo.it>
+#
+
+# Runs sw/softex_crossover.c stall free and prints, for every row length, the
+# cycles of softex_core_softmax and of a SoftEx job. The last line is the
+# shortest row on which the offload wins, the value SOFTEX_RT_CROSSOVER in
+# sw/softex_rt.h should be set to
+
+SIM=${SIM:-verilator}
+BANDWIDTH=${BANDWIDTH:-128}
+LENGTH=${LENGTH:-256}
+BENCH_DIR=${BENCH_DIR:-$(pwd)/work/bench-crossover}
+
+mkdir -p ${BENCH_DIR}
+
+make golden sw-all run length=${LENGTH} range=32 bandwidth=${BANDWIDTH} PROB_STALL=0.00 \
+    TEST=softex_crossover.c SIM=${SIM} RUN_DIR=${BENCH_DIR} > ${BENCH_DIR}/bench.log 2>&1
+if test $? -ne 0; then
+    echo "Error in softex_crossover.c, see ${BENCH_DIR}/bench.log"
+    exit 1
+fi
+
+printf "%-8s %-12s %-14s %s\n" "length" "core" "softex" "mismatches"
+
+grep -E "^CROSSOVER,[0-9]" ${BENCH_DIR}/bench.log | \
+    awk -F, '{printf "%-8s %-12s %-14s %s\n", $2, $3, $4, $5}'
+
+crossover=$(grep -E "^CROSSOVER,result," ${BENCH_DIR}/bench.log | cut -d, -f3)
+longest=$(grep -E "^CROSSOVER,[0-9]" ${BENCH_DIR}/bench.log | tail -n 1 | cut -d, -f2)
+
+# The program reports 0 if the core won on every length it tried
+if [ "${crossover}" = "0" ]; then
+    echo "SOFTEX_RT_CROSSOVER>${longest} (bandwidth=${BANDWIDTH}), the core won up to the longest row"
+else
+    echo "SOFTEX_RT_CROSSOVER=${crossover} (bandwidth=${BANDWIDTH})"
+fi
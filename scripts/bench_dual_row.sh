@@ -0,0 +1,60 @@
+#!/bin/bash
+
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+#
+# Andrea Belano <andrea.belano@studio.unibo.it>
+#
+
+# Compares the throughput, in output elements per busy cycle, of the same batch
+# of rows normalised by the partial jobs of softex_multi_unroll.c, by a single
+# strided job in the sequential mode and by a single strided job in the
+# dual-row mode. LENGTH defaults to the longest row the row buffer can hold at
+# 128 bits, longer rows fall back to the sequential mode. The first two modes
+# run on a model without the lane, so the last one shows what its area buys
+
+SIM=${SIM:-verilator}
+STALLS=${STALLS:-"0.00 0.01"}
+LENGTH=${LENGTH:-2048}
+VECTORS=${VECTORS:-16}
+BENCH_DIR=${BENCH_DIR:-$(pwd)/work/bench-dual-row}
+
+MODES="multi_unroll sequential dual_row"
+
+# The lane is a structural parameter of the Verilator model
+if [ "${SIM}" = "verilator" ]; then
+    for dual_row in 0 1; do
+        make verilate dual_row=${dual_row} > /dev/null
+        if test $? -ne 0; then
+            echo "Error building the model for dual_row=${dual_row}"
+            exit 1
+        fi
+    done
+fi
+
+printf "%-14s %-10s %s\n" "mode" "stall" "elements/cycle"
+
+for stall in ${STALLS}; do
+    for mode in ${MODES}; do
+        case ${mode} in
+            multi_unroll)   opts="TEST=softex_multi_unroll.c dual_row=0" ;;
+            sequential)     opts="TEST=softex_rows.c dual_row=0" ;;
+            dual_row)       opts="TEST=softex_rows.c dual_row=1" ;;
+        esac
+
+        run_dir=${BENCH_DIR}/${mode}-stall${stall}
+        mkdir -p ${run_dir}
+
+        make golden sw-all run length=${LENGTH} range=32 vectors=${VECTORS} PROB_STALL=${stall} \
+            ${opts} SIM=${SIM} RUN_DIR=${run_dir} > ${run_dir}/bench.log 2>&1
+        if test $? -ne 0; then
+            echo "Error in ${mode} PROB_STALL=${stall}, see ${run_dir}/bench.log"
+            exit 1
+        fi
+
+        throughput=$(grep -Eo "Throughput: +[0-9.]+" ${run_dir}/bench.log | awk '{print $2}')
+
+        printf "%-14s %-10s %s\n" ${mode} ${stall} ${throughput}
+    done
+done
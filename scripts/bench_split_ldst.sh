@@ -0,0 +1,56 @@
+#!/bin/bash
+
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+#
+# Andrea Belano <andrea.belano@studio.unibo.it>
+#
+
+# Compares the normalisation of bench_split.c with the loads and the stores on
+# a shared TCDM port (split_ldst=0) and on separate ones (split_ldst=1), for
+# each memory stall probability. The cycles per element of the normalisation
+# phase are printed with the speed-up of the separate ports. Every point runs
+# in its own directory under BENCH_DIR, where the full simulation log is kept
+
+SIM=${SIM:-verilator}
+BANDWIDTH=${BANDWIDTH:-128}
+STALLS=${STALLS:-"0.00 0.01 0.10"}
+LENGTH=${LENGTH:-4096}
+BENCH_DIR=${BENCH_DIR:-$(pwd)/work/bench-split-ldst}
+
+printf "%-10s %-14s %-14s %s\n" "stall" "shared" "split" "speed-up"
+
+# The port split is a structural parameter of the Verilator model
+if [ "${SIM}" = "verilator" ]; then
+    for split in 0 1; do
+        make verilate bandwidth=${BANDWIDTH} split_ldst=${split} > /dev/null
+        if test $? -ne 0; then
+            echo "Error building the model for split_ldst=${split}"
+            exit 1
+        fi
+    done
+fi
+
+declare -A cpe
+
+for stall in ${STALLS}; do
+    for split in 0 1; do
+        run_dir=${BENCH_DIR}/split${split}-stall${stall}
+        mkdir -p ${run_dir}
+
+        make golden sw-all run length=${LENGTH} range=32 bandwidth=${BANDWIDTH} split_ldst=${split} \
+            PROB_STALL=${stall} TEST=bench/bench_split.c SIM=${SIM} RUN_DIR=${run_dir} > ${run_dir}/bench.log 2>&1
+        if test $? -ne 0; then
+            echo "Error in split_ldst=${split} PROB_STALL=${stall}, see ${run_dir}/bench.log"
+            exit 1
+        fi
+
+        # CSV,normalisation,elements,cycles,instret,cycles/element
+        cpe[${split}]=$(grep -E "^CSV,normalisation," ${run_dir}/bench.log | cut -d, -f6)
+    done
+
+    speedup=$(awk -v a=${cpe[0]} -v b=${cpe[1]} 'BEGIN { printf "%.2f", a / b }')
+
+    printf "%-10s %-14s %-14s %s\n" ${stall} ${cpe[0]} ${cpe[1]} ${speedup}
+done
@@ -0,0 +1,48 @@
+#!/bin/bash
+
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+#
+# Andrea Belano <andrea.belano@studio.unibo.it>
+#
+
+# Measures the throughput of SoftEx, in output elements per busy cycle, for
+# each TCDM beat width and memory stall probability. Every point runs in its
+# own directory under BENCH_DIR, where the full simulation log is kept
+
+SIM=${SIM:-verilator}
+WIDTHS=${WIDTHS:-"128 256 512"}
+STALLS=${STALLS:-"0.00 0.01"}
+LENGTH=${LENGTH:-32768}
+TEST=${TEST:-softex_basic.c}
+BENCH_DIR=${BENCH_DIR:-$(pwd)/work/bench}
+
+printf "%-10s %-10s %s\n" "bandwidth" "stall" "elements/cycle"
+
+for bw in ${WIDTHS}; do
+    # The beat width is a structural parameter of the Verilator model
+    if [ "${SIM}" = "verilator" ]; then
+        make verilate bandwidth=${bw} > /dev/null
+        if test $? -ne 0; then
+            echo "Error building the model for bandwidth=${bw}"
+            exit 1
+        fi
+    fi
+
+    for stall in ${STALLS}; do
+        run_dir=${BENCH_DIR}/bw${bw}-stall${stall}
+        mkdir -p ${run_dir}
+
+        make golden sw-all run length=${LENGTH} range=32 bandwidth=${bw} PROB_STALL=${stall} \
+            TEST=${TEST} SIM=${SIM} RUN_DIR=${run_dir} > ${run_dir}/bench.log 2>&1
+        if test $? -ne 0; then
+            echo "Error in bandwidth=${bw} PROB_STALL=${stall}, see ${run_dir}/bench.log"
+            exit 1
+        fi
+
+        throughput=$(grep -Eo "Throughput: +[0-9.]+" ${run_dir}/bench.log | awk '{print $2}')
+
+        printf "%-10s %-10s %s\n" ${bw} ${stall} ${throughput}
+    done
+done
@@ -111,6 +111,14 @@ runtest.add_argument('-y,', '--yaml', action='store_true',
                      from a list of commands""")
 runtest.add_argument('-o,', '--output', type=str,
                      help="""Write junit.xml to file instead of stdout""")
+runtest.add_argument('--sim', type=str, default=None,
+                     help="""Simulator used by the make commands (SIM=...).
+                     Each test is given its own RUN_DIR so that tests sharing
+                     the same path can run in parallel. With verilator the
+                     model is built once before running the tests""")
+runtest.add_argument('--run_dir', type=str, default='work/runs',
+                     help="""Root of the per-test run directories used
+                     with --sim. Default is work/runs""")
 stdout_lock = Lock()
 
 shared_total = 0
@@ -280,6 +288,11 @@ the pyyaml library which is not installed.""",
                 for testname, insn in testv.items():
                     cmd = shlex.split(insn['command'])
                     cwd = insn['path']
+                    if args.sim:
+                        run_dir = os.path.abspath(os.path.join(
+                            cwd, args.run_dir, testsetname, testname))
+                        os.makedirs(run_dir, exist_ok=True)
+                        cmd += ['SIM=' + args.sim, 'RUN_DIR=' + run_dir]
                     tests.append((testsetname + ':' + testname, cwd, cmd))
             if args.verbose:
                 pp.pprint(tests)
@@ -294,6 +307,18 @@ the pyyaml library which is not installed.""",
                 pp.pprint(tests)
                 pp.pprint(shellcmds)
 
+    # Build each Verilator model once, the tests only run it. The variables
+    # below change the structure of the testbench and select the model
+    if args.sim == 'verilator':
+        model_vars = ('USE_ECC=', 'bandwidth=', 'split_ldst=', 'dual_row=')
+        models = set()
+        for _, cwd, cmd in tests:
+            models.add((cwd, tuple(sorted(a for a in cmd if a.startswith(model_vars)))))
+        for cwd, model_args in sorted(models):
+            if Popen(['make', 'verilate'] + list(model_args), cwd=cwd).wait() != 0:
+                print('Error: make verilate failed in ' + cwd, file=sys.stderr)
+                exit(1)
+
     # Spawning process pool
     # Disable signals to prevent race. Child processes inherit SIGINT handler
     original_sigint_handler = signal.signal(signal.SIGINT, signal.SIG_IGN)
@@ -7,8 +7,14 @@
 # Andrea Belano <andrea.belano@studio.unibo.it>
 #
 
-export N_PROC=1
-TIMEOUT=60
+export N_PROC=${N_PROC:-1}
+TIMEOUT=${TIMEOUT:-60}
+
+# SIM=verilator runs the tests in parallel, each in its own directory
+SIM_ARGS=""
+if [ -n "${SIM}" ]; then
+    SIM_ARGS="--sim ${SIM}"
+fi
 
 # Declare a string array with type
 declare -a test_list=(
@@ -17,7 +23,7 @@ declare -a test_list=(
 
 # Read the list values with space
 for val in "${test_list[@]}"; do
-    nice -n10 scripts/bwruntests.py --disable_results_pp --report_junit -t ${TIMEOUT} --yaml -o sfm_tests.xml -p${N_PROC} $val
+    nice -n10 scripts/bwruntests.py --disable_results_pp --report_junit -t ${TIMEOUT} --yaml -o sfm_tests.xml -p${N_PROC} ${SIM_ARGS} $val
     if test $? -ne 0; then
         echo "Error in test $val"
         exit 1
@@ -8,7 +8,10 @@
 #ifndef __ARCHI_SOFTEX__
 #define __ARCHI_SOFTEX__
 
+// Data bits of a TCDM beat, set by the bandwidth knob of the Makefile
+#ifndef DATA_WIDTH
 #define DATA_WIDTH      128
+#endif
 
 #define SOFTEX_BASE_ADD    0x00100000
 
@@ -20,6 +23,31 @@
 #define SOFTEX_RUNNING_JOB 0x10
 #define SOFTEX_SOFT_CLEAR  0x14
 
+// Performance counters (read-only, cleared by SOFTEX_SOFT_CLEAR)
+#define SOFTEX_PERF_OFFS   0x100
+
+#define SOFTEX_PERF_CYCLES              SOFTEX_PERF_OFFS + 0x00
+#define SOFTEX_PERF_IDLE                SOFTEX_PERF_OFFS + 0x04
+#define SOFTEX_PERF_WAIT_SLOT_VALID     SOFTEX_PERF_OFFS + 0x08
+#define SOFTEX_PERF_ACCUMULATION        SOFTEX_PERF_OFFS + 0x0C
+#define SOFTEX_PERF_WAIT_DATAPATH_EMPTY SOFTEX_PERF_OFFS + 0x10
+#define SOFTEX_PERF_WAIT_ACCUMULATION   SOFTEX_PERF_OFFS + 0x14
+#define SOFTEX_PERF_WAIT_INVERSION      SOFTEX_PERF_OFFS + 0x18
+#define SOFTEX_PERF_DIVIDING            SOFTEX_PERF_OFFS + 0x1C
+#define SOFTEX_PERF_FINISHED            SOFTEX_PERF_OFFS + 0x20
+#define SOFTEX_PERF_IN_STALL            SOFTEX_PERF_OFFS + 0x24
+#define SOFTEX_PERF_OUT_STALL           SOFTEX_PERF_OFFS + 0x28
+#define SOFTEX_PERF_SLOT_LOAD           SOFTEX_PERF_OFFS + 0x2C
+#define SOFTEX_PERF_SLOT_STORE          SOFTEX_PERF_OFFS + 0x30
+#define SOFTEX_PERF_RESCALES            SOFTEX_PERF_OFFS + 0x34
+#define SOFTEX_PERF_ELEMENTS            SOFTEX_PERF_OFFS + 0x38
+#define SOFTEX_PERF_IN_BEATS            SOFTEX_PERF_OFFS + 0x3C
+#define SOFTEX_PERF_OUT_BEATS           SOFTEX_PERF_OFFS + 0x40
+#define SOFTEX_PERF_DESCRIPTORS         SOFTEX_PERF_OFFS + 0x44
+#define SOFTEX_PERF_RB_BEATS            SOFTEX_PERF_OFFS + 0x48
+#define SOFTEX_PERF_SLOT_HITS           SOFTEX_PERF_OFFS + 0x4C
+#define SOFTEX_PERF_SLOT_MISSES         SOFTEX_PERF_OFFS + 0x50
+
 #define SOFTEX_REG_OFFS    0x20
 
 #define SOFTEX_IN_ADDR         SOFTEX_REG_OFFS + 0x00
@@ -28,6 +56,22 @@
 #define SOFTEX_COMMANDS        SOFTEX_REG_OFFS + 0x0C
 #define SOFTEX_CACHE_BASE_ADDR SOFTEX_REG_OFFS + 0x10
 #define SOFTEX_CAST_CTRL       SOFTEX_REG_OFFS + 0x14
+#define SOFTEX_DESC_ADDR       SOFTEX_REG_OFFS + 0x18
+#define SOFTEX_DESC_COUNT      SOFTEX_REG_OFFS + 0x1C
+#define SOFTEX_ROWS            SOFTEX_REG_OFFS + 0x20
+#define SOFTEX_IN_ROW_STRIDE   SOFTEX_REG_OFFS + 0x24
+#define SOFTEX_OUT_ROW_STRIDE  SOFTEX_REG_OFFS + 0x28
+#define SOFTEX_SCALE           SOFTEX_REG_OFFS + 0x2C
+#define SOFTEX_VALID_LEN       SOFTEX_REG_OFFS + 0x30
+#define SOFTEX_STATS_ADDR      SOFTEX_REG_OFFS + 0x34
+#define SOFTEX_PREFETCH_SLOT   SOFTEX_REG_OFFS + 0x38
+#define SOFTEX_CPL_ADDR        SOFTEX_REG_OFFS + 0x3C
+#define SOFTEX_CPL_COUNT       SOFTEX_REG_OFFS + 0x40
+#define SOFTEX_EVT_CTRL        SOFTEX_REG_OFFS + 0x44
+#define SOFTEX_ACCURACY_CTRL   SOFTEX_REG_OFFS + 0x48
+#define SOFTEX_OUT_CTRL        SOFTEX_REG_OFFS + 0x4C
+#define SOFTEX_TOPK_ADDR       SOFTEX_REG_OFFS + 0x50
+#define SOFTEX_THRESHOLD       SOFTEX_REG_OFFS + 0x54
 
 
 #define SOFTEX_CMD_ACC_ONLY        0x00000001
@@ -38,5 +82,93 @@
 #define SOFTEX_CMD_NO_OP           0x00000020
 #define SOFTEX_CMD_INT_INPUT       0x00000040
 #define SOFTEX_CMD_INT_OUTPUT      0x00000080
+#define SOFTEX_CMD_DESC_MODE       0x00000100
+#define SOFTEX_CMD_DESC_EVT        0x00000200
+#define SOFTEX_CMD_SCALE           0x00000400
+#define SOFTEX_CMD_MASK            0x00000800
+#define SOFTEX_CMD_CAUSAL          0x00001000
+#define SOFTEX_CMD_STATS_OUT       0x00002000
+#define SOFTEX_CMD_MERGE_STATS     0x00004000
+#define SOFTEX_CMD_DUAL_ROW        0x00008000
+
+// With CMD_SCALE and CMD_MASK the scores are scaled first, then the elements from VALID_LEN on are replaced by -inf
+// and written as exact zeros. A row with no valid element is all zeros, or all NaN with a log-softmax output
+
+// I/O floating point formats, CAST_CTRL[17:16] for the input and CAST_CTRL[19:18] for the output
+#define SOFTEX_FMT_NATIVE          0x0
+#define SOFTEX_FMT_FP16            0x1
+#define SOFTEX_FMT_FP8_E4M3        0x2
+#define SOFTEX_FMT_FP8_E5M2        0x3
+
+// FP8 rows are read half a beat at a time and fill the same lanes as bf16: they halve the memory traffic, but a row
+// takes as many cycles as in bf16
+
+#define SOFTEX_CAST_IN_FMT(fmt)    ((fmt) << 16)
+#define SOFTEX_CAST_OUT_FMT(fmt)   ((fmt) << 18)
+
+#define SOFTEX_DESC_SIZE           0x20
+
+// Row statistics written by SOFTEX_CMD_STATS_OUT at SOFTEX_STATS_ADDR + row * SOFTEX_STATS_SIZE:
+// the maximum (input format, zero-extended) at +0x0 and the denominator (FP32) at +0x4.
+// SOFTEX_CMD_MERGE_STATS reads TOT_LEN / SOFTEX_STATS_SIZE of them from IN_ADDR and combines them.
+#define SOFTEX_STATS_SIZE          0x08
+
+// End of job events, EVT_CTRL. By default every job raises one. With SOFTEX_EVT_EVERY(n) only every n-th
+// completed job does, SOFTEX_EVT_SKIP silences a job and SOFTEX_EVT_MARK always raises it, restarting the count.
+#define SOFTEX_EVT_SKIP            0x00000001
+#define SOFTEX_EVT_MARK            0x00000002
+#define SOFTEX_EVT_EVERY(n)        ((n) << 16)
+
+// Accuracy of a job, ACCURACY_CTRL. 0 is the most accurate setting. SOFTEX_ACCURACY_EXP_RAW skips the mantissa
+// correction of the exponential, SOFTEX_ACCURACY_EXP_TRUNC truncates it instead of rounding and
+// SOFTEX_ACCURACY_NEWTON(n) runs n of the SOFTEX_NEWTON_ITERS Newton-Raphson iterations of the reciprocal.
+#define SOFTEX_NEWTON_ITERS        2
+
+#define SOFTEX_ACCURACY_EXP_RAW    0x00000001
+#define SOFTEX_ACCURACY_EXP_TRUNC  0x00000002
+#define SOFTEX_ACCURACY_NEWTON(n)  (((SOFTEX_NEWTON_ITERS - (n)) & 0x3) << 4)
+#define SOFTEX_ACCURACY_COARSE     (SOFTEX_ACCURACY_EXP_RAW | SOFTEX_ACCURACY_NEWTON(0))
+
+// What a job writes back, OUT_CTRL. SOFTEX_OUT_LOG normalises to x - max - ln(denominator), a log-softmax.
+// SOFTEX_OUT_LSE only writes max + ln(denominator) (FP32) in place of the denominator of the row statistics at
+// SOFTEX_STATS_ADDR, the last ACC_ONLY job of a split row writes it and releases the slot. All the jobs of a slot
+// must use the same mode.
+#define SOFTEX_OUT_SOFTMAX         0x00000000
+#define SOFTEX_OUT_LOG             0x00000001
+#define SOFTEX_OUT_LSE             0x00000002
+
+// Top-k list of each row, OUT_CTRL[7:4]. With SOFTEX_OUT_TOPK(k), k <= SOFTEX_TOPK_MAX, a complete job writes the k
+// largest outputs of each row to SOFTEX_TOPK_ADDR + row * k * SOFTEX_TOPK_ENTRY_SIZE, best first and the lowest
+// index on ties: the index at +0x0 and the output value (datapath format, zero-extended) at +0x4. The argmax is the
+// index of the first entry. Entries past the end of a short row have an index of 0xffffffff.
+#define SOFTEX_TOPK_MAX            8
+#define SOFTEX_TOPK_ENTRY_SIZE     0x08
+#define SOFTEX_OUT_TOPK(k)         ((k) << 4)
+
+// Sparse output, OUT_CTRL[8]. With SOFTEX_OUT_SPARSE a complete job writes only the outputs above SOFTEX_THRESHOLD
+// (datapath format, in the lower bits), in the top-k entry layout and by increasing index, from
+// OUT_ADDR + row * OUT_ROW_STRIDE + SOFTEX_SPARSE_HDR_SIZE. The number of entries is written at the start of the
+// row, in the lower word of the header. The output cast does not apply: the values are in the datapath format.
+#define SOFTEX_OUT_SPARSE          0x00000100
+#define SOFTEX_SPARSE_HDR_SIZE     0x08
+#define SOFTEX_SPARSE_ENTRY_SIZE   0x08
+
+// Elementwise activation instead of a softmax, OUT_CTRL[14:12]. A complete job writes f(x) of each element to OUT_ADDR,
+// with the I/O formats of CAST_CTRL, and ignores OUT_MODE and CMD_MASK. CMD_SCALE applies to SOFTEX_ACT_EXP only. The
+// GELU is the sigmoid approximation x * sigmoid(1.703125 * x). Outputs can be sparse or record a top-k.
+#define SOFTEX_ACT_NONE            0
+#define SOFTEX_ACT_EXP             1
+#define SOFTEX_ACT_SIGMOID         2
+#define SOFTEX_ACT_SILU            3
+#define SOFTEX_ACT_GELU            4
+#define SOFTEX_OUT_ACT(act)        ((act) << 12)
+
+// Completion records, written at CPL_ADDR + index * SOFTEX_CPL_SIZE by every job that runs the datapath when
+// CPL_COUNT is not zero. The index wraps at CPL_COUNT. Job ids count the jobs completed since the last soft clear.
+#define SOFTEX_CPL_SIZE            0x10
+
+#define SOFTEX_CPL_DONE            0x00000001
+#define SOFTEX_CPL_EVT             0x00000002
+#define SOFTEX_CPL_DESC            0x00000004
 
 #endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#ifndef __BENCH__
+#define __BENCH__
+
+#include <stddef.h>
+
+#include "tinyprintf.h"
+#include "hal_softex.h"
+
+// Cycles and retired instructions spent in one phase of a benchmark, summed over its start/stop pairs
+typedef struct {
+    unsigned int cycles;
+    unsigned int instret;
+    unsigned int start_cycles;
+    unsigned int start_instret;
+} bench_cnt_t;
+
+static inline unsigned int bench_mcycle() {
+    unsigned int c;
+
+    asm volatile("csrr %0, mcycle" : "=r" (c));
+
+    return c;
+}
+
+static inline unsigned int bench_minstret() {
+    unsigned int c;
+
+    asm volatile("csrr %0, minstret" : "=r" (c));
+
+    return c;
+}
+
+// The core clock is gated while it sleeps in wfi and mcycle stops with it, so the timed waits poll this record instead
+static softex_cpl_t bench_cpl;
+
+// Makes the job being programmed write "bench_cpl" when it completes, or no record at all. Every job has to set it,
+// a context keeps the registers of its previous job
+static inline void bench_track(int track) {
+    hwpe_cpl_ring(track ? &bench_cpl : NULL, track ? 1 : 0);
+}
+
+// Spins until the tracked job has completed and clears the record for the next one
+static inline void bench_wait() {
+    volatile softex_cpl_t *cpl = &bench_cpl;
+
+    while (!(cpl->status & SOFTEX_CPL_DONE)) {
+
+    }
+
+    cpl->status = 0;
+}
+
+static inline void bench_init() {
+    init_printf(NULL, (putcf) putf);
+
+    printf("CSV,phase,elements,cycles,instret,cycles/element\n");
+}
+
+static inline void bench_start(bench_cnt_t *cnt) {
+    cnt->start_cycles   = bench_mcycle();
+    cnt->start_instret  = bench_minstret();
+}
+
+static inline void bench_stop(bench_cnt_t *cnt) {
+    cnt->cycles  += bench_mcycle() - cnt->start_cycles;
+    cnt->instret += bench_minstret() - cnt->start_instret;
+}
+
+// One CSV record, collected by scripts/bench.sh. tinyprintf has no %f, so cycles/element gets two fixed decimals
+static inline void bench_report(const char *phase, unsigned int elements, const bench_cnt_t *cnt) {
+    unsigned int whole  = cnt->cycles / elements,
+                 frac   = cnt->cycles % elements * 100 / elements;
+
+    printf("CSV,%s,%u,%u,%u,%u.%02u\n", phase, elements, cnt->cycles, cnt->instret, whole, frac);
+}
+
+#endif
@@ -0,0 +1,66 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// One blocking job per vector. "setup" is the host overhead from the acquire to the trigger, "softmax" the time
+// spent waiting for the completion record.
+
+#include <stdint.h>
+
+#include "hal_softex.h"
+#include "archi_softex.h"
+#include "bench/bench.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+STIM_ARRAY(uint16_t, scores);
+
+int main () {
+
+    bench_cnt_t setup   = {0},
+                softmax = {0},
+                total   = {0};
+
+    bench_init();
+
+    hwpe_soft_clear();
+
+    bench_start(&total);
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        bench_start(&setup);
+
+        while (hwpe_acquire_job() < 0) {
+
+        }
+
+        HWPE_WRITE(((int) scores) + i * LENGTH * FMT_WIDTH, SOFTEX_IN_ADDR);
+        HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_TOT_LEN);
+        HWPE_WRITE(OUT_ADDR + i * LENGTH * FMT_WIDTH, SOFTEX_OUT_ADDR);
+        bench_track(1);
+
+        hwpe_trigger_job();
+
+        bench_stop(&setup);
+        bench_start(&softmax);
+
+        bench_wait();
+
+        bench_stop(&softmax);
+    }
+
+    bench_stop(&total);
+
+    bench_report("setup", LENGTH * N_VECTORS, &setup);
+    bench_report("softmax", LENGTH * N_VECTORS, &softmax);
+    bench_report("total", LENGTH * N_VECTORS, &total);
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
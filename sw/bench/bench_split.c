@@ -0,0 +1,101 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Each vector is split after SPLIT elements into two partial accumulations and two partial normalisations.
+// Only the second job of each phase raises an event and writes the completion record, so that "accumulation" and
+// "normalisation" time whole phases.
+
+#include <stdint.h>
+
+#include "hal_softex.h"
+#include "archi_softex.h"
+#include "bench/bench.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+#ifndef SPLIT
+#define SPLIT   (LENGTH / 2)
+#endif
+
+STIM_ARRAY(uint16_t, scores);
+
+static softex_stats_t cache[N_VECTORS];
+
+static void push_job(unsigned int in, unsigned int out, unsigned int tot_len, unsigned int commands, unsigned int evt_ctrl) {
+    while (hwpe_acquire_job() < 0) {
+
+    }
+
+    HWPE_WRITE(in, SOFTEX_IN_ADDR);
+    HWPE_WRITE(out, SOFTEX_OUT_ADDR);
+    HWPE_WRITE(tot_len, SOFTEX_TOT_LEN);
+    HWPE_WRITE(commands, SOFTEX_COMMANDS);
+    HWPE_WRITE(evt_ctrl, SOFTEX_EVT_CTRL);
+    bench_track(evt_ctrl != SOFTEX_EVT_SKIP);
+
+    hwpe_trigger_job();
+}
+
+int main () {
+
+    bench_cnt_t setup           = {0},
+                accumulation    = {0},
+                normalisation   = {0},
+                total           = {0};
+
+    bench_init();
+
+    hwpe_soft_clear();
+
+    bench_start(&total);
+
+    while (hwpe_acquire_job() < 0) {
+
+    }
+
+    HWPE_WRITE((int) cache, SOFTEX_CACHE_BASE_ADDR);
+    HWPE_WRITE(SOFTEX_CMD_SET_CACHE_ADDR | SOFTEX_CMD_NO_OP, SOFTEX_COMMANDS);
+    HWPE_WRITE(SOFTEX_EVT_SKIP, SOFTEX_EVT_CTRL);
+
+    hwpe_trigger_job();
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        unsigned int in     = ((unsigned int) scores) + i * LENGTH * FMT_WIDTH,
+                     out    = OUT_ADDR + i * LENGTH * FMT_WIDTH;
+
+        bench_start(&setup);
+        push_job(in, 0, SPLIT * FMT_WIDTH, SOFTEX_CMD_ACC_ONLY | SOFTEX_CMD_ACQUIRE_SLOT | (i << 16), SOFTEX_EVT_SKIP);
+        push_job(in + SPLIT * FMT_WIDTH, 0, (LENGTH - SPLIT) * FMT_WIDTH, SOFTEX_CMD_ACC_ONLY | SOFTEX_CMD_LAST | (i << 16), 0);
+        bench_stop(&setup);
+
+        bench_start(&accumulation);
+        bench_wait();
+        bench_stop(&accumulation);
+
+        bench_start(&setup);
+        push_job(in, out, SPLIT * FMT_WIDTH, SOFTEX_CMD_DIV_ONLY | (i << 16), SOFTEX_EVT_SKIP);
+        push_job(in + SPLIT * FMT_WIDTH, out + SPLIT * FMT_WIDTH, (LENGTH - SPLIT) * FMT_WIDTH, SOFTEX_CMD_DIV_ONLY | SOFTEX_CMD_LAST | (i << 16), 0);
+        bench_stop(&setup);
+
+        bench_start(&normalisation);
+        bench_wait();
+        bench_stop(&normalisation);
+    }
+
+    bench_stop(&total);
+
+    bench_report("setup", LENGTH * N_VECTORS, &setup);
+    bench_report("accumulation", LENGTH * N_VECTORS, &accumulation);
+    bench_report("normalisation", LENGTH * N_VECTORS, &normalisation);
+    bench_report("total", LENGTH * N_VECTORS, &total);
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
@@ -0,0 +1,55 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Every vector is queued through the runtime before waiting for any of them. "submit" is the host time spent
+// queueing, which includes the acquire spins while the contexts are full, "drain" the wait for the last ones.
+
+#include <stdint.h>
+
+#include "softex_rt.h"
+#include "bench/bench.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+STIM_ARRAY(uint16_t, scores);
+
+int main () {
+
+    bench_cnt_t submit  = {0},
+                drain   = {0},
+                total   = {0};
+
+    bench_init();
+
+    softex_rt_init(0);
+
+    bench_start(&total);
+
+    bench_start(&submit);
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        softex_softmax_async(scores + i * LENGTH, (void *) (OUT_ADDR + i * LENGTH * FMT_WIDTH), LENGTH, SOFTEX_RT_NATIVE);
+    }
+
+    bench_stop(&submit);
+
+    bench_start(&drain);
+    softex_wait_all();
+    bench_stop(&drain);
+
+    bench_stop(&total);
+
+    bench_report("submit", LENGTH * N_VECTORS, &submit);
+    bench_report("drain", LENGTH * N_VECTORS, &drain);
+    bench_report("total", LENGTH * N_VECTORS, &total);
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
@@ -13,6 +13,46 @@
 #define HWPE_WRITE(value, offset) *(volatile int *)(SOFTEX_BASE_ADD + offset) = value
 #define HWPE_READ(offset) *(volatile int *)(SOFTEX_BASE_ADD + offset)
 
+// Job descriptor, the fields mirror the IN_ADDR, OUT_ADDR, TOT_LEN, COMMANDS, CAST_CTRL, ROWS, IN_ROW_STRIDE and OUT_ROW_STRIDE registers
+typedef struct {
+    unsigned int in_addr;
+    unsigned int out_addr;
+    unsigned int tot_len;
+    unsigned int commands;
+    unsigned int cast_ctrl;
+    unsigned int rows;
+    unsigned int in_row_stride;
+    unsigned int out_row_stride;
+} softex_desc_t;
+
+// Row statistics as written by SOFTEX_CMD_STATS_OUT and read by SOFTEX_CMD_MERGE_STATS. With SOFTEX_OUT_LSE the
+// denominator is replaced by the log-sum-exp of the row
+typedef struct {
+    unsigned int max;
+    unsigned int denominator;
+} softex_stats_t;
+
+// Top-k entry, see SOFTEX_OUT_TOPK
+typedef struct {
+    unsigned int index;
+    unsigned int value;
+} softex_topk_t;
+
+// Sparse row, see SOFTEX_OUT_SPARSE
+typedef struct {
+    unsigned int  count;
+    unsigned int  reserved;
+    softex_topk_t entries[];
+} softex_sparse_t;
+
+// Completion record, see SOFTEX_CPL_ADDR
+typedef struct {
+    unsigned int job_id;
+    unsigned int status;
+    unsigned int cycles;
+    unsigned int reserved;
+} softex_cpl_t;
+
 static inline void hwpe_trigger_job() {
     HWPE_WRITE(0, SOFTEX_TRIGGER);
 }
@@ -29,4 +69,26 @@ static inline void hwpe_soft_clear() {
   HWPE_WRITE(0, SOFTEX_SOFT_CLEAR);
 }
 
+static inline unsigned int hwpe_perf_read(int counter) {
+    return HWPE_READ(counter);
+}
+
+// Brings state slot "slot_id" on chip ahead of the job that will use it. The slot is not reserved and may still be replaced
+static inline void hwpe_prefetch_slot(unsigned int slot_id) {
+    HWPE_WRITE(slot_id, SOFTEX_PREFETCH_SLOT);
+}
+
+// Programs a job that executes "count" descriptors starting from "ring". The job still has to be triggered
+static inline void hwpe_desc_ring(softex_desc_t *ring, unsigned int count, unsigned int commands) {
+    HWPE_WRITE((int) ring, SOFTEX_DESC_ADDR);
+    HWPE_WRITE(count, SOFTEX_DESC_COUNT);
+    HWPE_WRITE(SOFTEX_CMD_DESC_MODE | commands, SOFTEX_COMMANDS);
+}
+
+// The job being programmed writes its completion record to the ring of "count" entries at "ring". SoftEx keeps the write index
+static inline void hwpe_cpl_ring(softex_cpl_t *ring, unsigned int count) {
+    HWPE_WRITE((int) ring, SOFTEX_CPL_ADDR);
+    HWPE_WRITE(count, SOFTEX_CPL_COUNT);
+}
+
 #endif
\ No newline at end of file
@@ -14,7 +14,7 @@
 #include "golden-model/scores.h"
 #include "golden-model/golden.h"
 
-static uint16_t scores[LENGTH] = SCORES;
+STIM_ARRAY(uint16_t, scores);
 
 int main () {
 
@@ -59,7 +59,7 @@ int main () {
 
     HWPE_WRITE(scores, SOFTEX_IN_ADDR);
     HWPE_WRITE(LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_TOT_LEN);
-    HWPE_WRITE(0x1c010000, SOFTEX_OUT_ADDR);
+    HWPE_WRITE(OUT_ADDR, SOFTEX_OUT_ADDR);
     HWPE_WRITE(SOFTEX_CMD_DIV_ONLY | (slot_id << 16), SOFTEX_COMMANDS);
 
     hwpe_trigger_job();
@@ -70,7 +70,7 @@ int main () {
 
     HWPE_WRITE(((int) scores) + LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_IN_ADDR);
     HWPE_WRITE(LENGTH * FMT_WIDTH - LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_TOT_LEN);
-    HWPE_WRITE(0x1c010000 + LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_OUT_ADDR);
+    HWPE_WRITE(OUT_ADDR + LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_OUT_ADDR);
     HWPE_WRITE(SOFTEX_CMD_DIV_ONLY | SOFTEX_CMD_LAST | (slot_id << 16), SOFTEX_COMMANDS);
 
     hwpe_trigger_job();
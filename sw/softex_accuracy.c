@@ -0,0 +1,38 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Runs every vector with the ACCURACY_CTRL the golden model was generated for (make ... exp_correction=0
+// exp_rounding=0 newton_iters=1). Odd vectors are split in partial jobs, so both the whole and the partial
+// reciprocal honour the setting.
+
+#include <stdint.h>
+
+#include "tinyprintf.h"
+#include "softex_rt.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+STIM_ARRAY(uint16_t, scores);
+
+int main () {
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        softex_wait_all();
+        softex_rt_init(i % 2 ? (LENGTH + 1) / 2 : 0);
+        softex_rt_accuracy(ACCURACY);
+
+        softex_softmax_async(scores + i * LENGTH, (void *) (OUT_ADDR + i * LENGTH * FMT_WIDTH), LENGTH, SOFTEX_RT_NATIVE);
+    }
+
+    softex_wait_all();
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
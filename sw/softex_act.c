@@ -0,0 +1,38 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Elementwise activation of every vector against a golden model generated with out_mode=EXP, SIGMOID, SILU or GELU.
+// The runtime splits jobs longer than half a vector, which the activations must ignore.
+
+#include <stdint.h>
+
+#include "tinyprintf.h"
+#include "softex_rt.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+#ifndef OUT_ACT
+#error "Generate the golden model with golden-cpp and out_mode=EXP, SIGMOID, SILU or GELU"
+#endif
+
+STIM_ARRAY(uint16_t, scores);
+
+int main () {
+
+    softex_rt_init((LENGTH + 1) / 2);
+
+    for (int i = 0; i < N_VECTORS; i++)
+        softex_act_async(scores + i * LENGTH, (void *) (OUT_ADDR + i * LENGTH * FMT_WIDTH), LENGTH, SOFTEX_RT_NATIVE, OUT_ACT);
+
+    softex_wait_all();
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
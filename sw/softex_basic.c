@@ -14,7 +14,7 @@
 #include "golden-model/scores.h"
 #include "golden-model/golden.h"
 
-static uint16_t scores[LENGTH] = SCORES;
+STIM_ARRAY(uint16_t, scores);
 
 int main () {
 
@@ -28,7 +28,7 @@ int main () {
 
     HWPE_WRITE(scores, SOFTEX_IN_ADDR);
     HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_TOT_LEN);
-    HWPE_WRITE(0x1c010000, SOFTEX_OUT_ADDR);
+    HWPE_WRITE(OUT_ADDR, SOFTEX_OUT_ADDR);
     
     hwpe_trigger_job();
 
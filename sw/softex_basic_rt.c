@@ -0,0 +1,31 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// softex_basic.c through the runtime: the run cycles printed by the tb of the two programs give the cost of the
+// runtime's programming of the job.
+
+#include <stdint.h>
+
+#include "tinyprintf.h"
+#include "softex_rt.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+STIM_ARRAY(uint16_t, scores);
+
+int main () {
+
+    softex_rt_init(0);
+
+    softex_wait(softex_softmax_async(scores, (void *) OUT_ADDR, LENGTH, SOFTEX_RT_NATIVE));
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
@@ -0,0 +1,77 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "tinyprintf.h"
+#include "hal_softex.h"
+#include "archi_softex.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+// As many jobs as the controller can queue
+#define BATCH   4
+
+STIM_ARRAY(uint16_t, scores);
+
+static volatile softex_cpl_t ring[BATCH];
+
+int main () {
+
+    int acq_res;
+    int errors = 0;
+
+    init_printf(NULL, (putcf) putf);
+
+    hwpe_soft_clear();
+
+    for (int b = 0; b < N_VECTORS; b += BATCH) {
+        for (int i = b; i < b + BATCH && i < N_VECTORS; i++) {
+            while ((acq_res = hwpe_acquire_job()) < 0) {
+
+            }
+
+            HWPE_WRITE(((int) scores) + i * LENGTH * FMT_WIDTH, SOFTEX_IN_ADDR);
+            HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_TOT_LEN);
+            HWPE_WRITE(OUT_ADDR + i * LENGTH * FMT_WIDTH, SOFTEX_OUT_ADDR);
+            HWPE_WRITE(0, SOFTEX_COMMANDS);
+
+            hwpe_cpl_ring((softex_cpl_t *) ring, BATCH);
+
+            // The first half of the vectors uses the coalesced events, the second one marks the last job of each batch
+            if (i < N_VECTORS / 2) {
+                HWPE_WRITE(SOFTEX_EVT_EVERY(BATCH), SOFTEX_EVT_CTRL);
+            } else {
+                HWPE_WRITE(i == b + BATCH - 1 || i == N_VECTORS - 1 ? SOFTEX_EVT_MARK : SOFTEX_EVT_SKIP, SOFTEX_EVT_CTRL);
+            }
+
+            hwpe_trigger_job();
+        }
+
+        // A single wake up for the whole batch
+        asm volatile("wfi" ::: "memory");
+
+        for (int i = b; i < b + BATCH && i < N_VECTORS; i++) {
+            while (ring[i % BATCH].status == 0) {
+
+            }
+
+            if (ring[i % BATCH].job_id != (unsigned int) i || ring[i % BATCH].cycles == 0)
+                errors++;
+
+            ring[i % BATCH].status = 0;
+        }
+    }
+
+    //End the simulation, the number of malformed completion records is the exit code
+    *(volatile int *)(0x80000000) = errors;
+
+	return 0;
+}
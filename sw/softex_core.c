@@ -0,0 +1,505 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Integer re-implementation of the SoftEx datapath, following golden-model/softex_model.hpp step by step.
+// The core has no FPU and the firmware is linked without libgcc, so the FP32 operations are done here with
+// 32-bit shifts, the widening multiply of the M extension and no count leading zeros instruction.
+
+#include "softex_core.h"
+
+#define MAX_BEATS   ((SOFTEX_CORE_MAX_LEN + SOFTEX_CORE_LANES - 1) / SOFTEX_CORE_LANES)
+
+#define BF16_NEG_INF    0xff80
+#define BF16_POS_INF    0x7f80
+#define F32_NAN         0x7fc00000
+#define F32_INF         0x7f800000
+
+// expu_schraudolph and expu_correction constants for FP16ALT
+#define EXPU_A_FRACTION 14
+#define EXPU_A          23637
+#define EXPU_MAX_EXP    133
+#define EXPU_ALPHA      4
+#define EXPU_BETA       7
+#define EXPU_GAMMA_1    363
+#define EXPU_GAMMA_2    278
+
+/**********64-BIT HELPERS**********/
+
+static uint64_t shl64(uint64_t v, unsigned int s) {
+    uint32_t hi = v >> 32,
+             lo = (uint32_t) v;
+
+    if (s == 0)
+        return v;
+
+    if (s >= 32)
+        return (uint64_t) (lo << (s - 32)) << 32;
+
+    return (uint64_t) ((hi << s) | (lo >> (32 - s))) << 32 | (lo << s);
+}
+
+// Right shift that ORs the shifted out bits into the LSB
+static uint64_t shr64_jam(uint64_t v, unsigned int s) {
+    uint32_t hi = v >> 32,
+             lo = (uint32_t) v;
+
+    if (s == 0)
+        return v;
+
+    if (s >= 64)
+        return v != 0;
+
+    if (s >= 32)
+        return (s == 32 ? hi : hi >> (s - 32)) | ((s != 32 && (hi << (64 - s)) != 0) || lo != 0);
+
+    return (uint64_t) (hi >> s) << 32 | (hi << (32 - s)) | (lo >> s) | ((lo << (32 - s)) != 0);
+}
+
+static unsigned int clz64(uint64_t v) {
+    uint32_t     w = v >> 32;
+    unsigned int n = 0;
+
+    if (w == 0) {
+        n = 32;
+        w = (uint32_t) v;
+    }
+
+    if ((w >> 16) == 0) { n += 16; w <<= 16; }
+    if ((w >> 24) == 0) { n += 8;  w <<= 8;  }
+    if ((w >> 28) == 0) { n += 4;  w <<= 4;  }
+    if ((w >> 30) == 0) { n += 2;  w <<= 2;  }
+    if ((w >> 31) == 0) { n += 1; }
+
+    return n;
+}
+
+/**********FP32**********/
+
+// value = sig * 2 ** exp, with sig not zero
+typedef struct {
+    uint32_t    sign;
+    int         exp;
+    uint64_t    sig;
+} unpacked_t;
+
+static int is_nan(uint32_t a) {
+    return (a & 0x7fffffff) > F32_INF;
+}
+
+static int is_inf(uint32_t a) {
+    return (a & 0x7fffffff) == F32_INF;
+}
+
+static int is_zero(uint32_t a) {
+    return (a & 0x7fffffff) == 0;
+}
+
+static unpacked_t unpack(uint32_t a) {
+    unpacked_t u;
+    uint32_t   e = (a >> 23) & 0xff;
+
+    u.sign  = a >> 31;
+    u.sig   = e == 0 ? (a & 0x7fffff) : (a & 0x7fffff) | 0x800000;
+    u.exp   = e == 0 ? -149 : (int) e - 150;
+
+    return u;
+}
+
+// Normalises the significand to bit 61, leaving room for the carry of an addition
+static void normalise(unpacked_t *u) {
+    unsigned int lz = clz64(u->sig);
+
+    u->sig  = shl64(u->sig, lz - 2);
+    u->exp -= lz - 2;
+}
+
+// Rounds to nearest even, with denormals and overflows to infinity
+static uint32_t round_pack(uint32_t sign, int exp, uint64_t sig) {
+    unsigned int lz = clz64(sig);
+    int          e;
+    uint32_t     mant;
+    int          guard,
+                 sticky;
+
+    if (lz > 1) {
+        sig  = shl64(sig, lz - 1);
+        exp -= lz - 1;
+    } else if (lz == 0) {
+        sig  = shr64_jam(sig, 1);
+        exp += 1;
+    }
+
+    e = exp + 62 + 127;
+
+    if (e >= 255)
+        return sign << 31 | F32_INF;
+
+    if (e <= 0) {
+        sig = shr64_jam(sig, 1 - e);
+        e   = 0;
+    }
+
+    mant    = sig >> 39;
+    guard   = (sig >> 38) & 1;
+    sticky  = (sig & 0x3fffffffffULL) != 0;
+
+    return (sign << 31) + ((uint32_t) (e > 0 ? e - 1 : 0) << 23) + mant + (guard && (sticky || (mant & 1)));
+}
+
+// Sum of two normalised operands
+static uint32_t add_unpacked(unpacked_t a, unpacked_t b) {
+    unpacked_t t;
+    uint64_t   sig;
+    uint32_t   sign;
+
+    if (a.exp < b.exp || (a.exp == b.exp && a.sig < b.sig)) {
+        t = a;
+        a = b;
+        b = t;
+    }
+
+    b.sig = shr64_jam(b.sig, a.exp - b.exp > 63 ? 64 : a.exp - b.exp);
+
+    if (a.sign == b.sign) {
+        sig  = a.sig + b.sig;
+        sign = a.sign;
+    } else {
+        sig  = a.sig - b.sig;
+        sign = a.sign;
+    }
+
+    if (sig == 0)
+        return 0;
+
+    return round_pack(sign, a.exp, sig);
+}
+
+static uint32_t f32_add(uint32_t a, uint32_t b) {
+    unpacked_t ua,
+               ub;
+
+    if (is_nan(a) || is_nan(b))
+        return F32_NAN;
+
+    if (is_inf(a))
+        return is_inf(b) && (a ^ b) >> 31 ? F32_NAN : a;
+
+    if (is_inf(b))
+        return b;
+
+    if (is_zero(a))
+        return is_zero(b) ? a & b : b;
+
+    if (is_zero(b))
+        return a;
+
+    ua = unpack(a);
+    ub = unpack(b);
+
+    normalise(&ua);
+    normalise(&ub);
+
+    return add_unpacked(ua, ub);
+}
+
+static uint32_t f32_mul(uint32_t a, uint32_t b) {
+    uint32_t   sign = (a ^ b) >> 31;
+    unpacked_t ua,
+               ub;
+
+    if (is_nan(a) || is_nan(b))
+        return F32_NAN;
+
+    if (is_inf(a) || is_inf(b))
+        return is_zero(a) || is_zero(b) ? F32_NAN : sign << 31 | F32_INF;
+
+    if (is_zero(a) || is_zero(b))
+        return sign << 31;
+
+    ua = unpack(a);
+    ub = unpack(b);
+
+    return round_pack(sign, ua.exp + ub.exp, (uint64_t) (uint32_t) ua.sig * (uint32_t) ub.sig);
+}
+
+// a * b + c with a single rounding
+static uint32_t f32_fma(uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t   sign = (a ^ b) >> 31;
+    unpacked_t up,
+               uc;
+
+    if (is_nan(a) || is_nan(b) || is_nan(c))
+        return F32_NAN;
+
+    if (is_inf(a) || is_inf(b)) {
+        if (is_zero(a) || is_zero(b) || (is_inf(c) && (c >> 31) != sign))
+            return F32_NAN;
+
+        return sign << 31 | F32_INF;
+    }
+
+    if (is_inf(c))
+        return c;
+
+    if (is_zero(a) || is_zero(b))
+        return is_zero(c) ? (sign << 31) & c : c;
+
+    if (is_zero(c))
+        return f32_mul(a, b);
+
+    up = unpack(a);
+    uc = unpack(b);
+
+    up.sign = sign;
+    up.exp += uc.exp;
+    up.sig  = (uint64_t) (uint32_t) up.sig * (uint32_t) uc.sig;
+
+    uc = unpack(c);
+
+    normalise(&up);
+    normalise(&uc);
+
+    return add_unpacked(up, uc);
+}
+
+/**********BF16**********/
+
+static uint32_t bf16_to_f32(uint16_t h) {
+    return (uint32_t) h << 16;
+}
+
+static uint16_t f32_to_bf16(uint32_t b) {
+    if (is_nan(b))
+        return (b >> 16) | 0x0040;
+
+    return (b + 0x7fff + ((b >> 16) & 1)) >> 16;
+}
+
+static uint16_t bf16_sub(uint16_t a, uint16_t b) {
+    return f32_to_bf16(f32_add(bf16_to_f32(a), bf16_to_f32(b) ^ 0x80000000));
+}
+
+static uint16_t bf16_mul(uint16_t a, uint16_t b) {
+    return f32_to_bf16(f32_mul(bf16_to_f32(a), bf16_to_f32(b)));
+}
+
+// FP_GT of softex_macros.svh
+static uint16_t order_key(uint16_t h) {
+    return h & 0x8000 ? (uint16_t) ~h : (uint16_t) (h | 0x8000);
+}
+
+/**********EXPU**********/
+
+static uint16_t exp_schraudolph(uint16_t op) {
+    uint32_t sign       = op >> 15;
+    uint32_t exponent   = (op >> 7) & 0xff;
+    uint32_t mantissa   = 0x80 | (op & 0x7f);
+
+    uint32_t scaled     = mantissa * EXPU_A;
+    uint32_t shamt      = EXPU_MAX_EXP - exponent;
+    uint32_t shifted    = exponent > EXPU_MAX_EXP || shamt >= 32 ? 0 : (scaled >> (EXPU_A_FRACTION - 7)) >> shamt;
+    uint32_t rounded    = ((shifted >> 1) + (shifted & 1)) & 0x7fff;
+    uint32_t sgn_mant   = (sign ? 0u - rounded : rounded) & 0x7fff;
+
+    int ovfr        = exponent > EXPU_MAX_EXP ||
+                      (exponent == EXPU_MAX_EXP && (((scaled >> 22) & 1) || (sign && ((scaled >> 14) & 0xff) == 0xff)));
+    int denormal    = sign && exponent == EXPU_MAX_EXP && (sgn_mant >> 7) == 0x81;
+
+    if (ovfr || denormal)
+        return sign ? 0x0000 : BF16_POS_INF;
+
+    return (((sgn_mant >> 7) + 127) & 0xff) << 7 | (sgn_mant & 0x7f);
+}
+
+static uint16_t exp_correction(uint16_t op) {
+    uint32_t mantissa   = op & 0x7f;
+    int      upper      = (mantissa >> 6) & 1;
+
+    uint32_t mul_1      = upper ? (~(mantissa << 1) & 0x7f) : ((mantissa << 1) & 0x7f);
+    uint32_t res_mul_1  = mul_1 * (upper ? EXPU_BETA : EXPU_ALPHA);
+    uint32_t res_add_1  = mantissa + (upper ? EXPU_GAMMA_2 : EXPU_GAMMA_1);
+    uint32_t res_pre    = ((res_mul_1 * res_add_1) >> 12) & 0x7f;
+
+    return (op & 0x7f80) | (upper ? (~res_pre & 0x7f) : res_pre);
+}
+
+static uint16_t expu(uint16_t op) {
+    return exp_correction(exp_schraudolph(op));
+}
+
+/**********INVERSION**********/
+
+// softex_acc_den_inverter followed by the Newton-Raphson iterations
+static uint32_t reciprocal(uint32_t den) {
+    uint32_t sign       = den >> 31;
+    uint32_t exponent   = (den >> 23) & 0xff;
+    uint32_t sel        = (den >> 16) & 0x7f;
+    uint32_t inv        = ~sel & 0x7f;
+    uint32_t x;
+
+    if (sel == 0)
+        x = sign << 31 | ((254 - exponent) & 0xff) << 23;
+    else
+        x = sign << 31 | ((253 - exponent) & 0xff) << 23 | ((((inv >> 1) * inv) >> 6) & 0x7f) << 16;
+
+    for (int i = 0; i < SOFTEX_CORE_NEWTON; i++)
+        x = f32_mul(x, f32_fma(den ^ 0x80000000, x, 0x40000000));
+
+    return x;
+}
+
+/**********ACCUMULATION**********/
+
+// softex_fp_add_rec. With a power of two lanes, splitting in halves is the same as summing adjacent pairs level by level
+static uint32_t tree_sum(uint32_t *v, unsigned int n) {
+    for (; n > 1; n /= 2) {
+        for (unsigned int i = 0; i < n / 2; i++)
+            v[i] = f32_add(v[2 * i], v[2 * i + 1]);
+    }
+
+    return v[0];
+}
+
+typedef struct {
+    uint32_t        value;
+    unsigned int    tag;
+} partial_t;
+
+// One pass of the partial at the output of the FMA. The queue is a circular buffer of "size" entries starting at "head"
+static void acc_step(partial_t *ring, unsigned int size, unsigned int *head, const uint32_t *sums, const unsigned int *tags, unsigned int *next, unsigned int n_beats, const uint16_t *factors, unsigned int n_factors) {
+    partial_t      *p       = &ring[*head];
+    unsigned int    lowest  = p->tag;
+    int             flushing = *next >= n_beats;
+
+    for (unsigned int i = 0; i < size; i++)
+        lowest = ring[i].tag < lowest ? ring[i].tag : lowest;
+
+    if (!flushing && tags[*next] == p->tag) {
+        p->value = f32_add(p->value, sums[(*next)++]);
+    } else if (p->tag == lowest && p->tag < n_factors) {
+        uint32_t f = bf16_to_f32(factors[p->tag]);
+
+        if (!flushing && tags[*next] == p->tag + 1)
+            p->value = f32_fma(f, p->value, sums[(*next)++]);
+        else
+            p->value = f32_mul(f, p->value);
+
+        p->tag++;
+    } else {
+        p->value = f32_add(p->value, 0);
+    }
+
+    *head = *head + 1 == size ? 0 : *head + 1;
+}
+
+// The partial accumulations of softex_acc_datapath, see accumulate_partials in the model. A partial carries the
+// tag of the maximum it refers to and can only be rescaled when its tag is the lowest among the ones in flight
+static uint32_t accumulate(const uint32_t *sums, const unsigned int *tags, unsigned int n_beats, const uint16_t *factors, unsigned int n_factors) {
+    partial_t       ring    [SOFTEX_CORE_ACC_REGS];
+    uint32_t        queue   [2 * SOFTEX_CORE_ACC_REGS];
+    unsigned int    head    = 0,
+                    size    = 0,
+                    next    = 0,
+                    front   = 0,
+                    back    = 0;
+    int             pending = 1;
+
+    while (size < SOFTEX_CORE_ACC_REGS && next < n_beats) {
+        ring[size].value    = f32_add(sums[next], 0);
+        ring[size].tag      = tags[next];
+        size++;
+        next++;
+    }
+
+    while (next < n_beats)
+        acc_step(ring, size, &head, sums, tags, &next, n_beats, factors, n_factors);
+
+    while (pending) {
+        pending = 0;
+
+        for (unsigned int i = 0; i < size; i++)
+            pending |= ring[i].tag < n_factors;
+
+        if (pending)
+            acc_step(ring, size, &head, sums, tags, &next, n_beats, factors, n_factors);
+    }
+
+    // Final reduction: every other output is pushed back and summed with the next one
+    for (unsigned int i = 0; i < size; i++)
+        queue[back++] = ring[head + i >= size ? head + i - size : head + i].value;
+
+    while (back - front > 1) {
+        queue[back] = f32_add(queue[front + 1], queue[front]);
+        front += 2;
+        back++;
+    }
+
+    return queue[front];
+}
+
+int softex_core_softmax(const uint16_t *in, uint16_t *out, unsigned int len) {
+    uint32_t        sums        [MAX_BEATS];
+    unsigned int    tags        [MAX_BEATS];
+    uint16_t        factors     [MAX_BEATS];
+    uint16_t        beat_max    [MAX_BEATS];
+    uint16_t        exps        [MAX_BEATS * SOFTEX_CORE_LANES];
+
+    unsigned int    n_beats     = (len + SOFTEX_CORE_LANES - 1) / SOFTEX_CORE_LANES,
+                    n_factors   = 0;
+    uint16_t        cur_max     = BF16_NEG_INF;
+    uint16_t        inv;
+
+    if (len == 0 || len > SOFTEX_CORE_MAX_LEN)
+        return -1;
+
+    // The maximum is a sequential scan. As in the RTL, the lanes past the end of the row read as zero and the
+    // strobes of the last beat cover twice as many lanes as there are elements
+    for (unsigned int k = 0; k < n_beats; k++) {
+        const uint16_t *v       = in + k * SOFTEX_CORE_LANES;
+        uint32_t        e       [SOFTEX_CORE_LANES];
+        unsigned int    valid   = len - k * SOFTEX_CORE_LANES < SOFTEX_CORE_LANES ? len - k * SOFTEX_CORE_LANES : SOFTEX_CORE_LANES;
+        unsigned int    strobed = valid == SOFTEX_CORE_LANES || 2 * valid > SOFTEX_CORE_LANES ? SOFTEX_CORE_LANES : 2 * valid;
+        uint16_t        key     = strobed > valid ? order_key(0) : 0;
+        uint16_t        vect_max;
+
+        for (unsigned int i = 0; i < valid; i++)
+            key = order_key(v[i]) > key ? order_key(v[i]) : key;
+
+        vect_max = key & 0x8000 ? key & 0x7fff : (uint16_t) ~key;
+
+        if (order_key(vect_max) > order_key(cur_max)) {
+            if (k != 0)
+                factors[n_factors++] = expu(bf16_sub(cur_max, vect_max));
+
+            cur_max = vect_max;
+        }
+
+        for (unsigned int i = 0; i < valid; i++) {
+            exps[k * SOFTEX_CORE_LANES + i] = expu(bf16_sub(v[i], cur_max));
+            e[i] = bf16_to_f32(exps[k * SOFTEX_CORE_LANES + i]);
+        }
+
+        // Strobed padding lanes all hold exp(0 - max)
+        for (unsigned int i = valid; i < SOFTEX_CORE_LANES; i++)
+            e[i] = i < strobed ? (i == valid ? bf16_to_f32(expu(bf16_sub(0, cur_max))) : e[valid]) : 0;
+
+        sums[k]     = tree_sum(e, SOFTEX_CORE_LANES);
+        tags[k]     = n_factors;
+        beat_max[k] = cur_max;
+    }
+
+    inv = f32_to_bf16(reciprocal(accumulate(sums, tags, n_beats, factors, n_factors)));
+
+    // The exponentials of the beats that already saw the final maximum are reused
+    for (unsigned int i = 0; i < len; i++) {
+        uint16_t e = beat_max[i / SOFTEX_CORE_LANES] == cur_max ? exps[i] : expu(bf16_sub(in[i], cur_max));
+
+        out[i] = bf16_mul(e, inv);
+    }
+
+    return 0;
+}
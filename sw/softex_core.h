@@ -0,0 +1,27 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#ifndef __SOFTEX_CORE__
+#define __SOFTEX_CORE__
+
+#include <stdint.h>
+
+#include "archi_softex.h"
+
+// Datapath parameters the kernel reproduces, they must match N_ROWS, NUM_REGS_FMA_ACC and N_NEWTON_ITERS of softex_pkg
+#define SOFTEX_CORE_LANES       (DATA_WIDTH / 16)
+#define SOFTEX_CORE_ACC_REGS    4
+#define SOFTEX_CORE_NEWTON      2
+
+// Longest row accepted by softex_core_softmax
+#define SOFTEX_CORE_MAX_LEN     256
+
+// Softmax of "len" BF16 elements computed on the core with the integer arithmetic of the SoftEx datapath, so that
+// the result matches the one of a stall-free SoftEx job bit by bit. Returns -1 if "len" is 0 or above SOFTEX_CORE_MAX_LEN
+int softex_core_softmax(const uint16_t *in, uint16_t *out, unsigned int len);
+
+#endif
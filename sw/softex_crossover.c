@@ -0,0 +1,101 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Times softex_core_softmax against a SoftEx job on the first "len" scores for growing lengths. The shortest row
+// on which the offload wins is printed, it is the value SOFTEX_RT_CROSSOVER should be set to. Run it stall free, so
+// that the two results can also be compared bit by bit: the exit code is the number of elements that differ. The
+// points are printed once all of them are taken, for scripts/bench_crossover.sh to collect.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tinyprintf.h"
+#include "softex_rt.h"
+#include "softex_core.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+#define MAX_POINTS  64
+
+typedef struct {
+    unsigned int len;
+    unsigned int core_cycles;
+    unsigned int softex_cycles;
+    unsigned int mismatches;
+} point_t;
+
+STIM_ARRAY(uint16_t, scores);
+
+static uint16_t core_out [SOFTEX_CORE_MAX_LEN];
+static uint16_t softex_out [SOFTEX_CORE_MAX_LEN];
+
+// Kept in memory for inspection after the run
+static volatile point_t points[MAX_POINTS];
+
+static inline unsigned int cycles() {
+    unsigned int c;
+
+    asm volatile("csrr %0, mcycle" : "=r" (c));
+
+    return c;
+}
+
+int main () {
+
+    unsigned int crossover  = 0,
+                 errors     = 0,
+                 n_points   = 0,
+                 start;
+
+    init_printf(NULL, (putcf) putf);
+
+    softex_rt_init(0);
+
+    for (unsigned int len = 1; len <= SOFTEX_CORE_MAX_LEN && len <= LENGTH && n_points < MAX_POINTS; len += len < SOFTEX_CORE_LANES ? 1 : SOFTEX_CORE_LANES) {
+        unsigned int core_cycles,
+                     softex_cycles,
+                     mismatches = 0;
+
+        start = cycles();
+        softex_core_softmax(scores, core_out, len);
+        core_cycles = cycles() - start;
+
+        start = cycles();
+        softex_wait(softex_softmax_async(scores, softex_out, len, SOFTEX_RT_NATIVE));
+        softex_cycles = cycles() - start;
+
+        for (unsigned int i = 0; i < len; i++)
+            mismatches += core_out[i] != softex_out[i];
+
+        points[n_points].len            = len;
+        points[n_points].core_cycles    = core_cycles;
+        points[n_points].softex_cycles  = softex_cycles;
+        points[n_points].mismatches     = mismatches;
+        n_points++;
+
+        errors += mismatches;
+
+        if (crossover == 0 && softex_cycles <= core_cycles)
+            crossover = len;
+    }
+
+    printf("CROSSOVER,len,core_cycles,softex_cycles,mismatches\n");
+
+    for (unsigned int i = 0; i < n_points; i++)
+        printf("CROSSOVER,%u,%u,%u,%u\n", points[i].len, points[i].core_cycles, points[i].softex_cycles, points[i].mismatches);
+
+    printf("CROSSOVER,result,%u\n", crossover);
+
+    // The whole row for the golden model check
+    softex_wait(softex_softmax_async(scores, (void *) OUT_ADDR, LENGTH, SOFTEX_RT_NATIVE));
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = errors;
+
+	return 0;
+}
@@ -0,0 +1,83 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#include <stdint.h>
+#include <stdatomic.h> 
+
+#include "tinyprintf.h"
+#include "hal_softex.h"
+#include "archi_softex.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+#define HALF_LEN    (LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH)
+
+STIM_ARRAY(uint16_t, scores);
+
+// Same sequence of jobs as softex_multi.c, executed with a single trigger
+static softex_desc_t ring [4 * N_VECTORS] __attribute__((aligned(SOFTEX_DESC_SIZE)));
+
+int main () {
+
+    int acq_res;
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        softex_desc_t *acc_first    = &ring [i];
+        softex_desc_t *acc_last     = &ring [N_VECTORS + i];
+        softex_desc_t *div_first    = &ring [2 * N_VECTORS + i];
+        softex_desc_t *div_last     = &ring [3 * N_VECTORS + i];
+
+        acc_first->in_addr  = ((int) scores) + i * LENGTH * FMT_WIDTH;
+        acc_first->out_addr = 0;
+        acc_first->tot_len  = HALF_LEN;
+        acc_first->commands = SOFTEX_CMD_ACC_ONLY | SOFTEX_CMD_ACQUIRE_SLOT | (i << 16);
+
+        acc_last->in_addr   = ((int) scores) + i * LENGTH * FMT_WIDTH + HALF_LEN;
+        acc_last->out_addr  = 0;
+        acc_last->tot_len   = LENGTH * FMT_WIDTH - HALF_LEN;
+        acc_last->commands  = SOFTEX_CMD_ACC_ONLY | SOFTEX_CMD_LAST | (i << 16);
+
+        div_first->in_addr  = ((int) scores) + i * LENGTH * FMT_WIDTH;
+        div_first->out_addr = OUT_ADDR + i * LENGTH * FMT_WIDTH;
+        div_first->tot_len  = HALF_LEN;
+        div_first->commands = SOFTEX_CMD_DIV_ONLY | (i << 16);
+
+        div_last->in_addr   = ((int) scores) + i * LENGTH * FMT_WIDTH + HALF_LEN;
+        div_last->out_addr  = OUT_ADDR + i * LENGTH * FMT_WIDTH + HALF_LEN;
+        div_last->tot_len   = LENGTH * FMT_WIDTH - HALF_LEN;
+        div_last->commands  = SOFTEX_CMD_DIV_ONLY | SOFTEX_CMD_LAST | (i << 16);
+
+        acc_first->cast_ctrl    = 0;
+        acc_last->cast_ctrl     = 0;
+        div_first->cast_ctrl    = 0;
+        div_last->cast_ctrl     = 0;
+
+        acc_first->rows         = 1;
+        acc_last->rows          = 1;
+        div_first->rows         = 1;
+        div_last->rows          = 1;
+    }
+
+    hwpe_soft_clear();
+
+    while ((acq_res = hwpe_acquire_job()) < 0) {
+
+    }
+
+    HWPE_WRITE(((int) scores) + LENGTH * FMT_WIDTH * N_VECTORS, SOFTEX_CACHE_BASE_ADDR);
+    hwpe_desc_ring(ring, 4 * N_VECTORS, SOFTEX_CMD_SET_CACHE_ADDR);
+
+    hwpe_trigger_job();
+
+    asm volatile("wfi" ::: "memory");
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
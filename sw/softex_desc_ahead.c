@@ -0,0 +1,52 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#include <stdint.h>
+#include <stdatomic.h> 
+
+#include "tinyprintf.h"
+#include "hal_softex.h"
+#include "archi_softex.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+STIM_ARRAY(uint16_t, scores);
+
+// One complete row per descriptor: every descriptor but the first has its input launched during the previous one
+static softex_desc_t ring [N_VECTORS] __attribute__((aligned(SOFTEX_DESC_SIZE)));
+
+int main () {
+
+    int acq_res;
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        ring [i].in_addr    = ((int) scores) + i * LENGTH * FMT_WIDTH;
+        ring [i].out_addr   = OUT_ADDR + i * LENGTH * FMT_WIDTH;
+        ring [i].tot_len    = LENGTH * FMT_WIDTH;
+        ring [i].commands   = 0;
+        ring [i].cast_ctrl  = 0;
+        ring [i].rows       = 1;
+    }
+
+    hwpe_soft_clear();
+
+    while ((acq_res = hwpe_acquire_job()) < 0) {
+
+    }
+
+    hwpe_desc_ring(ring, N_VECTORS, 0);
+
+    hwpe_trigger_job();
+
+    asm volatile("wfi" ::: "memory");
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
@@ -14,7 +14,7 @@
 #include "golden-model/scores.h"
 #include "golden-model/golden.h"
 
-static uint8_t scores[LENGTH] = SCORES;
+STIM_ARRAY(uint8_t, scores);
 
 int main () {
 
@@ -28,7 +28,7 @@ int main () {
 
     HWPE_WRITE(scores, SOFTEX_IN_ADDR);
     HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_TOT_LEN);
-    HWPE_WRITE(0x1c010000, SOFTEX_OUT_ADDR);
+    HWPE_WRITE(OUT_ADDR, SOFTEX_OUT_ADDR);
     HWPE_WRITE(SOFTEX_CMD_INT_INPUT | SOFTEX_CMD_INT_OUTPUT, SOFTEX_COMMANDS);
     HWPE_WRITE(INPUT_INT_BITS | (INPUT_SIGNED << 7) | (((OUTPUT_INT_BITS) & 0b01111111) << 8) | (OUTPUT_SIGNED << 15), SOFTEX_CAST_CTRL);
 
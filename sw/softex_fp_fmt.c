@@ -0,0 +1,55 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#include <stdint.h>
+#include <stdatomic.h> 
+
+#include "tinyprintf.h"
+#include "hal_softex.h"
+#include "archi_softex.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+// Width in bytes of an output element
+#define OUT_WIDTH   (OUT_FMT == SOFTEX_FMT_FP8_E4M3 || OUT_FMT == SOFTEX_FMT_FP8_E5M2 ? 1 : 2)
+
+#if FMT_WIDTH == 1
+STIM_ARRAY(uint8_t, scores);
+#else
+STIM_ARRAY(uint16_t, scores);
+#endif
+
+int main () {
+
+    int acq_res;
+
+    hwpe_soft_clear();
+
+    while ((acq_res = hwpe_acquire_job()) < 0) {
+
+    }
+
+    // Each row is converted from IN_FMT on the fly and written back in OUT_FMT
+    HWPE_WRITE(scores, SOFTEX_IN_ADDR);
+    HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_TOT_LEN);
+    HWPE_WRITE(OUT_ADDR, SOFTEX_OUT_ADDR);
+    HWPE_WRITE(N_VECTORS, SOFTEX_ROWS);
+    HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_IN_ROW_STRIDE);
+    HWPE_WRITE(LENGTH * OUT_WIDTH, SOFTEX_OUT_ROW_STRIDE);
+    HWPE_WRITE(SOFTEX_CAST_IN_FMT(IN_FMT) | SOFTEX_CAST_OUT_FMT(OUT_FMT), SOFTEX_CAST_CTRL);
+    HWPE_WRITE(0, SOFTEX_COMMANDS);
+
+    hwpe_trigger_job();
+
+    asm volatile("wfi" ::: "memory");
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Log-softmax of every vector against a golden model generated with out_mode=LOG or LSE. Odd vectors are split in
+// partial jobs, so the logarithm is also taken from a state slot. The log-sum-exp of each vector is then computed on
+// its own. With out_mode=LSE (golden-cpp) the maximum and the LSE of a complete job must match LSE_GOLDEN exactly,
+// and those of a split one must match the maximum and be within LSE_SPLIT_ULP of the LSE, as its sum is rounded in
+// another order. Otherwise the maximum must be the one of the row and, since the denominator is at least one, the LSE
+// is not below it. The exit code is the number of vectors failing the check.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tinyprintf.h"
+#include "softex_rt.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+#ifndef OUT_MODE
+#error "Generate the golden model with out_mode=LOG or LSE"
+#endif
+
+#ifndef LSE_SPLIT_ULP
+#define LSE_SPLIT_ULP   8
+#endif
+
+STIM_ARRAY(uint16_t, scores);
+
+static softex_stats_t lse [N_VECTORS];
+
+#ifdef LSE_GOLDEN
+static const softex_stats_t lse_golden [N_VECTORS] = LSE_GOLDEN;
+#endif
+
+int main () {
+
+    int errors = 0;
+
+    init_printf(NULL, (putcf) putf);
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        softex_wait_all();
+        softex_rt_init(i % 2 ? (LENGTH + 1) / 2 : 0);
+
+        softex_log_softmax_async(scores + i * LENGTH, (void *) (OUT_ADDR + i * LENGTH * FMT_WIDTH), LENGTH, SOFTEX_RT_NATIVE);
+    }
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        softex_wait_all();
+        softex_rt_init(i % 2 ? (LENGTH + 1) / 2 : 0);
+
+        softex_lse_async(scores + i * LENGTH, &lse[i], LENGTH, SOFTEX_RT_NATIVE);
+    }
+
+    softex_wait_all();
+
+#ifdef LSE_GOLDEN
+    // The LSE of positive scores is positive, so its fp32 encodings compare as integers
+    for (int i = 0; i < N_VECTORS; i++) {
+        unsigned int diff = lse[i].denominator > lse_golden[i].denominator ? lse[i].denominator - lse_golden[i].denominator : lse_golden[i].denominator - lse[i].denominator;
+
+        if (lse[i].max != lse_golden[i].max || diff > (i % 2 ? LSE_SPLIT_ULP : 0)) {
+            printf("Vector %d: max 0x%04x LSE 0x%08x, expected max 0x%04x LSE 0x%08x\n", i, lse[i].max, lse[i].denominator, lse_golden[i].max, lse_golden[i].denominator);
+            errors++;
+        }
+    }
+#else
+    // The scores are positive, so their bf16 and fp32 encodings compare as integers
+    for (int i = 0; i < N_VECTORS; i++) {
+        uint16_t max = 0;
+
+        for (int j = 0; j < LENGTH; j++)
+            max = scores[i * LENGTH + j] > max ? scores[i * LENGTH + j] : max;
+
+        if ((lse[i].max & 0xffff) != max || lse[i].denominator < ((unsigned int) max << 16)) {
+            printf("Vector %d: max 0x%04x LSE 0x%08x, the row maximum is 0x%04x\n", i, lse[i].max & 0xffff, lse[i].denominator, max);
+            errors++;
+        }
+    }
+#endif
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = errors;
+
+	return 0;
+}
@@ -0,0 +1,35 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// softex_multi.c through the runtime. Every vector is split in two partial jobs as there, the runtime only rounds the
+// first one up to a beat boundary, and all of them are queued before waiting. The run cycles printed by the tb of the
+// two programs give the cost of the runtime's programming of the jobs.
+
+#include <stdint.h>
+
+#include "tinyprintf.h"
+#include "softex_rt.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+STIM_ARRAY(uint16_t, scores);
+
+int main () {
+
+    softex_rt_init((LENGTH + 1) / 2);
+
+    for (int i = 0; i < N_VECTORS; i++)
+        softex_softmax_async(scores + i * LENGTH, (void *) (OUT_ADDR + i * LENGTH * FMT_WIDTH), LENGTH, SOFTEX_RT_NATIVE);
+
+    softex_wait_all();
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
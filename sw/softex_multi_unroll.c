@@ -15,7 +15,7 @@
 #include "golden-model/scores.h"
 #include "golden-model/golden.h"
 
-static uint16_t scores[LENGTH * N_VECTORS] = SCORES;
+STIM_ARRAY(uint16_t, scores);
 
 int main () {
 
@@ -93,7 +93,7 @@ int main () {
 
         HWPE_WRITE(((int) scores) + i * LENGTH * FMT_WIDTH, SOFTEX_IN_ADDR);
         HWPE_WRITE(LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_TOT_LEN);
-        HWPE_WRITE(0x1c010000 + i * LENGTH * FMT_WIDTH, SOFTEX_OUT_ADDR);
+        HWPE_WRITE(OUT_ADDR + i * LENGTH * FMT_WIDTH, SOFTEX_OUT_ADDR);
         HWPE_WRITE(SOFTEX_CMD_DIV_ONLY | (i << 16), SOFTEX_COMMANDS);
 
         hwpe_trigger_job();
@@ -104,7 +104,7 @@ int main () {
 
         HWPE_WRITE(((int) scores) + (i + 1) * LENGTH * FMT_WIDTH, SOFTEX_IN_ADDR);
         HWPE_WRITE(LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_TOT_LEN);
-        HWPE_WRITE(0x1c010000 + (i + 1) * LENGTH * FMT_WIDTH, SOFTEX_OUT_ADDR);
+        HWPE_WRITE(OUT_ADDR + (i + 1) * LENGTH * FMT_WIDTH, SOFTEX_OUT_ADDR);
         HWPE_WRITE(SOFTEX_CMD_DIV_ONLY | ((i + 1) << 16), SOFTEX_COMMANDS);
 
         hwpe_trigger_job();
@@ -120,7 +120,7 @@ int main () {
 
         HWPE_WRITE(((int) scores) + i * LENGTH * FMT_WIDTH + LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_IN_ADDR);
         HWPE_WRITE(LENGTH * FMT_WIDTH - LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_TOT_LEN);
-        HWPE_WRITE(0x1c010000 + i * LENGTH * FMT_WIDTH + LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_OUT_ADDR);
+        HWPE_WRITE(OUT_ADDR + i * LENGTH * FMT_WIDTH + LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_OUT_ADDR);
         HWPE_WRITE(SOFTEX_CMD_DIV_ONLY | SOFTEX_CMD_LAST | (i << 16), SOFTEX_COMMANDS);
 
         hwpe_trigger_job();
@@ -131,7 +131,7 @@ int main () {
 
         HWPE_WRITE(((int) scores) + (i + 1) * LENGTH * FMT_WIDTH + LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_IN_ADDR);
         HWPE_WRITE(LENGTH * FMT_WIDTH - LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_TOT_LEN);
-        HWPE_WRITE(0x1c010000 + (i + 1) * LENGTH * FMT_WIDTH + LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_OUT_ADDR);
+        HWPE_WRITE(OUT_ADDR + (i + 1) * LENGTH * FMT_WIDTH + LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH, SOFTEX_OUT_ADDR);
         HWPE_WRITE(SOFTEX_CMD_DIV_ONLY | SOFTEX_CMD_LAST | ((i + 1) << 16), SOFTEX_COMMANDS);
 
         hwpe_trigger_job();
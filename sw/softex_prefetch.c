@@ -0,0 +1,136 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tinyprintf.h"
+#include "hal_softex.h"
+#include "archi_softex.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+// Split softmax interleaved over more rows than on-chip slots: every job prefetches the slot of the next row
+STIM_ARRAY(uint16_t, scores);
+
+#define HALF_LEN    (LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH)
+
+int main () {
+
+    int acq_res;
+
+    unsigned int hits,
+                 misses,
+                 errors = 0;
+
+    init_printf(NULL, (putcf) putf);
+
+    hwpe_soft_clear();
+
+    while ((acq_res = hwpe_acquire_job()) < 0) {
+
+    }
+
+    HWPE_WRITE(((int) scores) + LENGTH * FMT_WIDTH * N_VECTORS, SOFTEX_CACHE_BASE_ADDR);
+    HWPE_WRITE(SOFTEX_CMD_SET_CACHE_ADDR | SOFTEX_CMD_NO_OP, SOFTEX_COMMANDS);
+    
+    hwpe_trigger_job();
+
+    /**********ACCUMULATION**********/
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        while ((acq_res = hwpe_acquire_job()) < 0) {
+
+        }
+
+        HWPE_WRITE(((int) scores) + i * LENGTH * FMT_WIDTH, SOFTEX_IN_ADDR);
+        HWPE_WRITE(HALF_LEN, SOFTEX_TOT_LEN);
+        HWPE_WRITE(SOFTEX_CMD_ACC_ONLY | SOFTEX_CMD_ACQUIRE_SLOT | (i << 16), SOFTEX_COMMANDS);
+
+        hwpe_trigger_job();
+
+        asm volatile("wfi" ::: "memory");
+    }
+
+    hits    = hwpe_perf_read(SOFTEX_PERF_SLOT_HITS);
+    misses  = hwpe_perf_read(SOFTEX_PERF_SLOT_MISSES);
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        while ((acq_res = hwpe_acquire_job()) < 0) {
+
+        }
+
+        HWPE_WRITE(((int) scores) + i * LENGTH * FMT_WIDTH + HALF_LEN, SOFTEX_IN_ADDR);
+        HWPE_WRITE(LENGTH * FMT_WIDTH - HALF_LEN, SOFTEX_TOT_LEN);
+        HWPE_WRITE(SOFTEX_CMD_ACC_ONLY | SOFTEX_CMD_LAST | (i << 16), SOFTEX_COMMANDS);
+
+        if (i + 1 < N_VECTORS)
+            hwpe_prefetch_slot(i + 1);
+    
+        hwpe_trigger_job();
+
+        asm volatile("wfi" ::: "memory");
+    }
+
+    /**********NORMALISATION**********/
+
+    hwpe_prefetch_slot(0);
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        while ((acq_res = hwpe_acquire_job()) < 0) {
+
+        }
+
+        HWPE_WRITE(((int) scores) + i * LENGTH * FMT_WIDTH, SOFTEX_IN_ADDR);
+        HWPE_WRITE(HALF_LEN, SOFTEX_TOT_LEN);
+        HWPE_WRITE(OUT_ADDR + i * LENGTH * FMT_WIDTH, SOFTEX_OUT_ADDR);
+        HWPE_WRITE(SOFTEX_CMD_DIV_ONLY | (i << 16), SOFTEX_COMMANDS);
+
+        if (i + 1 < N_VECTORS)
+            hwpe_prefetch_slot(i + 1);
+
+        hwpe_trigger_job();
+
+        asm volatile("wfi" ::: "memory");
+    }
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        while ((acq_res = hwpe_acquire_job()) < 0) {
+
+        }
+
+        HWPE_WRITE(((int) scores) + i * LENGTH * FMT_WIDTH + HALF_LEN, SOFTEX_IN_ADDR);
+        HWPE_WRITE(LENGTH * FMT_WIDTH - HALF_LEN, SOFTEX_TOT_LEN);
+        HWPE_WRITE(OUT_ADDR + i * LENGTH * FMT_WIDTH + HALF_LEN, SOFTEX_OUT_ADDR);
+        HWPE_WRITE(SOFTEX_CMD_DIV_ONLY | SOFTEX_CMD_LAST | (i << 16), SOFTEX_COMMANDS);
+
+        if (i + 1 < N_VECTORS)
+            hwpe_prefetch_slot(i + 1);
+
+        hwpe_trigger_job();
+
+        asm volatile("wfi" ::: "memory");
+    }
+
+    // Every row after the first of each pass was prefetched by the previous job, so its slot must already be on
+    // chip. Only the first row of the last two passes may miss, along with the prefetches themselves
+    hits    = hwpe_perf_read(SOFTEX_PERF_SLOT_HITS) - hits;
+    misses  = hwpe_perf_read(SOFTEX_PERF_SLOT_MISSES) - misses;
+
+    printf("Slot hits: %u, misses: %u\n", hits, misses);
+
+    if (hits < 3 * N_VECTORS - 2) {
+        printf("%u prefetched rows missed\n", 3 * N_VECTORS - 2 - hits);
+        errors++;
+    }
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = errors;
+
+	return 0;
+}
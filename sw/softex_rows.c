@@ -0,0 +1,51 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#include <stdint.h>
+#include <stdatomic.h> 
+
+#include "tinyprintf.h"
+#include "hal_softex.h"
+#include "archi_softex.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+STIM_ARRAY(uint16_t, scores);
+
+int main () {
+
+    int acq_res;
+
+    hwpe_soft_clear();
+
+    while ((acq_res = hwpe_acquire_job()) < 0) {
+
+    }
+
+    // The whole [N_VECTORS x LENGTH] tile is normalised row by row with a single job
+    HWPE_WRITE(scores, SOFTEX_IN_ADDR);
+    HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_TOT_LEN);
+    HWPE_WRITE(OUT_ADDR, SOFTEX_OUT_ADDR);
+    HWPE_WRITE(N_VECTORS, SOFTEX_ROWS);
+    HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_IN_ROW_STRIDE);
+    HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_OUT_ROW_STRIDE);
+
+#if DUAL_ROW
+    // Each row is accumulated while the previous one is normalised
+    HWPE_WRITE(SOFTEX_CMD_DUAL_ROW, SOFTEX_COMMANDS);
+#endif
+
+    hwpe_trigger_job();
+
+    asm volatile("wfi" ::: "memory");
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
@@ -0,0 +1,257 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#include "softex_rt.h"
+#include "softex_core.h"
+
+#define BEAT_BYTES  (DATA_WIDTH / 8)
+
+// Registers of a context, from SOFTEX_IN_ADDR to SOFTEX_THRESHOLD
+#define CTX_REGS    ((SOFTEX_THRESHOLD - SOFTEX_REG_OFFS) / 4 + 1)
+
+static softex_stats_t cache[SOFTEX_RT_SLOTS];
+
+// Every job of the runtime writes its completion record here, see softex_wait
+static softex_cpl_t cpl[SOFTEX_RT_CPL_COUNT];
+
+static unsigned int max_len;
+static unsigned int accuracy;
+static unsigned int crossover;
+
+static softex_handle_t submitted;
+static softex_handle_t completed;
+
+// Jobs triggered since softex_rt_init, whose NO_OP job is job 0, and jobs known to be complete
+static unsigned int triggered;
+static unsigned int done;
+
+// Job id of the last job of each of the last SOFTEX_RT_SLOTS handles
+static unsigned int last_job[SOFTEX_RT_SLOTS];
+
+// Values left in the registers of each context, they persist from one job to the next one in the same context
+static unsigned int ctx_regs[SOFTEX_RT_CONTEXTS][CTX_REGS];
+
+static unsigned int fmt_width(unsigned int fmt) {
+    return fmt == SOFTEX_FMT_FP8_E4M3 || fmt == SOFTEX_FMT_FP8_E5M2 ? 1 : 2;
+}
+
+// Writes a register of the context "regs" only if it does not hold "value" already
+static void ctx_write(unsigned int *regs, unsigned int value, unsigned int reg) {
+    unsigned int *r = &regs[(reg - SOFTEX_REG_OFFS) / 4];
+
+    if (*r != value) {
+        HWPE_WRITE(value, reg);
+        *r = value;
+    }
+}
+
+// Only the last job of a softmax raises an event. The registers no job of the runtime changes were set by
+// softex_rt_init, the others are written only when they differ from the previous job in the same context. COMMANDS is
+// always written, it is what requests the state slot. Returns the job id
+static unsigned int push_job(unsigned int in, unsigned int out, unsigned int tot_len, unsigned int cast_ctrl, unsigned int commands, unsigned int mode, unsigned int aux, int last) {
+    unsigned int *regs = ctx_regs[triggered % SOFTEX_RT_CONTEXTS];
+
+    while (hwpe_acquire_job() < 0) {
+
+    }
+
+    ctx_write(regs, in, SOFTEX_IN_ADDR);
+    ctx_write(regs, out, SOFTEX_OUT_ADDR);
+    ctx_write(regs, tot_len, SOFTEX_TOT_LEN);
+    ctx_write(regs, cast_ctrl, SOFTEX_CAST_CTRL);
+    ctx_write(regs, last ? 0 : SOFTEX_EVT_SKIP, SOFTEX_EVT_CTRL);
+    ctx_write(regs, accuracy, SOFTEX_ACCURACY_CTRL);
+    ctx_write(regs, mode, SOFTEX_OUT_CTRL);
+
+    // "aux" is where SOFTEX_OUT_LSE writes the result, where the top-k lists go or the threshold of a sparse output
+    ctx_write(regs, mode == SOFTEX_OUT_LSE ? aux : 0, SOFTEX_STATS_ADDR);
+    ctx_write(regs, mode & SOFTEX_OUT_TOPK(0xf) ? aux : 0, SOFTEX_TOPK_ADDR);
+    ctx_write(regs, mode & SOFTEX_OUT_SPARSE ? aux : 0, SOFTEX_THRESHOLD);
+
+    HWPE_WRITE(commands, SOFTEX_COMMANDS);
+    regs[(SOFTEX_COMMANDS - SOFTEX_REG_OFFS) / 4] = commands;
+
+    hwpe_trigger_job();
+
+    return triggered++;
+}
+
+// Handles complete in order, so the one submitted SOFTEX_RT_SLOTS earlier is waited for before its slot id and its
+// entry of "last_job" are reused
+static softex_handle_t new_handle(void) {
+    if (submitted >= SOFTEX_RT_SLOTS)
+        softex_wait(submitted - SOFTEX_RT_SLOTS);
+
+    return submitted++;
+}
+
+void softex_rt_init(unsigned int max_job_len) {
+    max_len     = max_job_len;
+    accuracy    = 0;
+    crossover   = SOFTEX_RT_CROSSOVER;
+    submitted   = 0;
+    completed   = 0;
+    triggered   = SOFTEX_RT_CONTEXTS;
+    done        = 0;
+
+    // The soft clear restarts the job ids, so older records must not be mistaken for new ones
+    for (int i = 0; i < SOFTEX_RT_CPL_COUNT; i++)
+        ((volatile softex_cpl_t *) cpl)[i].status = 0;
+
+    hwpe_soft_clear();
+
+    // One NO_OP job per context leaves every register in the state the runtime expects. The first one also points
+    // the slot cache to the runtime's own
+    for (int c = 0; c < SOFTEX_RT_CONTEXTS; c++) {
+        unsigned int *regs = ctx_regs[c];
+
+        for (int r = 0; r < CTX_REGS; r++)
+            regs[r] = 0;
+
+        while (hwpe_acquire_job() < 0) {
+
+        }
+
+        for (int r = 0; r < CTX_REGS; r++) {
+            if (SOFTEX_REG_OFFS + r * 4 != SOFTEX_PREFETCH_SLOT)
+                HWPE_WRITE(0, SOFTEX_REG_OFFS + r * 4);
+        }
+
+        ctx_write(regs, 1, SOFTEX_ROWS);
+        ctx_write(regs, (int) cpl, SOFTEX_CPL_ADDR);
+        ctx_write(regs, SOFTEX_RT_CPL_COUNT, SOFTEX_CPL_COUNT);
+        ctx_write(regs, SOFTEX_EVT_SKIP, SOFTEX_EVT_CTRL);
+        ctx_write(regs, c == 0 ? (int) cache : 0, SOFTEX_CACHE_BASE_ADDR);
+        ctx_write(regs, (c == 0 ? SOFTEX_CMD_SET_CACHE_ADDR : 0) | SOFTEX_CMD_NO_OP, SOFTEX_COMMANDS);
+
+        hwpe_trigger_job();
+    }
+}
+
+void softex_rt_accuracy(unsigned int acc) {
+    accuracy = acc;
+}
+
+void softex_rt_crossover(unsigned int len) {
+    crossover = len;
+}
+
+// Every mode shares the split in partial jobs, only SOFTEX_OUT_LSE has no DIV_ONLY jobs
+static softex_handle_t submit(const void *in, void *out, unsigned int len, unsigned int fmt, unsigned int mode) {
+    unsigned int in_width   = fmt_width((fmt >> 16) & 0x3);
+    unsigned int out_width  = fmt_width((fmt >> 18) & 0x3);
+
+    unsigned int chunk,
+                 slot_id,
+                 job = 0;
+
+    softex_handle_t handle = new_handle();
+
+    if (max_len == 0 || len <= max_len) {
+        last_job[handle % SOFTEX_RT_SLOTS] = push_job((unsigned int) in, (unsigned int) out, len * in_width, fmt, 0, mode, (unsigned int) out, 1);
+
+        return handle;
+    }
+
+    // Every chunk but the last one starts on a beat boundary
+    chunk = max_len * in_width / BEAT_BYTES * BEAT_BYTES / in_width;
+
+    if (chunk == 0)
+        chunk = BEAT_BYTES / in_width;
+
+    // Slots are assigned round robin, the one of the handle submitted SOFTEX_RT_SLOTS earlier is already released
+    slot_id = handle % SOFTEX_RT_SLOTS;
+
+    for (unsigned int i = 0; i < len; i += chunk) {
+        unsigned int n = len - i < chunk ? len - i : chunk;
+
+        job = push_job((unsigned int) in + i * in_width, 0, n * in_width, fmt,
+                       SOFTEX_CMD_ACC_ONLY | (i == 0 ? SOFTEX_CMD_ACQUIRE_SLOT : 0) | (i + n == len ? SOFTEX_CMD_LAST : 0) | (slot_id << 16), mode,
+                       (unsigned int) out, mode == SOFTEX_OUT_LSE && i + n == len);
+    }
+
+    if (mode != SOFTEX_OUT_LSE) {
+        for (unsigned int i = 0; i < len; i += chunk) {
+            unsigned int n = len - i < chunk ? len - i : chunk;
+
+            job = push_job((unsigned int) in + i * in_width, (unsigned int) out + i * out_width, n * in_width, fmt,
+                           SOFTEX_CMD_DIV_ONLY | (i + n == len ? SOFTEX_CMD_LAST : 0) | (slot_id << 16), mode, 0, i + n == len);
+        }
+    }
+
+    last_job[handle % SOFTEX_RT_SLOTS] = job;
+
+    return handle;
+}
+
+softex_handle_t softex_softmax_async(const void *in, void *out, unsigned int len, unsigned int fmt) {
+    return submit(in, out, len, fmt, SOFTEX_OUT_SOFTMAX);
+}
+
+softex_handle_t softex_log_softmax_async(const void *in, void *out, unsigned int len, unsigned int fmt) {
+    return submit(in, out, len, fmt, SOFTEX_OUT_LOG);
+}
+
+softex_handle_t softex_lse_async(const void *in, softex_stats_t *lse, unsigned int len, unsigned int fmt) {
+    return submit(in, lse, len, fmt, SOFTEX_OUT_LSE);
+}
+
+// The indexes are the ones of the row only in a complete job, so the row is never split
+softex_handle_t softex_softmax_topk_async(const void *in, void *out, unsigned int len, unsigned int fmt, unsigned int k, softex_topk_t *topk) {
+    softex_handle_t handle = new_handle();
+
+    last_job[handle % SOFTEX_RT_SLOTS] = push_job((unsigned int) in, (unsigned int) out, len * fmt_width((fmt >> 16) & 0x3), fmt, 0, SOFTEX_OUT_TOPK(k), (unsigned int) topk, 1);
+
+    return handle;
+}
+
+// Same as the top-k, the entries carry the indexes of the row
+softex_handle_t softex_softmax_sparse_async(const void *in, softex_sparse_t *out, unsigned int len, unsigned int fmt, unsigned int threshold) {
+    softex_handle_t handle = new_handle();
+
+    last_job[handle % SOFTEX_RT_SLOTS] = push_job((unsigned int) in, (unsigned int) out, len * fmt_width((fmt >> 16) & 0x3), fmt, 0, SOFTEX_OUT_SPARSE, threshold, 1);
+
+    return handle;
+}
+
+// There is no reduction, so there is nothing to split the row for
+softex_handle_t softex_act_async(const void *in, void *out, unsigned int len, unsigned int fmt, unsigned int act) {
+    softex_handle_t handle = new_handle();
+
+    last_job[handle % SOFTEX_RT_SLOTS] = push_job((unsigned int) in, (unsigned int) out, len * fmt_width((fmt >> 16) & 0x3), fmt, 0, SOFTEX_OUT_ACT(act), 0, 1);
+
+    return handle;
+}
+
+softex_handle_t softex_softmax(const void *in, void *out, unsigned int len, unsigned int fmt) {
+    if (fmt == SOFTEX_RT_NATIVE && accuracy == 0 && len < crossover && softex_core_softmax(in, out, len) == 0)
+        return SOFTEX_RT_DONE;
+
+    return softex_softmax_async(in, out, len, fmt);
+}
+
+// The events are pulses that are lost if the core is not sleeping, so the completions are taken from the records
+// instead. Jobs complete in order: the newest record tells how many of them are done
+void softex_wait(softex_handle_t handle) {
+    while (completed <= handle) {
+        if (last_job[completed % SOFTEX_RT_SLOTS] < done) {
+            completed++;
+            continue;
+        }
+
+        for (int i = 0; i < SOFTEX_RT_CPL_COUNT; i++) {
+            volatile softex_cpl_t *rec = (volatile softex_cpl_t *) &cpl[i];
+
+            if ((rec->status & SOFTEX_CPL_DONE) && rec->job_id >= done)
+                done = rec->job_id + 1;
+        }
+    }
+}
+
+void softex_wait_all(void) {
+    softex_wait(submitted - 1);
+}
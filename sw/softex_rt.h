@@ -0,0 +1,87 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#ifndef __SOFTEX_RT__
+#define __SOFTEX_RT__
+
+#include "hal_softex.h"
+#include "archi_softex.h"
+
+// State slots handed out by the runtime, each one owns SOFTEX_STATS_SIZE bytes of the slot cache. It is also the
+// number of handles that can be pending at a time
+#define SOFTEX_RT_SLOTS     32
+
+// Contexts of the control slave, N_CTRL_CNTX in softex_pkg.sv. Jobs are programmed into them round robin
+#define SOFTEX_RT_CONTEXTS  4
+
+// Entries of the completion ring the runtime polls. Any size works, the ring only tells the newest completed job
+#define SOFTEX_RT_CPL_COUNT 8
+
+// Input and output formats of a softmax, see SOFTEX_CAST_CTRL
+#define SOFTEX_RT_FMT(in_fmt, out_fmt)  (SOFTEX_CAST_IN_FMT(in_fmt) | SOFTEX_CAST_OUT_FMT(out_fmt))
+#define SOFTEX_RT_NATIVE                SOFTEX_RT_FMT(SOFTEX_FMT_NATIVE, SOFTEX_FMT_NATIVE)
+
+// Rows shorter than this run on the core with softex_core_softmax. The default is an estimate from instruction counts,
+// not a measurement. On a host build softex_core_softmax executes about 2100 instructions for a one-element row and
+// about 750 more per element. Submitting a job and polling its record takes about 270, while the datapath needs
+// roughly 100 cycles for a short row. Without an FPU the core is then estimated to lose at every length, so the
+// default offloads every row. scripts/bench_crossover.sh measures the real value, which can be set per build with
+// FLAGS=-DSOFTEX_RT_CROSSOVER=<n>
+#ifndef SOFTEX_RT_CROSSOVER
+#define SOFTEX_RT_CROSSOVER     1
+#endif
+
+// Sequence number of a submitted softmax, handles complete in submission order
+typedef int softex_handle_t;
+
+// Handle of a softmax that was computed on the core and is already complete
+#define SOFTEX_RT_DONE          -1
+
+// Soft clears SoftEx and points the slot cache to the runtime's own. Vectors longer than "max_job_len" elements
+// are split into partial ACC_ONLY and DIV_ONLY jobs of at most that length, 0 never splits them. The runtime tracks
+// the jobs by their ids and the registers left in each context, so until the next call every job has to be submitted
+// through it
+void softex_rt_init(unsigned int max_job_len);
+
+// ACCURACY_CTRL of the softmaxes submitted from now on, 0 until set. Only the most accurate setting runs on the core
+void softex_rt_accuracy(unsigned int accuracy);
+
+// Rows shorter than "len" are run on the core by softex_softmax from now on, SOFTEX_RT_CROSSOVER until set. It lets a
+// crossover measured on the target be applied without rebuilding
+void softex_rt_crossover(unsigned int len);
+
+// Queues the softmax of the "len" elements at "in" into "out". Only blocks while every hardware context is taken or
+// SOFTEX_RT_SLOTS handles are pending
+softex_handle_t softex_softmax_async(const void *in, void *out, unsigned int len, unsigned int fmt);
+
+// Queues the log-softmax, x - max - ln(sum(exp(x - max))), of the "len" elements at "in" into "out"
+softex_handle_t softex_log_softmax_async(const void *in, void *out, unsigned int len, unsigned int fmt);
+
+// Queues the log-sum-exp of the "len" elements at "in", written as the denominator of "lse" next to the maximum
+softex_handle_t softex_lse_async(const void *in, softex_stats_t *lse, unsigned int len, unsigned int fmt);
+
+// Queues the softmax of the "len" elements at "in" into "out" and its "k" largest outputs, k <= SOFTEX_TOPK_MAX, into
+// "topk". The row is never split, whatever the length given to softex_rt_init
+softex_handle_t softex_softmax_topk_async(const void *in, void *out, unsigned int len, unsigned int fmt, unsigned int k, softex_topk_t *topk);
+
+// Queues the softmax of the "len" elements at "in", of which only the outputs above "threshold" (bf16) are written to
+// "out" with their indexes, see SOFTEX_OUT_SPARSE. "out" must hold up to "len" entries. The row is never split
+softex_handle_t softex_softmax_sparse_async(const void *in, softex_sparse_t *out, unsigned int len, unsigned int fmt, unsigned int threshold);
+
+// Queues the elementwise activation "act" (SOFTEX_ACT_*) of the "len" elements at "in" into "out". The row is never split
+softex_handle_t softex_act_async(const void *in, void *out, unsigned int len, unsigned int fmt, unsigned int act);
+
+// Runs short native rows on the core and queues the others. The two give the same result bit by bit
+softex_handle_t softex_softmax(const void *in, void *out, unsigned int len, unsigned int fmt);
+
+// Polls the completion records until the softmax "handle", and every one submitted before it, has been written back
+void softex_wait(softex_handle_t handle);
+
+// Polls the completion records until every submitted softmax has been written back
+void softex_wait_all(void);
+
+#endif
@@ -0,0 +1,88 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Randomised soak run for the streaming scoreboard (make ... scoreboard=1). The core generates the scores of
+// SOAK_JOBS rows of random length, alignment and output format, and submits them through the runtime with a random
+// split length. Nothing is checked here: every result is compared by the scoreboard as soon as SoftEx writes it.
+
+#include <stdint.h>
+
+#include "tinyprintf.h"
+#include "softex_rt.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+#ifndef SOAK_JOBS
+#define SOAK_JOBS       64
+#endif
+
+#ifndef SOAK_SEED
+#define SOAK_SEED       0x5eed
+#endif
+
+#define SOAK_MAX_LEN    2048
+#define SOAK_MAX_OFFS   8
+
+STIM_ARRAY(uint16_t, scores);
+
+// Two buffers, so that the next row is generated while SoftEx works on the previous one
+static uint16_t in_buf [2][SOAK_MAX_LEN + SOAK_MAX_OFFS];
+static uint16_t out_buf [2][SOAK_MAX_LEN + SOAK_MAX_OFFS];
+
+static unsigned int state = SOAK_SEED;
+
+static unsigned int xorshift() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    return state;
+}
+
+// Finite bf16 values of either sign between 2^-15 and 2^8
+static uint16_t random_bf16() {
+    unsigned int r = xorshift();
+
+    return (r & 0x8000) | ((0x70 + (r >> 16) % 0x17) << 7) | (r & 0x7f);
+}
+
+int main () {
+
+    softex_handle_t handle [2] = {SOFTEX_RT_DONE, SOFTEX_RT_DONE};
+
+    for (int job = 0; job < SOAK_JOBS; job++) {
+        unsigned int b      = job & 1,
+                     len    = 1 + xorshift() % SOAK_MAX_LEN,
+                     offs   = xorshift() % SOAK_MAX_OFFS,
+                     fmt    = SOFTEX_RT_FMT(SOFTEX_FMT_NATIVE, xorshift() % 4);
+
+        // A new split length every few rows, drained first since the runtime starts over
+        if (job % 8 == 0) {
+            softex_wait_all();
+            softex_rt_init(xorshift() % 2 ? 0 : 16 + xorshift() % SOAK_MAX_LEN);
+            handle[0] = handle[1] = SOFTEX_RT_DONE;
+        }
+
+        softex_wait(handle[b]);
+
+        for (unsigned int i = 0; i < len; i++)
+            in_buf[b][offs + i] = random_bf16();
+
+        handle[b] = softex_softmax_async(&in_buf[b][offs], &out_buf[b][offs], len, fmt);
+    }
+
+    softex_wait_all();
+
+    // The whole row for the golden model check
+    softex_wait(softex_softmax_async(scores, (void *) OUT_ADDR, LENGTH, SOFTEX_RT_NATIVE));
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
@@ -0,0 +1,80 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Softmax of every vector, checked against the golden model, followed by a sparse softmax of the same vector with a
+// threshold of about 1 / LENGTH, the mean output. The entries are checked here against a scan of the dense outputs.
+// The exit code is the number of vectors whose sparse row differs.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tinyprintf.h"
+#include "softex_rt.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+STIM_ARRAY(uint16_t, scores);
+
+// Header and up to LENGTH entries, reused by every vector
+static unsigned int sparse [(SOFTEX_SPARSE_HDR_SIZE + LENGTH * SOFTEX_SPARSE_ENTRY_SIZE) / sizeof(unsigned int)];
+
+int main () {
+
+    int errors = 0;
+
+    init_printf(NULL, (putcf) putf);
+
+    softex_sparse_t *row = (softex_sparse_t *) sparse;
+
+    // The largest power of two not above 1 / LENGTH, in bf16
+    unsigned int e = 0;
+
+    while ((1u << e) < LENGTH)
+        e++;
+
+    unsigned int threshold = (127 - e) << 7;
+
+    softex_rt_init(0);
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        volatile uint16_t *y = (volatile uint16_t *) (OUT_ADDR + i * LENGTH * FMT_WIDTH);
+
+        softex_softmax_async(scores + i * LENGTH, (void *) y, LENGTH, SOFTEX_RT_NATIVE);
+        softex_softmax_sparse_async(scores + i * LENGTH, row, LENGTH, SOFTEX_RT_NATIVE, threshold);
+
+        softex_wait_all();
+
+        // The probabilities are not negative, so their encodings compare as integers
+        unsigned int n = 0;
+        int          bad = 0;
+
+        for (unsigned int j = 0; j < LENGTH && !bad; j++) {
+            if (y[j] <= threshold)
+                continue;
+
+            if (n >= row->count || row->entries[n].index != j || row->entries[n].value != y[j]) {
+                printf("Vector %d entry %u: expected index %u value 0x%04x\n", i, n, j, y[j]);
+                bad = 1;
+            }
+
+            n++;
+        }
+
+        if (!bad && n != row->count) {
+            printf("Vector %d: %u entries, expected %u\n", i, row->count, n);
+            bad = 1;
+        }
+
+        errors += bad;
+    }
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = errors;
+
+	return 0;
+}
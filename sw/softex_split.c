@@ -14,7 +14,7 @@
 #include "golden-model/scores.h"
 #include "golden-model/golden.h"
 
-static uint16_t scores[LENGTH] = SCORES;
+STIM_ARRAY(uint16_t, scores);
 
 int main () {
 
@@ -45,7 +45,7 @@ int main () {
 
     HWPE_WRITE(scores, SOFTEX_IN_ADDR);
     HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_TOT_LEN);
-    HWPE_WRITE(0x1c010000, SOFTEX_OUT_ADDR);
+    HWPE_WRITE(OUT_ADDR, SOFTEX_OUT_ADDR);
     HWPE_WRITE(SOFTEX_CMD_DIV_ONLY | SOFTEX_CMD_LAST | (slot_id << 16), SOFTEX_COMMANDS);
 
     hwpe_trigger_job();
@@ -0,0 +1,99 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+#include <stdint.h>
+#include <stdatomic.h> 
+
+#include "tinyprintf.h"
+#include "hal_softex.h"
+#include "archi_softex.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+#define HALF_LEN    (LENGTH * FMT_WIDTH / (2 * FMT_WIDTH) * FMT_WIDTH)
+
+STIM_ARRAY(uint16_t, scores);
+
+static softex_stats_t stats[2 * N_VECTORS];
+
+int main () {
+
+    int acq_res;
+
+    hwpe_soft_clear();
+
+    while ((acq_res = hwpe_acquire_job()) < 0) {
+
+    }
+
+    HWPE_WRITE(((int) scores) + LENGTH * FMT_WIDTH * N_VECTORS, SOFTEX_CACHE_BASE_ADDR);
+    HWPE_WRITE(SOFTEX_CMD_SET_CACHE_ADDR | SOFTEX_CMD_NO_OP, SOFTEX_COMMANDS);
+    
+    hwpe_trigger_job();
+
+    /**********PARTIAL SOFTMAX**********/
+
+    // Each half of a vector is an independent softmax, as if it lived on a different cluster.
+    // The partial outputs are overwritten by the final normalisation
+    for (int i = 0; i < N_VECTORS; i++) {
+        for (int h = 0; h < 2; h++) {
+            while ((acq_res = hwpe_acquire_job()) < 0) {
+
+            }
+
+            HWPE_WRITE(((int) scores) + i * LENGTH * FMT_WIDTH + h * HALF_LEN, SOFTEX_IN_ADDR);
+            HWPE_WRITE(h ? LENGTH * FMT_WIDTH - HALF_LEN : HALF_LEN, SOFTEX_TOT_LEN);
+            HWPE_WRITE(OUT_ADDR + i * LENGTH * FMT_WIDTH + h * HALF_LEN, SOFTEX_OUT_ADDR);
+            HWPE_WRITE((int) &stats[2 * i + h], SOFTEX_STATS_ADDR);
+            HWPE_WRITE(SOFTEX_CMD_STATS_OUT, SOFTEX_COMMANDS);
+
+            hwpe_trigger_job();
+
+            asm volatile("wfi" ::: "memory");
+        }
+    }
+
+    /**********MERGE**********/
+
+    // The two partial statistics are combined and inverted into the state slot of the vector
+    for (int i = 0; i < N_VECTORS; i++) {
+        while ((acq_res = hwpe_acquire_job()) < 0) {
+
+        }
+
+        HWPE_WRITE((int) &stats[2 * i], SOFTEX_IN_ADDR);
+        HWPE_WRITE(2 * SOFTEX_STATS_SIZE, SOFTEX_TOT_LEN);
+        HWPE_WRITE(SOFTEX_CMD_MERGE_STATS | SOFTEX_CMD_ACC_ONLY | SOFTEX_CMD_ACQUIRE_SLOT | SOFTEX_CMD_LAST | (i << 16), SOFTEX_COMMANDS);
+
+        hwpe_trigger_job();
+
+        asm volatile("wfi" ::: "memory");
+    }
+
+    /**********NORMALISATION**********/
+
+    for (int i = 0; i < N_VECTORS; i++) {
+        while ((acq_res = hwpe_acquire_job()) < 0) {
+
+        }
+
+        HWPE_WRITE(((int) scores) + i * LENGTH * FMT_WIDTH, SOFTEX_IN_ADDR);
+        HWPE_WRITE(LENGTH * FMT_WIDTH, SOFTEX_TOT_LEN);
+        HWPE_WRITE(OUT_ADDR + i * LENGTH * FMT_WIDTH, SOFTEX_OUT_ADDR);
+        HWPE_WRITE(SOFTEX_CMD_DIV_ONLY | SOFTEX_CMD_LAST | (i << 16), SOFTEX_COMMANDS);
+
+        hwpe_trigger_job();
+
+        asm volatile("wfi" ::: "memory");
+    }
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = 0;
+
+	return 0;
+}
@@ -0,0 +1,78 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Softmax of every vector with a top-k list of TOPK_K entries (SOFTEX_TOPK_MAX by default). The outputs are checked
+// against the golden model, the lists are checked here against a scan of the outputs. The exit code is the number of
+// vectors whose list differs.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tinyprintf.h"
+#include "softex_rt.h"
+
+#include "golden-model/scores.h"
+#include "golden-model/golden.h"
+
+#ifndef TOPK_K
+#define TOPK_K  SOFTEX_TOPK_MAX
+#endif
+
+STIM_ARRAY(uint16_t, scores);
+
+static softex_topk_t topk [N_VECTORS][TOPK_K];
+
+int main () {
+
+    int errors = 0;
+
+    init_printf(NULL, (putcf) putf);
+
+    softex_rt_init(0);
+
+    for (int i = 0; i < N_VECTORS; i++)
+        softex_softmax_topk_async(scores + i * LENGTH, (void *) (OUT_ADDR + i * LENGTH * FMT_WIDTH), LENGTH, SOFTEX_RT_NATIVE, TOPK_K, topk[i]);
+
+    softex_wait_all();
+
+    // The probabilities are not negative, so their encodings compare as integers. Each entry is the first largest
+    // output below the previous one, or equal to it at a higher index
+    for (int i = 0; i < N_VECTORS; i++) {
+        volatile uint16_t *y = (volatile uint16_t *) (OUT_ADDR + i * LENGTH * FMT_WIDTH);
+
+        unsigned int prev_index = 0xffffffff,
+                     prev_value = 0x10000;
+
+        for (int e = 0; e < TOPK_K; e++) {
+            unsigned int index = 0xffffffff,
+                         value = 0;
+
+            for (unsigned int j = 0; j < LENGTH; j++) {
+                int below = y[j] < prev_value || (y[j] == prev_value && j > prev_index);
+
+                if (below && (index == 0xffffffff || y[j] > value)) {
+                    index = j;
+                    value = y[j];
+                }
+            }
+
+            if (topk[i][e].index != index || (index != 0xffffffff && topk[i][e].value != value)) {
+                printf("Vector %d entry %d: index %u value 0x%04x, expected index %u value 0x%04x\n", i, e, topk[i][e].index, topk[i][e].value, index, value);
+                errors++;
+                break;
+            }
+
+            prev_index = index;
+            prev_value = value;
+        }
+    }
+
+    //End the simulation
+    *(volatile int *)(0x80000000) = errors;
+
+	return 0;
+}
@@ -0,0 +1,405 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Andrea Belano <andrea.belano@studio.unibo.it>
+//
+
+// Streaming scoreboard of softex_tb, enabled with +SCOREBOARD.
+//
+// The testbench forwards the registers of every triggered job and every word
+// that SoftEx stores to the TCDM. When a job is triggered its inputs are read
+// from the data memory and run through softex_model.hpp, and the results are
+// recorded by output address. Each stored element is then compared as soon as
+// it is written, so a run stops at the first mismatch instead of at the end of
+// the program. The indexes of the top-k records and of the sparse rows, and the
+// counts of the latter, must match exactly, as must the maximum and the
+// log-sum-exp written by SOFTEX_OUT_LSE.
+//
+// Jobs whose results are not modelled here (descriptors, fixed point I/O, row
+// statistics of STATS_OUT and MERGE_STATS, log-sum-exps of more than one row)
+// are skipped, along with the partial jobs of a slot that one of them touched. Stores to addresses without an expected result, such as
+// slot caches and completion records, are ignored.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#include "softex_model.hpp"
+
+// Job registers, the words from SOFTEX_REG_OFFS on. Indices mirror archi_softex.h
+constexpr unsigned  N_REGS          = 22;
+
+namespace reg {
+constexpr unsigned  IN_ADDR         = 0;
+constexpr unsigned  OUT_ADDR        = 1;
+constexpr unsigned  TOT_LEN         = 2;
+constexpr unsigned  COMMANDS        = 3;
+constexpr unsigned  CAST_CTRL       = 5;
+constexpr unsigned  ROWS            = 8;
+constexpr unsigned  IN_ROW_STRIDE   = 9;
+constexpr unsigned  OUT_ROW_STRIDE  = 10;
+constexpr unsigned  SCALE           = 11;
+constexpr unsigned  VALID_LEN       = 12;
+constexpr unsigned  STATS_ADDR      = 13;
+constexpr unsigned  ACCURACY_CTRL   = 18;
+constexpr unsigned  OUT_CTRL        = 19;
+constexpr unsigned  TOPK_ADDR       = 20;
+constexpr unsigned  THRESHOLD       = 21;
+}
+
+namespace cmd {
+constexpr uint32_t  ACC_ONLY        = 0x00000001;
+constexpr uint32_t  DIV_ONLY        = 0x00000002;
+constexpr uint32_t  ACQUIRE_SLOT    = 0x00000004;
+constexpr uint32_t  LAST            = 0x00000008;
+constexpr uint32_t  NO_OP           = 0x00000020;
+constexpr uint32_t  INT_INPUT       = 0x00000040;
+constexpr uint32_t  INT_OUTPUT      = 0x00000080;
+constexpr uint32_t  DESC_MODE       = 0x00000100;
+constexpr uint32_t  SCALE           = 0x00000400;
+constexpr uint32_t  MASK            = 0x00000800;
+constexpr uint32_t  CAUSAL          = 0x00001000;
+constexpr uint32_t  STATS_OUT       = 0x00002000;
+constexpr uint32_t  MERGE_STATS     = 0x00004000;
+
+constexpr uint32_t  UNMODELLED      = INT_INPUT | INT_OUTPUT | DESC_MODE | STATS_OUT | MERGE_STATS;
+}
+
+namespace accuracy {
+constexpr uint32_t  EXP_RAW         = 0x00000001;
+constexpr uint32_t  EXP_TRUNC       = 0x00000002;
+constexpr unsigned  NEWTON          = 4;
+}
+
+namespace out_mode {
+constexpr uint32_t  LOG             = 1;
+constexpr uint32_t  LSE             = 2;
+constexpr unsigned  TOPK            = 4;
+constexpr uint32_t  SPARSE          = 0x00000100;
+constexpr unsigned  ACT             = 12;
+}
+
+// Exported by softex_tb, reads a word of the data memory
+extern "C" int sb_mem_read (int addr);
+
+namespace {
+
+struct job_t {
+    unsigned    id;
+    uint32_t    regs [N_REGS];
+};
+
+struct expected_t {
+    uint16_t    value;
+    uint8_t     bytes;
+    bool        exact;
+    unsigned    job;
+    unsigned    row;
+    unsigned    index;
+};
+
+struct slot_t {
+    softex::row_state   state;
+    bool                modelled = true;
+};
+
+struct scoreboard_t {
+    softex::params  p;
+    unsigned        max_ulp     = 3;
+
+    std::vector<job_t>                          jobs;
+    std::unordered_map<uint32_t, expected_t>    expected;
+    std::unordered_map<unsigned, slot_t>        slots;
+
+    uint64_t    checked     = 0;
+    uint64_t    max_seen    = 0;
+    unsigned    skipped     = 0;
+};
+
+scoreboard_t sb;
+
+uint16_t read_elem (uint32_t addr, unsigned bytes) {
+    uint16_t x = 0;
+
+    for (unsigned b = 0; b < bytes; b++)
+        x |= uint16_t((uint32_t(sb_mem_read(int((addr + b) & ~3u))) >> (8 * ((addr + b) & 3))) & 0xff) << (8 * b);
+
+    return x;
+}
+
+// Inputs of one row as they enter the datapath: converted to bf16, pre-scaled and masked
+std::vector<uint16_t> load_row (const job_t &job, uint32_t addr, size_t len, unsigned row) {
+    const uint32_t          commands    = job.regs[reg::COMMANDS];
+    const softex::io_fmt    in_fmt      = softex::io_fmt((job.regs[reg::CAST_CTRL] >> 16) & 0x3);
+    const unsigned          in_bytes    = softex::io_fmt_bytes(in_fmt);
+    const uint16_t          scale       = uint16_t(job.regs[reg::SCALE]);
+    const size_t            valid       = size_t(job.regs[reg::VALID_LEN]) + (commands & cmd::CAUSAL ? row : 0);
+
+    std::vector<uint16_t> x(len);
+
+    for (size_t i = 0; i < len; i++) {
+        uint16_t v = softex::io_to_bf16(read_elem(addr + uint32_t(i * in_bytes), in_bytes), in_fmt);
+
+        if (commands & cmd::SCALE)
+            v = softex::bf16_mul(v, scale);
+
+        if ((commands & cmd::MASK) && i >= valid)
+            v = softex::BF16_NEG_INF;
+
+        x[i] = v;
+    }
+
+    return x;
+}
+
+void expect (const job_t &job, uint32_t addr, const std::vector<uint16_t> &y, unsigned row) {
+    const softex::io_fmt    out_fmt     = softex::io_fmt((job.regs[reg::CAST_CTRL] >> 18) & 0x3);
+    const unsigned          out_bytes   = softex::io_fmt_bytes(out_fmt);
+
+    for (size_t i = 0; i < y.size(); i++)
+        sb.expected[addr + uint32_t(i * out_bytes)] = {softex::bf16_to_io(y[i], out_fmt), uint8_t(out_bytes), false, unsigned(sb.jobs.size() - 1), row, unsigned(i)};
+}
+
+// An (index, value) entry of a top-k record or of a sparse row. Each word is checked as two halves
+void expect_entry (uint32_t addr, const softex::topk_entry &t, unsigned row, unsigned e) {
+    const unsigned  job     = unsigned(sb.jobs.size() - 1);
+
+    sb.expected[addr]       = {uint16_t(t.index), 2, true, job, row, e};
+    sb.expected[addr + 2]   = {uint16_t(t.index >> 16), 2, true, job, row, e};
+    sb.expected[addr + 4]   = {t.value, 2, false, job, row, e};
+    sb.expected[addr + 6]   = {0, 2, true, job, row, e};
+}
+
+// Top-k record of a row, taken from the outputs before the cast
+void expect_topk (uint32_t addr, const std::vector<uint16_t> &y, unsigned k, unsigned row) {
+    const std::vector<softex::topk_entry> t = softex::topk(y.data(), y.size(), k);
+
+    for (unsigned e = 0; e < k; e++)
+        expect_entry(addr + e * 8, t[e], row, e);
+}
+
+// Sparse row: the count in the header, then the entries. The header is checked as an entry with the count as index
+void expect_sparse (uint32_t addr, const std::vector<uint16_t> &y, uint16_t threshold, unsigned row) {
+    const std::vector<softex::topk_entry> t = softex::sparse(y.data(), y.size(), threshold);
+
+    expect_entry(addr, {uint32_t(t.size()), 0}, row, 0);
+
+    sb.expected[addr + 4].exact = true;
+
+    for (unsigned e = 0; e < t.size(); e++)
+        expect_entry(addr + 8 + e * 8, t[e], row, e);
+}
+
+// Row statistics of SOFTEX_OUT_LSE: the maximum, then max + ln(denominator) in fp32
+void expect_lse (uint32_t addr, const softex::row_state &state, unsigned row) {
+    const unsigned  job     = unsigned(sb.jobs.size() - 1);
+    const uint32_t  lse     = softex::f32_bits(softex::log_sum_exp(state.denominator, state.max));
+
+    sb.expected[addr]       = {state.max, 2, true, job, row, 0};
+    sb.expected[addr + 2]   = {0, 2, true, job, row, 0};
+    sb.expected[addr + 4]   = {uint16_t(lse), 2, true, job, row, 1};
+    sb.expected[addr + 6]   = {uint16_t(lse >> 16), 2, true, job, row, 1};
+}
+
+// Model parameters of a job, with the exponential and the reciprocal set by its ACCURACY_CTRL and the output by OUT_CTRL
+softex::params job_params (const job_t &job) {
+    const uint32_t  acc     = job.regs[reg::ACCURACY_CTRL];
+    const uint32_t  mode    = job.regs[reg::OUT_CTRL] & 0x3;
+    const unsigned  skip    = (acc >> accuracy::NEWTON) & 0x3;
+
+    softex::params p = sb.p;
+
+    p.exp_correction    = !(acc & accuracy::EXP_RAW);
+    p.exp_rounding      = !(acc & accuracy::EXP_TRUNC);
+    p.newton_iters      = skip >= sb.p.newton_iters ? 0 : sb.p.newton_iters - skip;
+    p.log_output        = mode == out_mode::LOG;
+
+    return p;
+}
+
+void print_job (const job_t &job) {
+    std::fprintf(stderr, "[SB] -   job %u: IN_ADDR=0x%08x OUT_ADDR=0x%08x TOT_LEN=%u COMMANDS=0x%08x CAST_CTRL=0x%08x ROWS=%u ACCURACY_CTRL=0x%08x OUT_CTRL=0x%08x TOPK_ADDR=0x%08x THRESHOLD=0x%08x\n",
+                 job.id, job.regs[reg::IN_ADDR], job.regs[reg::OUT_ADDR], job.regs[reg::TOT_LEN], job.regs[reg::COMMANDS],
+                 job.regs[reg::CAST_CTRL], job.regs[reg::ROWS], job.regs[reg::ACCURACY_CTRL], job.regs[reg::OUT_CTRL], job.regs[reg::TOPK_ADDR], job.regs[reg::THRESHOLD]);
+}
+
+} // namespace
+
+extern "C" void sb_init (int lanes, int acc_regs, int max_ulp) {
+    sb = scoreboard_t();
+
+    sb.p.lanes      = lanes;
+    sb.p.acc_regs   = acc_regs;
+    sb.max_ulp      = max_ulp;
+}
+
+// Called on every trigger with the registers of the context being launched. Jobs run in trigger order, so the
+// model of a DIV_ONLY job sees the slot state left by the ACC_ONLY jobs before it
+extern "C" void sb_job (int id, const int *regs) {
+    job_t job = {unsigned(id), {}};
+
+    for (unsigned i = 0; i < N_REGS; i++)
+        job.regs[i] = uint32_t(regs[i]);
+
+    const uint32_t  in_addr     = job.regs[reg::IN_ADDR],
+                    out_addr    = job.regs[reg::OUT_ADDR],
+                    tot_len     = job.regs[reg::TOT_LEN],
+                    commands    = job.regs[reg::COMMANDS],
+                    cast_ctrl   = job.regs[reg::CAST_CTRL],
+                    rows        = job.regs[reg::ROWS],
+                    in_stride   = job.regs[reg::IN_ROW_STRIDE],
+                    out_stride  = job.regs[reg::OUT_ROW_STRIDE];
+
+    if (commands & cmd::NO_OP)
+        return;
+
+    sb.jobs.push_back(job);
+
+    const softex::params p = job_params(job);
+
+    const bool      acc_only    = commands & cmd::ACC_ONLY;
+    const bool      div_only    = commands & cmd::DIV_ONLY;
+    const bool      lse         = (job.regs[reg::OUT_CTRL] & 0x3) == out_mode::LSE;
+    const unsigned  k           = std::min((job.regs[reg::OUT_CTRL] >> out_mode::TOPK) & 0xf, softex::TOPK_MAX);
+    const bool      sparse      = job.regs[reg::OUT_CTRL] & out_mode::SPARSE;
+    const auto      act         = softex::act_mode((job.regs[reg::OUT_CTRL] >> out_mode::ACT) & 0x7);
+    const unsigned  slot_id     = commands >> 16;
+    const size_t    len         = tot_len / softex::io_fmt_bytes(softex::io_fmt((cast_ctrl >> 16) & 0x3));
+
+    if (!acc_only && !div_only) {
+        if ((commands & cmd::UNMODELLED) || (lse && act == softex::act_mode::none && rows > 1)) {
+            sb.skipped++;
+            return;
+        }
+
+        // A complete LSE job has no outputs, only the statistics of its row
+        if (lse && act == softex::act_mode::none) {
+            softex::row_state state;
+
+            std::vector<uint16_t> x = load_row(job, in_addr, len, 0);
+
+            softex::accumulate(p, x.data(), len, state);
+
+            expect_lse(job.regs[reg::STATS_ADDR], state, 0);
+
+            return;
+        }
+
+        // An activation is never masked and only the exponential takes the pre-scale
+        job_t in_job = job;
+
+        if (act != softex::act_mode::none)
+            in_job.regs[reg::COMMANDS] &= ~(cmd::MASK | (act != softex::act_mode::exp ? cmd::SCALE : 0));
+
+        for (unsigned r = 0; r < (rows > 1 ? rows : 1); r++) {
+            std::vector<uint16_t> x = load_row(in_job, in_addr + r * in_stride, len, r);
+            std::vector<uint16_t> y(len);
+
+            if (act != softex::act_mode::none)
+                softex::activation(p, act, x.data(), len, y.data());
+            else
+                softex::softmax(p, x.data(), len, y.data());
+
+            if (sparse)
+                expect_sparse(out_addr + r * out_stride, y, uint16_t(job.regs[reg::THRESHOLD]), r);
+            else
+                expect(job, out_addr + r * out_stride, y, r);
+
+            if (k != 0)
+                expect_topk(job.regs[reg::TOPK_ADDR] + r * k * 8, y, k, r);
+        }
+
+        return;
+    }
+
+    slot_t &slot = sb.slots[slot_id];
+
+    if (acc_only && (commands & cmd::ACQUIRE_SLOT))
+        slot = slot_t();
+
+    // The pre-scale and the mask count elements from the start of the job, not of the row
+    if (!slot.modelled || (div_only && !slot.state.valid) || (commands & (cmd::UNMODELLED | cmd::SCALE | cmd::MASK))) {
+        slot.modelled = false;
+        sb.skipped++;
+        return;
+    }
+
+    std::vector<uint16_t> x = load_row(job, in_addr, len, 0);
+
+    if (acc_only) {
+        softex::accumulate(p, x.data(), len, slot.state);
+
+        // The last accumulation of an LSE writes the statistics and frees the slot
+        if (lse && (commands & cmd::LAST)) {
+            expect_lse(job.regs[reg::STATS_ADDR], slot.state, 0);
+
+            sb.slots.erase(slot_id);
+        }
+    } else {
+        std::vector<uint16_t> y(len);
+
+        softex::normalise_state(p, x.data(), len, slot.state, y.data());
+
+        expect(job, out_addr, y, 0);
+
+        if (commands & cmd::LAST)
+            sb.slots.erase(slot_id);
+    }
+}
+
+// Called for every word stored by SoftEx. Returns 1 on the first element off by more than the tolerance
+extern "C" int sb_store (int word_addr, int word_data, int be) {
+    const uint32_t addr = uint32_t(word_addr);
+    const uint32_t data = uint32_t(word_data);
+
+    for (unsigned b = 0; b < 4; b++) {
+        if (!((be >> b) & 1))
+            continue;
+
+        auto it = sb.expected.find(addr + b);
+
+        if (it == sb.expected.end())
+            continue;
+
+        const expected_t    e       = it->second;
+        const uint32_t      mask    = (1u << (8 * e.bytes)) - 1;
+        const uint16_t      value   = uint16_t((data >> (8 * b)) & mask);
+        const unsigned      diff    = e.value > value ? e.value - value : value - e.value;
+
+        sb.expected.erase(it);
+        sb.checked++;
+
+        if (diff > sb.max_seen)
+            sb.max_seen = diff;
+
+        if (diff > (e.exact ? 0 : sb.max_ulp)) {
+            std::fprintf(stderr, "[SB] - Mismatch at 0x%08x, row %u element %u:  Expected: 0x%04x\tWas: 0x%04x\tDifference: %u (tolerance %u)\n",
+                         addr + b, e.row, e.index, e.value, value, diff, e.exact ? 0 : sb.max_ulp);
+
+            print_job(sb.jobs[e.job]);
+
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Called at the end of the simulation. Results that were never written count as errors
+extern "C" int sb_final () {
+    std::fprintf(stderr, "[SB] - Jobs: %zu (%u not modelled)  Elements checked: %llu  Largest difference: %llu ULPs\n",
+                 sb.jobs.size(), sb.skipped, (unsigned long long) sb.checked, (unsigned long long) sb.max_seen);
+
+    if (!sb.expected.empty()) {
+        const expected_t &e = sb.expected.begin()->second;
+
+        std::fprintf(stderr, "[SB] - %zu results were never written, e.g. row %u element %u of\n", sb.expected.size(), e.row, e.index);
+
+        print_job(sb.jobs[e.job]);
+    }
+
+    return int(sb.expected.size());
+}
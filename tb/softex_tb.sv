@@ -12,9 +12,10 @@ module softex_tb;
     parameter real          PROB_STALL = 0.0;
     parameter int unsigned  NC = 1;
     parameter int unsigned  ID = 10;
-    parameter int unsigned  DW = 128 + 32;
+    parameter int unsigned  BANDWIDTH = 128;   // Data bits of a TCDM beat: 128, 256 or 512
+    parameter int unsigned  DW = BANDWIDTH + 32;
     parameter int unsigned  MP = DW/32;
-    parameter int unsigned  MEMORY_SIZE = 192*1024;
+    parameter int unsigned  MEMORY_SIZE = 256*1024;
     parameter int unsigned  STACK_MEMORY_SIZE = 192*1024;
     parameter int unsigned  PULP_XPULP = 1;
     parameter int unsigned  FPU = 0;
@@ -24,11 +25,16 @@ module softex_tb;
     parameter logic [31:0]  HWPE_ADDR_BASE_BIT = 20;
     parameter string        STIM_INSTR = "./stim_instr.txt";
     parameter string        STIM_DATA  = "./stim_data.txt";
+    parameter string        GOLDEN     = "golden-model/golden.txt";
     parameter int unsigned  OUTPUT_SIZE = 2;
     parameter int unsigned  USE_ECC = 0;
-    parameter int unsigned  EW = (USE_ECC) ? 43 : 1; // 35 data check-bit + 8 meta check-bit
+    parameter int unsigned  EW = (USE_ECC) ? 7*MP + 8 : 1; // 7 data check-bit per port + 8 meta check-bit
+    parameter int unsigned  SPLIT_LDST = 0;   // Separate store ports, after the core port of the data memory
+    parameter int unsigned  DUAL_ROW = 0;     // Normalisation lane for CMD_DUAL_ROW
+    localparam int unsigned MP_ST = SPLIT_LDST ? MP : 0;
 
     logic clk;
+    logic clk_delayed;
     logic rst_n;
     logic test_mode;
     logic fetch_enable;
@@ -37,7 +43,7 @@ module softex_tb;
 
     hwpe_stream_intf_tcdm instr[0:0]  (.clk(clk));
     hwpe_stream_intf_tcdm stack[0:0]  (.clk(clk));
-    hwpe_stream_intf_tcdm tcdm [MP:0] (.clk(clk));
+    hwpe_stream_intf_tcdm tcdm [MP+MP_ST:0] (.clk(clk));
 
     logic [NC-1:0][1:0] evt;
 
@@ -57,6 +63,19 @@ module softex_tb;
     logic          [7:0] tcdm_r_id;
     logic [EW-1:0]       tcdm_r_ecc;
 
+    logic [MP-1:0]       tcdm_st_req;
+    logic [MP-1:0]       tcdm_st_gnt;
+    logic [MP-1:0][31:0] tcdm_st_add;
+    logic [MP-1:0]       tcdm_st_wen;
+    logic [MP-1:0][3:0]  tcdm_st_be;
+    logic [MP-1:0][31:0] tcdm_st_data;
+    logic [MP-1:0]       tcdm_st_r_ready;
+    logic [EW-1:0]       tcdm_st_ecc;
+    logic [MP-1:0] [7:0] tcdm_st_id;
+    logic [MP-1:0][31:0] tcdm_st_r_data;
+    logic [MP-1:0]       tcdm_st_r_valid;
+    logic [EW-1:0]       tcdm_st_r_ecc;
+
     logic          periph_req;
     logic          periph_gnt;
     logic [31:0]   periph_add;
@@ -97,6 +116,12 @@ module softex_tb;
         #TCP;
     endtask
 
+    // Response clock of the dummy memories when simulating with Verilator
+    always @(clk)
+    begin
+        clk_delayed <= #(TA) clk;
+    end
+
     // bindings
     always_comb
     begin : bind_periph
@@ -151,6 +176,24 @@ module softex_tb;
         assign tcdm_r_valid [ii] = tcdm[ii].r_valid;
     end
 
+    if (SPLIT_LDST) begin : tcdm_st_binding
+        for(genvar ii=0; ii<MP; ii++) begin : gen_port
+            assign tcdm[MP+1+ii].req     = tcdm_st_req     [ii];
+            assign tcdm[MP+1+ii].add     = tcdm_st_add     [ii];
+            assign tcdm[MP+1+ii].wen     = tcdm_st_wen     [ii];
+            assign tcdm[MP+1+ii].be      = tcdm_st_be      [ii];
+            if (~USE_ECC)
+                assign tcdm[MP+1+ii].data = tcdm_st_data    [ii];
+            assign tcdm_st_gnt     [ii] = tcdm[MP+1+ii].gnt;
+            assign tcdm_st_r_data  [ii] = tcdm[MP+1+ii].r_data;
+            assign tcdm_st_r_valid [ii] = tcdm[MP+1+ii].r_valid;
+        end
+    end else begin : tcdm_st_tie_off
+        assign tcdm_st_gnt     = '0;
+        assign tcdm_st_r_data  = '0;
+        assign tcdm_st_r_valid = '0;
+    end
+
     assign tcdm[MP].req     = data_req & (data_addr[31:24] != '0) & (data_addr[31:24] != 8'h80) & ~data_addr[HWPE_ADDR_BASE_BIT];
     assign tcdm[MP].add     = data_addr;
     assign tcdm[MP].wen     = ~data_we;
@@ -201,8 +244,33 @@ module softex_tb;
             assign tcdm_r_ecc[(ii+1)*7-1:ii*7] = tcdm_r_data_enc[ii][38:32];
         end
         assign tcdm_r_ecc[EW-1:(7*MP)] = '0;
+
+        // Same for the store ports
+        logic [MP-1:0][1:0]  err_on_st_data;
+        logic [MP-1:0][38:0] tcdm_st_r_data_enc;
+        for(genvar ii=0; ii<MP_ST; ii++) begin : st_data_decoding
+            hsiao_ecc_dec #(
+                .DataWidth ( 32 )
+            ) i_data_dec (
+                .in         ( { tcdm_st_ecc[(ii+1)*7-1+8:ii*7+8], tcdm_st_data[ii] } ),
+                .out        ( tcdm[MP+1+ii].data ),
+                .syndrome_o ( ),
+                .err_o      (err_on_st_data[ii])
+            );
+        end
+        for(genvar ii=0; ii<MP; ii++) begin : st_r_data_encoding
+            hsiao_ecc_enc #(
+                .DataWidth ( 32 )
+            ) i_r_data_enc (
+                .in  (tcdm_st_r_data[ii]),
+                .out (tcdm_st_r_data_enc[ii])
+            );
+            assign tcdm_st_r_ecc[(ii+1)*7-1:ii*7] = tcdm_st_r_data_enc[ii][38:32];
+        end
+        assign tcdm_st_r_ecc[EW-1:(7*MP)] = '0;
     end else begin : gen_no_r_ecc
-        assign tcdm_r_ecc = '0;
+        assign tcdm_r_ecc    = '0;
+        assign tcdm_st_r_ecc = '0;
     end
 
     softex_wrap #(
@@ -210,7 +278,9 @@ module softex_tb;
         .N_CORES            ( NC                 ),
         .DW                 ( DW                 ),
         .EW                 ( EW                 ),
-        .MP                 ( MP                 )
+        .MP                 ( MP                 ),
+        .SPLIT_LDST         ( SPLIT_LDST         ),
+        .DUAL_ROW           ( DUAL_ROW           )
     ) i_softex_wrap      (
         .clk_i              ( clk                ),
         .rst_ni             ( rst_n              ),
@@ -232,6 +302,21 @@ module softex_tb;
         .tcdm_r_user_i      ( tcdm_r_user        ),
         .tcdm_r_id_i        ( tcdm_r_id          ),
         .tcdm_r_ecc_i       ( tcdm_r_ecc         ),
+        .tcdm_st_req_o      ( tcdm_st_req        ),
+        .tcdm_st_add_o      ( tcdm_st_add        ),
+        .tcdm_st_wen_o      ( tcdm_st_wen        ),
+        .tcdm_st_be_o       ( tcdm_st_be         ),
+        .tcdm_st_data_o     ( tcdm_st_data       ),
+        .tcdm_st_r_ready_o  ( tcdm_st_r_ready    ),
+        .tcdm_st_ecc_o      ( tcdm_st_ecc        ),
+        .tcdm_st_id_o       ( tcdm_st_id         ),
+        .tcdm_st_gnt_i      ( tcdm_st_gnt        ),
+        .tcdm_st_r_data_i   ( tcdm_st_r_data     ),
+        .tcdm_st_r_valid_i  ( tcdm_st_r_valid    ),
+        .tcdm_st_r_opc_i    ( 1'b0               ),
+        .tcdm_st_r_user_i   ( 1'b0               ),
+        .tcdm_st_r_id_i     ( tcdm_st_id [0]     ),
+        .tcdm_st_r_ecc_i    ( tcdm_st_r_ecc      ),
         .periph_req_i       ( periph_req         ),
         .periph_gnt_o       ( periph_gnt         ),
         .periph_add_i       ( periph_add         ),
@@ -245,7 +330,7 @@ module softex_tb;
     );
 
     tb_dummy_memory  #(
-        .MP             ( MP + 1        ),
+        .MP             ( MP + MP_ST + 1 ),
         .MEMORY_SIZE    ( MEMORY_SIZE   ),
         .BASE_ADDR      ( 32'h1c010000  ),
         .PROB_STALL     ( PROB_STALL    ),
@@ -255,7 +340,7 @@ module softex_tb;
     ) i_dummy_dmemory (
         .clk_i          ( clk           ),
         .rst_ni         ( rst_n         ),
-        .clk_delayed_i  ( '0            ),
+        .clk_delayed_i  ( clk_delayed   ),
         .randomize_i    ( 1'b0          ),
         .enable_i       ( 1'b1          ),
         .stallable_i    ( 1'b1          ),
@@ -273,7 +358,7 @@ module softex_tb;
     ) i_dummy_imemory (
         .clk_i          ( clk         ),
         .rst_ni         ( rst_n       ),
-        .clk_delayed_i  ( '0          ),
+        .clk_delayed_i  ( clk_delayed ),
         .randomize_i    ( 1'b0        ),
         .enable_i       ( 1'b1        ),
         .stallable_i    ( 1'b0        ),
@@ -291,7 +376,7 @@ module softex_tb;
     ) i_dummy_stack_memory (
         .clk_i               ( clk               ),
         .rst_ni              ( rst_n             ),
-        .clk_delayed_i       ( '0                ),
+        .clk_delayed_i       ( clk_delayed       ),
         .randomize_i         ( 1'b0              ),
         .enable_i            ( 1'b1              ),
         .stallable_i         ( 1'b0              ),
@@ -382,30 +467,150 @@ module softex_tb;
     end
   
     int f_golden;
+    int f_stim_bin;
+
+    // Binary images written by the golden models with --binary 1: load address and payload bytes, then the payload
+    // as 32-bit memory words. They skip the text conversions, which dominate the set up of long tests
+    logic [31:0] bin_header [2];
+    logic [31:0] golden_words [];
 
     logic done = 0;
 
+    // Errors found by the firmware itself, written along with the end of the simulation
+    int unsigned sw_errors = 0;
+
     always_ff @(posedge clk)
     begin
         if((data_addr == 32'h80000000 ) && (data_we & data_req == 1'b1)) begin
             done = 1;
+            sw_errors = data_wdata;
         end
     end
 
+    // Characters printed by the firmware through tinyprintf's putf
+    always_ff @(posedge clk)
+    begin
+        if((data_addr == 32'h80000004 ) && (data_we & data_req == 1'b1)) begin
+            $write("%c", data_wdata [7:0]);
+        end
+    end
+
+    // Streaming scoreboard, see softex_scoreboard.cpp. With +SCOREBOARD every job triggered by the core is run
+    // through the C++ model and every word stored by SoftEx is checked against it as soon as it is written
+    localparam int unsigned SB_REGS = 22;
+
+    import "DPI-C" function void sb_init (input int lanes, input int acc_regs, input int max_ulp);
+    import "DPI-C" function void sb_job (input int id, input int regs [SB_REGS]);
+    import "DPI-C" function int sb_store (input int addr, input int data, input int be);
+    import "DPI-C" function int sb_final ();
+
+    export "DPI-C" function sb_mem_read;
+
+    function int sb_mem_read (input int addr);
+        return softex_tb.i_dummy_dmemory.memory[(addr - 32'h1c010000) >> 2];
+    endfunction
+
+    bit          scoreboard = 0;
+    int          sb_regs [softex_pkg::N_CTRL_CNTX][SB_REGS];
+    int unsigned sb_triggered = 0;
+
+    // Shadow of the job registers. The contexts are programmed in turn, so the one being written is the one of the
+    // next trigger
+    always_ff @(posedge clk)
+    begin
+        if (scoreboard && periph_req && periph_gnt && ~periph_wen) begin
+            if (periph_add [11:0] == 12'h000) begin
+                sb_job(sb_triggered, sb_regs [sb_triggered % softex_pkg::N_CTRL_CNTX]);
+                sb_triggered <= sb_triggered + 1;
+            end else if (periph_add [11:0] == 12'h014) begin
+                sb_triggered <= 0;
+            end else if (periph_add [11:0] >= 12'h020 && periph_add [11:0] < 12'h020 + 4 * SB_REGS) begin
+                sb_regs [sb_triggered % softex_pkg::N_CTRL_CNTX] [(periph_add [11:0] - 12'h020) >> 2] <= periph_data;
+            end
+        end
+    end
+
+    always_ff @(posedge clk)
+    begin
+        if (scoreboard) begin
+            for (int i = 0; i < MP; i++) begin
+                if (tcdm_req [i] && tcdm_gnt [i] && ~tcdm_wen [i] && sb_store(tcdm_add [i], tcdm_data [i], tcdm_be [i]) != 0)
+                    $fatal(1, "[SB] - Stopping at the first mismatch at %t", $time);
+            end
+
+            for (int i = 0; i < MP_ST; i++) begin
+                if (tcdm_st_req [i] && tcdm_st_gnt [i] && ~tcdm_st_wen [i] && sb_store(tcdm_st_add [i], tcdm_st_data [i], tcdm_st_be [i]) != 0)
+                    $fatal(1, "[SB] - Stopping at the first mismatch at %t", $time);
+            end
+        end
+    end
+
+    int unsigned busy_cycles = 0;
+
+    // Cycles from the start of the core to the end of the simulation, which also count the programming of the jobs
+    int unsigned run_cycles = 0;
+
+    always_ff @(posedge clk)
+    begin
+        if (busy)
+            busy_cycles <= busy_cycles + 1;
+
+        if (fetch_enable & ~done)
+            run_cycles <= run_cycles + 1;
+    end
+
     int unsigned error_threshold = 3;
 
+    // Run-time overrides, so that a single Verilator model serves every test
+    string       stim_instr  = STIM_INSTR;
+    string       stim_data   = STIM_DATA;
+    string       golden      = GOLDEN;
+    string       stim_bin    = "";
+    string       golden_bin  = "";
+    int unsigned output_size = OUTPUT_SIZE;
+    int unsigned sb_ulp      = 3;
+    int unsigned sb_acc_regs = softex_pkg::NUM_REGS_FMA_ACC;
+
     initial begin
         integer id;
         int cnt_rd, cnt_wr;
+        real elem_per_cycle;
 
-        int unsigned pos, n, data, difference, errors, tot_err_ulp;
+        int unsigned pos, n, data, difference, errors, tot_err_ulp, base;
 
         test_mode = 1'b0;
         fetch_enable = 1'b0;
 
+        void'($value$plusargs("STIM_INSTR=%s", stim_instr));
+        void'($value$plusargs("STIM_DATA=%s", stim_data));
+        void'($value$plusargs("GOLDEN=%s", golden));
+        void'($value$plusargs("OUTPUT_SIZE=%d", output_size));
+        void'($value$plusargs("STIM_BIN=%s", stim_bin));
+        void'($value$plusargs("GOLDEN_BIN=%s", golden_bin));
+        void'($value$plusargs("SB_ULP=%d", sb_ulp));
+        void'($value$plusargs("SB_ACC_REGS=%d", sb_acc_regs));
+
+        scoreboard = $test$plusargs("SCOREBOARD");
+
+        if (scoreboard)
+            sb_init(BANDWIDTH / 16, sb_acc_regs, sb_ulp);
+
         // load instruction memory
-        $readmemh(STIM_INSTR, softex_tb.i_dummy_imemory.memory);
-        $readmemh(STIM_DATA,  softex_tb.i_dummy_dmemory.memory);
+        $readmemh(stim_instr, softex_tb.i_dummy_imemory.memory);
+        $readmemh(stim_data,  softex_tb.i_dummy_dmemory.memory);
+
+        // The scores go straight to their load address, on top of the firmware's data
+        if (stim_bin != "") begin
+            f_stim_bin = $fopen(stim_bin, "rb");
+
+            if (f_stim_bin == 0)
+                $fatal(1, "[TB] - Cannot open %s", stim_bin);
+
+            void'($fread(bin_header, f_stim_bin));
+            void'($fread(softex_tb.i_dummy_dmemory.memory, f_stim_bin, (bin_header[0] - 32'h1c010000) >> 2, (bin_header[1] + 3) >> 2));
+
+            $fclose(f_stim_bin);
+        end
 
         #(100*TCP);
         fetch_enable = 1'b1;
@@ -415,39 +620,94 @@ module softex_tb;
         while(~core_sleep || ~done)
             #(TCP);
 
-        cnt_rd = softex_tb.i_dummy_dmemory.cnt_rd[0] + softex_tb.i_dummy_dmemory.cnt_rd[1] + softex_tb.i_dummy_dmemory.cnt_rd[2] + softex_tb.i_dummy_dmemory.cnt_rd[3] + softex_tb.i_dummy_dmemory.cnt_rd[4] + softex_tb.i_dummy_dmemory.cnt_rd[5] + softex_tb.i_dummy_dmemory.cnt_rd[6] + softex_tb.i_dummy_dmemory.cnt_rd[7] + softex_tb.i_dummy_dmemory.cnt_rd[8];
-        cnt_wr = softex_tb.i_dummy_dmemory.cnt_wr[0] + softex_tb.i_dummy_dmemory.cnt_wr[1] + softex_tb.i_dummy_dmemory.cnt_wr[2] + softex_tb.i_dummy_dmemory.cnt_wr[3] + softex_tb.i_dummy_dmemory.cnt_wr[4] + softex_tb.i_dummy_dmemory.cnt_wr[5] + softex_tb.i_dummy_dmemory.cnt_wr[6] + softex_tb.i_dummy_dmemory.cnt_wr[7] + softex_tb.i_dummy_dmemory.cnt_wr[8];
+        cnt_rd = 0;
+        cnt_wr = 0;
+
+        for (int i = 0; i <= MP + MP_ST; i++) begin
+            cnt_rd += softex_tb.i_dummy_dmemory.cnt_rd[i];
+            cnt_wr += softex_tb.i_dummy_dmemory.cnt_wr[i];
+        end
         
         $display("[TB] - cnt_rd=%-8d", cnt_rd);
         $display("[TB] - cnt_wr=%-8d", cnt_wr);
 
-        f_golden = $fopen("golden-model/golden.txt", "r");
-
         errors = 0;
         tot_err_ulp = 0;
 
         pos = 0;
 
-        while ($fscanf(f_golden, "%d", n) == 1) begin
-            data = ((softex_tb.i_dummy_dmemory.memory[pos >> $clog2(4/OUTPUT_SIZE)] >> (8 * OUTPUT_SIZE * pos[$clog2(4/OUTPUT_SIZE)-1:0])) & (2**(8*OUTPUT_SIZE)-1)/*'h000000FF*/);
+        if (golden_bin != "") begin
+            f_golden = $fopen(golden_bin, "rb");
+
+            if (f_golden == 0)
+                $fatal(1, "[TB] - Cannot open %s", golden_bin);
+
+            void'($fread(bin_header, f_golden));
+
+            golden_words = new [(bin_header[1] + 3) >> 2];
+
+            void'($fread(golden_words, f_golden));
+
+            $fclose(f_golden);
+
+            // The outputs start at the load address of the image, which is word aligned
+            base = (bin_header[0] - 32'h1c010000) >> 2;
+
+            for (pos = 0; pos < bin_header[1] / output_size; pos++) begin
+                n    = ((golden_words[pos / (4 / output_size)] >> (8 * output_size * (pos % (4 / output_size)))) & ((64'd1 << (8 * output_size)) - 1));
+                data = ((softex_tb.i_dummy_dmemory.memory[base + pos / (4 / output_size)] >> (8 * output_size * (pos % (4 / output_size)))) & ((64'd1 << (8 * output_size)) - 1));
+
+                difference = n > data ? n - data : data - n;
+
+                tot_err_ulp += difference;
 
-            difference = n > data ? n - data : data - n;
+                if (difference > error_threshold) begin
+                    errors += 1;
 
-            tot_err_ulp += difference;
+                    $error("[TB] - Mismatch!    Expected: 0x%h\tWas: 0x%h\tPosition: %d\tDifference: %d", n, data, pos, difference);
+                end
+            end
+        end else begin
+            f_golden = $fopen(golden, "r");
+
+            while ($fscanf(f_golden, "%d", n) == 1) begin
+                data = ((softex_tb.i_dummy_dmemory.memory[pos / (4 / output_size)] >> (8 * output_size * (pos % (4 / output_size)))) & ((64'd1 << (8 * output_size)) - 1));
+
+                difference = n > data ? n - data : data - n;
+
+                tot_err_ulp += difference;
+
+                if (difference > error_threshold) begin
+                    errors += 1;
 
-            if (difference > error_threshold) begin
-                errors += 1;
+                    $error("[TB] - Mismatch!    Expected: 0x%h\tWas: 0x%h\tPosition: %d\tDifference: %d", n, data, pos, difference);
+                end
 
-                $error("[TB] - Mismatch!    Expected: 0x%h\tWas: 0x%h\tPosition: %d\tDifference: %d", n, data, pos, difference);
+                pos += 1;
             end
+        end
+
+        // Results the scoreboard expected but SoftEx never wrote
+        if (scoreboard)
+            errors += sb_final();
+
+        if (sw_errors != 0) begin
+            errors += sw_errors;
 
-            pos += 1;
+            $error("[TB] - The firmware reported %0d errors", sw_errors);
         end
 
         $display("[TB] - Errors: %d", errors);
 
         $display("[TB] - Average Absolute Error in ULPs: %f", real'(tot_err_ulp) / real'(pos));
 
+        // Output elements over the cycles in which the accelerator was busy
+        elem_per_cycle = busy_cycles == 0 ? 0.0 : real'(pos) / real'(busy_cycles);
+
+        $display("[TB] - Busy cycles: %-8d", busy_cycles);
+        $display("[TB] - Run cycles: %-8d", run_cycles);
+        $display("[TB] - Throughput: %f elements/cycle (BANDWIDTH=%0d)", elem_per_cycle, BANDWIDTH);
+
         $finish;
     end
 
@@ -60,6 +60,12 @@ module tb_dummy_memory
   logic [MP-1:0]       tcdm_r_valid_int;
 
   real probs [MP-1:0];
+  real prob_stall;
+
+  initial begin
+    prob_stall = PROB_STALL;
+    void'($value$plusargs("PROB_STALL=%f", prob_stall));
+  end
 
   logic clk_delayed;
 
@@ -75,7 +81,7 @@ module tb_dummy_memory
 
     for(genvar i=0; i<MP; i++) begin
       
-      assign tcdm_gnt[i] = (probs[i] < PROB_STALL) & stallable_i ? 1'b0 : 1'b1;
+      assign tcdm_gnt[i] = (probs[i] < prob_stall) & stallable_i ? 1'b0 : 1'b1;
     end
 
     for(genvar ii=0; ii<MP; ii++) begin : binding_gen